@@ -6,6 +6,8 @@ LICENSE file in the root directory of this source tree.
 #ifndef __ASTRA_NETWORK_API_HH__
 #define __ASTRA_NETWORK_API_HH__
 
+#include <vector>
+
 #include "astra-sim/system/Common.hh"
 
 namespace AstraSim {
@@ -35,6 +37,39 @@ class AstraNetworkAPI {
                          void (*msg_handler)(void* fun_arg),
                          void* fun_arg) = 0;
 
+    // One message of a sim_send_batch() or sim_recv_batch() call. peer is the
+    // destination of a send and the source of a receive.
+    struct BatchMessage {
+        void* buffer;
+        uint64_t count;
+        int type;
+        int peer;
+        int tag;
+        sim_request request;
+        void (*msg_handler)(void* fun_arg);
+        void* fun_arg;
+    };
+
+    // Issue a fan-out of messages at once, in order. Equivalent to one
+    // sim_send() (resp. sim_recv()) per message; backends may override these
+    // to share the per-call work across the whole batch.
+    virtual int sim_send_batch(std::vector<BatchMessage>& messages) {
+        for (auto& message : messages) {
+            sim_send(message.buffer, message.count, message.type, message.peer,
+                     message.tag, &message.request, message.msg_handler,
+                     message.fun_arg);
+        }
+        return 0;
+    }
+    virtual int sim_recv_batch(std::vector<BatchMessage>& messages) {
+        for (auto& message : messages) {
+            sim_recv(message.buffer, message.count, message.type, message.peer,
+                     message.tag, &message.request, message.msg_handler,
+                     message.fun_arg);
+        }
+        return 0;
+    }
+
     /*
      * sim_schedule is used when ASTRA-sim wants to schedule an event on the
      * network backend. delta: The relative time difference between the current
@@ -61,10 +96,24 @@ class AstraNetworkAPI {
 
     virtual timespec_t sim_get_time() = 0;
 
+    // Integer view of sim_get_time() in ASTRA-sim ticks. Backends keeping an
+    // integer clock should override this to skip the long double round-trip.
+    virtual Tick sim_get_tick() {
+        timespec_t time = sim_get_time();
+        return time.time_val / CLOCK_PERIOD;
+    };
+
     virtual double get_BW_at_dimension(int dim) {
         return -1;
     };
 
+    // Delay in ns of a message of `count` bytes from src to dst on an idle
+    // network, or a negative value if the backend can not tell. Backends
+    // without contention implement this to enable closed-form collectives.
+    virtual double get_send_delay(int src, int dst, uint64_t count) {
+        return -1;
+    };
+
     // Notifies that the workload for this rank has finished. 
     // Note that we have one network handler per rank. 
     // Therefore, when implementing this function, the network handler must 
@@ -51,6 +51,8 @@ enum class ComType {
 
 enum class CollectiveOptimization { Baseline = 0, LocalBWAware };
 
+enum class CollectiveEngine { MessageLevel = 0, ClosedForm, Validate };
+
 enum class CollectiveImplType {
     Ring = 0,
     OneRing,
@@ -1,5 +1,6 @@
 #include "astra-sim/common/Logging.hh"
 #include <filesystem>
+#include <mutex>
 
 namespace AstraSim {
 
@@ -8,6 +9,10 @@ std::unordered_set<spdlog::sink_ptr> LoggerFactory::default_sinks;
 std::shared_ptr<spdlog::logger> LoggerFactory::get_logger(
     const std::string& logger_name) {
     constexpr bool ENABLE_DEFAULT_SINK_FOR_OTHER_LOGGERS = true;
+    // loggers are created and get their sinks attached lazily, possibly by
+    // ranks running on different threads
+    static std::mutex get_logger_mutex;
+    std::lock_guard<std::mutex> lock(get_logger_mutex);
     auto logger = spdlog::get(logger_name);
     if (logger == nullptr) {
         logger = spdlog::create_async<spdlog::sinks::null_sink_mt>(logger_name);
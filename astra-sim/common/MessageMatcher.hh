@@ -0,0 +1,354 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#ifndef __COMMON_MESSAGE_MATCHER_HH__
+#define __COMMON_MESSAGE_MATCHER_HH__
+
+#include <cassert>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "astra-sim/common/ObjectPool.hh"
+
+namespace AstraSim {
+
+// Identifies a message (or a stream of messages) between two ranks by
+// (tag, src, dst, size, id). The four int fields are packed into 128 bits.
+// Frontends matching by byte count leave size at 0; id tells apart flows or
+// chunks sharing the same (tag, src, dst).
+struct MessageKey {
+    // (tag, id) packed into 64 bits
+    uint64_t tag_and_id;
+    // (src, dst) packed into 64 bits
+    uint64_t src_and_dst;
+    uint64_t size;
+
+    MessageKey(const int tag,
+               const int src,
+               const int dst,
+               const uint64_t size = 0,
+               const int id = 0) noexcept
+        : tag_and_id(pack(tag, id)),
+          src_and_dst(pack(src, dst)),
+          size(size) {}
+
+    bool operator==(const MessageKey& other) const noexcept {
+        return tag_and_id == other.tag_and_id &&
+               src_and_dst == other.src_and_dst && size == other.size;
+    }
+
+    uint64_t hash() const noexcept {
+        // splitmix64 finalizer over the combined words
+        auto x = tag_and_id ^ (src_and_dst * 0x9e3779b97f4a7c15ULL) ^
+                 (size * 0xc2b2ae3d27d4eb4fULL);
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+  private:
+    static uint64_t pack(const int high, const int low) noexcept {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(high)) << 32) |
+               static_cast<uint64_t>(static_cast<uint32_t>(low));
+    }
+};
+
+// Counters of a MessageTable, reported at the end of the simulation.
+struct MessageTableStats {
+    // number of live entries
+    uint64_t size = 0;
+    // largest number of live entries seen
+    uint64_t peak_size = 0;
+    // number of slots
+    uint64_t capacity = 0;
+    // number of find() calls
+    uint64_t lookups = 0;
+    // number of find() calls that found an entry
+    uint64_t hits = 0;
+
+    MessageTableStats& operator+=(const MessageTableStats& other) noexcept {
+        size += other.size;
+        peak_size += other.peak_size;
+        capacity += other.capacity;
+        lookups += other.lookups;
+        hits += other.hits;
+        return *this;
+    }
+};
+
+// Open-addressing (linear probing) hash table from MessageKey to Value.
+// Erased entries are removed by backward shifting, so the table never
+// accumulates tombstones. Value must be default-constructible.
+//
+// Pointers returned by find() and insert() are invalidated by the next
+// insert() or erase() on the same table.
+template <typename Value>
+class MessageTable {
+  public:
+    MessageTable() : slots(initial_capacity) {
+        stats.capacity = initial_capacity;
+    }
+
+    // Returns the value of the given key, nullptr if there is none.
+    Value* find(const MessageKey& key) noexcept {
+        stats.lookups++;
+        const auto index = find_index(key);
+        if (index == not_found) {
+            return nullptr;
+        }
+        stats.hits++;
+        return &slots[index].value;
+    }
+
+    // Inserts a default-constructed value for a key that is not in the table.
+    Value* insert(const MessageKey& key) {
+        assert(find_index(key) == not_found);
+
+        // keep the load factor at most 1/2
+        if (2 * (stats.size + 1) > slots.size()) {
+            grow();
+        }
+
+        auto& slot = slots[probe_empty(key)];
+        slot.occupied = true;
+        slot.key = key;
+        slot.value = Value();
+
+        stats.size++;
+        if (stats.size > stats.peak_size) {
+            stats.peak_size = stats.size;
+        }
+        return &slot.value;
+    }
+
+    // Removes a key that is in the table.
+    void erase(const MessageKey& key) noexcept {
+        auto hole = find_index(key);
+        assert(hole != not_found);
+
+        const auto mask = slots.size() - 1;
+        slots[hole].occupied = false;
+        stats.size--;
+
+        // shift back entries whose probe sequence passes the hole
+        for (auto i = (hole + 1) & mask; slots[i].occupied;
+             i = (i + 1) & mask) {
+            const auto home = slots[i].key.hash() & mask;
+            const auto distance = (i - home) & mask;
+            const auto hole_distance = (i - hole) & mask;
+            if (distance >= hole_distance) {
+                slots[hole] = std::move(slots[i]);
+                slots[i].occupied = false;
+                hole = i;
+            }
+        }
+    }
+
+    // Calls fn(key, value) on every entry. fn must not insert or erase.
+    template <typename Fn>
+    void for_each(Fn&& fn) {
+        for (auto& slot : slots) {
+            if (slot.occupied) {
+                fn(slot.key, slot.value);
+            }
+        }
+    }
+
+    bool empty() const noexcept {
+        return stats.size == 0;
+    }
+
+    const MessageTableStats& get_stats() const noexcept {
+        return stats;
+    }
+
+  private:
+    // must be a power of two
+    static constexpr uint64_t initial_capacity = 64;
+    static constexpr uint64_t not_found = ~uint64_t(0);
+
+    struct Slot {
+        bool occupied = false;
+        MessageKey key = MessageKey(0, 0, 0);
+        Value value = Value();
+    };
+
+    uint64_t find_index(const MessageKey& key) const noexcept {
+        const auto mask = slots.size() - 1;
+        for (auto i = key.hash() & mask; slots[i].occupied;
+             i = (i + 1) & mask) {
+            if (slots[i].key == key) {
+                return i;
+            }
+        }
+        return not_found;
+    }
+
+    uint64_t probe_empty(const MessageKey& key) const noexcept {
+        const auto mask = slots.size() - 1;
+        auto i = key.hash() & mask;
+        while (slots[i].occupied) {
+            i = (i + 1) & mask;
+        }
+        return i;
+    }
+
+    void grow() {
+        auto old_slots = std::vector<Slot>(2 * slots.size());
+        std::swap(slots, old_slots);
+        stats.capacity = slots.size();
+
+        for (auto& old_slot : old_slots) {
+            if (old_slot.occupied) {
+                slots[probe_empty(old_slot.key)] = std::move(old_slot);
+            }
+        }
+    }
+
+    // the size is always a power of two
+    std::vector<Slot> slots;
+    MessageTableStats stats;
+};
+
+// Receive-side rendezvous of a frontend that reports arrivals as byte counts.
+// Bytes of a (tag, src, dst) key may arrive before or after the matching
+// sim_recv calls, and neither side has to line up with the other: one arrival
+// may complete several receives and one receive may need several arrivals.
+//
+// Receives of the same key complete in the order they were posted. Bytes that
+// arrive while no receive is pending are kept until the next post_recv(). A
+// key has either pending receives or kept bytes, never both, and is removed
+// once it has neither.
+class MessageMatcher {
+  public:
+    using Handler = void (*)(void*);
+
+    MessageMatcher() = default;
+    MessageMatcher(const MessageMatcher&) = delete;
+    MessageMatcher& operator=(const MessageMatcher&) = delete;
+
+    ~MessageMatcher() {
+        entries.for_each([](const MessageKey&, Entry& entry) {
+            while (entry.head != nullptr) {
+                auto next = entry.head->next;
+                ObjectPool<PendingRecv>::destroy(entry.head);
+                entry.head = next;
+            }
+        });
+    }
+
+    // Waits for bytes of the given key. The handler is called right away if
+    // enough bytes already arrived, otherwise from the deliver() call that
+    // completes the receive.
+    void post_recv(const MessageKey& key,
+                   const uint64_t bytes,
+                   const Handler handler,
+                   void* const arg) {
+        auto entry = entries.find(key);
+        if (entry == nullptr) {
+            entry = entries.insert(key);
+        }
+
+        if (entry->head == nullptr && entry->standby_bytes >= bytes) {
+            entry->standby_bytes -= bytes;
+            if (entry->standby_bytes == 0) {
+                entries.erase(key);
+            }
+            handler(arg);
+            return;
+        }
+
+        // bytes that already arrived count toward this receive
+        assert(entry->head == nullptr || entry->standby_bytes == 0);
+        auto recv = ObjectPool<PendingRecv>::create();
+        recv->remaining_bytes = bytes - entry->standby_bytes;
+        recv->handler = handler;
+        recv->arg = arg;
+        recv->next = nullptr;
+        entry->standby_bytes = 0;
+        if (entry->tail == nullptr) {
+            entry->head = recv;
+        } else {
+            entry->tail->next = recv;
+        }
+        entry->tail = recv;
+    }
+
+    // Records that bytes of the given key arrived and calls the handlers of
+    // the receives they complete. Handlers may post new receives.
+    void deliver(const MessageKey& key, uint64_t bytes) {
+        while (true) {
+            // looked up again after each handler, which may post receives
+            auto entry = entries.find(key);
+            if (entry == nullptr) {
+                if (bytes > 0) {
+                    entries.insert(key)->standby_bytes = bytes;
+                }
+                return;
+            }
+
+            auto recv = entry->head;
+            if (recv == nullptr) {
+                entry->standby_bytes += bytes;
+                return;
+            }
+            if (bytes < recv->remaining_bytes) {
+                recv->remaining_bytes -= bytes;
+                return;
+            }
+
+            bytes -= recv->remaining_bytes;
+            entry->head = recv->next;
+            if (entry->head == nullptr) {
+                entry->tail = nullptr;
+                if (bytes == 0) {
+                    entries.erase(key);
+                }
+            }
+
+            const auto handler = recv->handler;
+            const auto arg = recv->arg;
+            ObjectPool<PendingRecv>::destroy(recv);
+            handler(arg);
+
+            if (bytes == 0) {
+                return;
+            }
+        }
+    }
+
+    bool empty() const noexcept {
+        return entries.empty();
+    }
+
+    const MessageTableStats& get_stats() const noexcept {
+        return entries.get_stats();
+    }
+
+  private:
+    // a sim_recv still waiting for bytes, pooled since receives are created
+    // and completed at message rate
+    struct PendingRecv {
+        uint64_t remaining_bytes;
+        Handler handler;
+        void* arg;
+        PendingRecv* next;
+    };
+
+    struct Entry {
+        // bytes that arrived before any receive was posted
+        uint64_t standby_bytes = 0;
+        // pending receives in posting order
+        PendingRecv* head = nullptr;
+        PendingRecv* tail = nullptr;
+    };
+
+    MessageTable<Entry> entries;
+};
+
+}  // namespace AstraSim
+
+#endif /* __COMMON_MESSAGE_MATCHER_HH__ */
@@ -0,0 +1,73 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "astra-sim/common/ObjectPool.hh"
+
+#include <cxxabi.h>
+#include <cstdlib>
+
+#include "astra-sim/common/Logging.hh"
+
+using namespace std;
+using namespace AstraSim;
+
+ObjectPoolStats::ObjectPoolStats(const char* type_name,
+                                 size_t slab_bytes,
+                                 size_t slab_alignment) {
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(type_name, nullptr, nullptr, &status);
+    if (status == 0 && demangled != nullptr) {
+        this->type_name = demangled;
+    } else {
+        this->type_name = type_name;
+    }
+    free(demangled);
+    this->slab_bytes = slab_bytes;
+    this->slab_alignment = slab_alignment;
+    ObjectPoolRegistry::register_pool(this);
+}
+
+void* ObjectPoolStats::allocate_slab() {
+    void* slab = ::operator new(slab_bytes, align_val_t(slab_alignment));
+    lock_guard<mutex> lock(slabs_mutex);
+    slabs.push_back(slab);
+    return slab;
+}
+
+size_t ObjectPoolStats::slabs_count() {
+    lock_guard<mutex> lock(slabs_mutex);
+    return slabs.size();
+}
+
+// the registry is leaked like the pools, which may register during static
+// destruction
+mutex& ObjectPoolRegistry::registry_mutex() {
+    static mutex* const registry_mutex = new mutex();
+    return *registry_mutex;
+}
+
+vector<ObjectPoolStats*>& ObjectPoolRegistry::pools() {
+    static vector<ObjectPoolStats*>* const pools =
+        new vector<ObjectPoolStats*>();
+    return *pools;
+}
+
+void ObjectPoolRegistry::register_pool(ObjectPoolStats* stats) {
+    lock_guard<mutex> lock(registry_mutex());
+    pools().push_back(stats);
+}
+
+void ObjectPoolRegistry::report() {
+    auto logger = LoggerFactory::get_logger("system");
+    lock_guard<mutex> lock(registry_mutex());
+    for (auto stats : pools()) {
+        size_t slabs_count = stats->slabs_count();
+        logger->info("object pool {}: {} allocations, {} slabs ({} bytes), "
+                     "{} fallback allocations",
+                     stats->type_name, stats->allocations.load(), slabs_count,
+                     slabs_count * stats->slab_bytes,
+                     stats->fallback_allocations.load());
+    }
+}
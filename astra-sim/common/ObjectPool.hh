@@ -0,0 +1,146 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#ifndef __COMMON_OBJECT_POOL_HH__
+#define __COMMON_OBJECT_POOL_HH__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <string>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+namespace AstraSim {
+
+// Counters and backing slabs of one pooled type, shared by all threads.
+// Never destroyed: pooled objects owned by static objects may still be freed
+// during static destruction, so their slabs are left to the system at exit.
+class ObjectPoolStats {
+  public:
+    ObjectPoolStats(const char* type_name,
+                    size_t slab_bytes,
+                    size_t slab_alignment);
+
+    void* allocate_slab();
+    size_t slabs_count();
+
+    std::string type_name;
+    size_t slab_bytes;
+    size_t slab_alignment;
+    // objects handed out by the pool
+    std::atomic<uint64_t> allocations{0};
+    // requests of a different size (derived classes without their own pool)
+    // forwarded to the global allocator
+    std::atomic<uint64_t> fallback_allocations{0};
+
+  private:
+    std::mutex slabs_mutex;
+    std::vector<void*> slabs;
+};
+
+class ObjectPoolRegistry {
+  public:
+    static void register_pool(ObjectPoolStats* stats);
+    static void report();
+
+  private:
+    static std::mutex& registry_mutex();
+    static std::vector<ObjectPoolStats*>& pools();
+};
+
+// Per-thread free-list allocator for objects of type T. Memory is carved out
+// of slabs holding objects_per_slab objects each; freed objects go back to
+// the free list of the thread that frees them. Slabs are never returned to
+// the system, so an object may be freed by a different thread than the one
+// that allocated it, or after main() returns.
+//
+// Hot classes route their class-level operator new/delete here; other types
+// (e.g. callback argument tuples) use create()/destroy().
+template <typename T>
+class ObjectPool {
+  public:
+    static constexpr size_t objects_per_slab = 256;
+
+    static void* allocate(size_t size) {
+        ObjectPoolStats& pool_stats = stats();
+        if (size != sizeof(T)) {
+            pool_stats.fallback_allocations.fetch_add(
+                1, std::memory_order_relaxed);
+            return ::operator new(size);
+        }
+        pool_stats.allocations.fetch_add(1, std::memory_order_relaxed);
+        if (free_list == nullptr) {
+            refill(pool_stats);
+        }
+        FreeNode* node = free_list;
+        free_list = node->next;
+        return node;
+    }
+
+    static void deallocate(void* ptr, size_t size) {
+        if (ptr == nullptr) {
+            return;
+        }
+        if (size != sizeof(T)) {
+            ::operator delete(ptr);
+            return;
+        }
+        FreeNode* node = static_cast<FreeNode*>(ptr);
+        node->next = free_list;
+        free_list = node;
+    }
+
+    template <typename... Args>
+    static T* create(Args&&... args) {
+        return new (allocate(sizeof(T))) T(std::forward<Args>(args)...);
+    }
+
+    static void destroy(T* ptr) {
+        if (ptr == nullptr) {
+            return;
+        }
+        ptr->~T();
+        deallocate(ptr, sizeof(T));
+    }
+
+  private:
+    struct FreeNode {
+        FreeNode* next;
+    };
+
+    static constexpr size_t slot_alignment =
+        alignof(T) > alignof(FreeNode) ? alignof(T) : alignof(FreeNode);
+    static constexpr size_t slot_size =
+        ((sizeof(T) > sizeof(FreeNode) ? sizeof(T) : sizeof(FreeNode)) +
+         slot_alignment - 1) /
+        slot_alignment * slot_alignment;
+
+    static ObjectPoolStats& stats() {
+        // leaked on purpose, see ObjectPoolStats
+        static ObjectPoolStats* const pool_stats = new ObjectPoolStats(
+            typeid(T).name(), slot_size * objects_per_slab, slot_alignment);
+        return *pool_stats;
+    }
+
+    static void refill(ObjectPoolStats& pool_stats) {
+        char* slab = static_cast<char*>(pool_stats.allocate_slab());
+        for (size_t i = objects_per_slab; i > 0; i--) {
+            FreeNode* node =
+                reinterpret_cast<FreeNode*>(slab + (i - 1) * slot_size);
+            node->next = free_list;
+            free_list = node;
+        }
+    }
+
+    inline static thread_local FreeNode* free_list = nullptr;
+};
+
+}  // namespace AstraSim
+
+#endif /* __COMMON_OBJECT_POOL_HH__ */
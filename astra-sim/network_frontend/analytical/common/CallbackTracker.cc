@@ -8,10 +8,7 @@ LICENSE file in the root directory of this source tree.
 
 using namespace AstraSimAnalytical;
 
-CallbackTracker::CallbackTracker() noexcept {
-    // initialize tracker
-    tracker = {};
-}
+CallbackTracker::CallbackTracker() noexcept : tracker() {}
 
 std::optional<CallbackTrackerEntry*> CallbackTracker::search_entry(
     const int tag,
@@ -26,16 +23,16 @@ std::optional<CallbackTrackerEntry*> CallbackTracker::search_entry(
     assert(chunk_id >= 0);
 
     // create key and search entry
-    const auto key = std::make_tuple(tag, src, dest, chunk_size, chunk_id);
-    const auto entry = tracker.find(key);
+    const auto key = ChunkKey(tag, src, dest, chunk_size, chunk_id);
+    auto* const entry = tracker.find(key);
 
     // no entry exists
-    if (entry == tracker.end()) {
+    if (entry == nullptr) {
         return std::nullopt;
     }
 
     // return pointer to entry
-    return &(entry->second);
+    return entry;
 }
 
 CallbackTrackerEntry* CallbackTracker::create_new_entry(
@@ -51,13 +48,10 @@ CallbackTrackerEntry* CallbackTracker::create_new_entry(
     assert(chunk_id >= 0);
 
     // create key
-    const auto key = std::make_tuple(tag, src, dest, chunk_size, chunk_id);
-
-    // create new emtpy entry
-    const auto entry = tracker.emplace(key, CallbackTrackerEntry()).first;
+    const auto key = ChunkKey(tag, src, dest, chunk_size, chunk_id);
 
-    // return pointer to entry
-    return &(entry->second);
+    // create new emtpy entry and return pointer to it
+    return tracker.insert(key);
 }
 
 void CallbackTracker::pop_entry(const int tag,
@@ -72,12 +66,16 @@ void CallbackTracker::pop_entry(const int tag,
     assert(chunk_id >= 0);
 
     // create key
-    const auto key = std::make_tuple(tag, src, dest, chunk_size, chunk_id);
+    const auto key = ChunkKey(tag, src, dest, chunk_size, chunk_id);
 
-    // find entry
-    const auto entry = tracker.find(key);
-    assert(entry != tracker.end());  // entry must exist
+    // erase entry from the tracker; entry must exist
+    tracker.erase(key);
+}
+
+bool CallbackTracker::empty() const noexcept {
+    return tracker.empty();
+}
 
-    // erase entry from the tracker
-    tracker.erase(entry);
+const ChunkHashTableStats& CallbackTracker::get_stats() const noexcept {
+    return tracker.get_stats();
 }
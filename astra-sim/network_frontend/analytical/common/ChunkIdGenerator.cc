@@ -8,9 +8,7 @@ LICENSE file in the root directory of this source tree.
 
 using namespace AstraSimAnalytical;
 
-ChunkIdGenerator::ChunkIdGenerator() noexcept {
-    chunk_id_map = {};
-}
+ChunkIdGenerator::ChunkIdGenerator() noexcept : chunk_id_map() {}
 
 int ChunkIdGenerator::create_send_chunk_id(
     const int tag,
@@ -23,19 +21,19 @@ int ChunkIdGenerator::create_send_chunk_id(
     assert(chunk_size > 0);
 
     // create key
-    const auto key = std::make_tuple(tag, src, dest, chunk_size);
+    const auto key = ChunkKey(tag, src, dest, chunk_size);
 
     // search whether the key exists
-    auto entry = chunk_id_map.find(key);
+    auto* entry = chunk_id_map.find(key);
 
     // if key doesn't exist, create new entry
-    if (entry == chunk_id_map.end()) {
-        entry = chunk_id_map.emplace(key, ChunkIdGeneratorEntry()).first;
+    if (entry == nullptr) {
+        entry = chunk_id_map.insert(key);
     }
 
     // increment id and return
-    entry->second.increment_send_id();
-    return entry->second.get_send_id();
+    entry->increment_send_id();
+    return entry->get_send_id();
 }
 
 int ChunkIdGenerator::create_recv_chunk_id(
@@ -49,17 +47,44 @@ int ChunkIdGenerator::create_recv_chunk_id(
     assert(chunk_size > 0);
 
     // create key
-    const auto key = std::make_tuple(tag, src, dest, chunk_size);
+    const auto key = ChunkKey(tag, src, dest, chunk_size);
 
     // search whether the key exists
-    auto entry = chunk_id_map.find(key);
+    auto* entry = chunk_id_map.find(key);
 
     // key doesn't exist, create new entry
-    if (entry == chunk_id_map.end()) {
-        entry = chunk_id_map.emplace(key, ChunkIdGeneratorEntry()).first;
+    if (entry == nullptr) {
+        entry = chunk_id_map.insert(key);
     }
 
     // if key exists, increment send id and return
-    entry->second.increment_recv_id();
-    return entry->second.get_recv_id();
+    entry->increment_recv_id();
+    return entry->get_recv_id();
+}
+
+void ChunkIdGenerator::complete_chunk(const int tag,
+                                      const int src,
+                                      const int dest,
+                                      const ChunkSize chunk_size) noexcept {
+    assert(tag >= 0);
+    assert(src >= 0);
+    assert(dest >= 0);
+    assert(chunk_size > 0);
+
+    // create key
+    const auto key = ChunkKey(tag, src, dest, chunk_size);
+
+    // the chunk got its ids from this entry
+    auto* const entry = chunk_id_map.find(key);
+    assert(entry != nullptr);
+    entry->increment_completed_count();
+
+    // no chunk of this tuple is pending: ids can safely restart from 0
+    if (entry->is_drained()) {
+        chunk_id_map.erase(key);
+    }
+}
+
+const ChunkHashTableStats& ChunkIdGenerator::get_stats() const noexcept {
+    return chunk_id_map.get_stats();
 }
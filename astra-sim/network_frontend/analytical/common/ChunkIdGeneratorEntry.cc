@@ -10,7 +10,8 @@ using namespace AstraSimAnalytical;
 
 ChunkIdGeneratorEntry::ChunkIdGeneratorEntry() noexcept
     : send_id(-1),
-      recv_id(-1) {}
+      recv_id(-1),
+      completed_count(0) {}
 
 int ChunkIdGeneratorEntry::get_send_id() const noexcept {
     assert(send_id >= 0);
@@ -31,3 +32,15 @@ void ChunkIdGeneratorEntry::increment_send_id() noexcept {
 void ChunkIdGeneratorEntry::increment_recv_id() noexcept {
     recv_id++;
 }
+
+void ChunkIdGeneratorEntry::increment_completed_count() noexcept {
+    completed_count++;
+
+    assert(completed_count <= send_id + 1);
+    assert(completed_count <= recv_id + 1);
+}
+
+bool ChunkIdGeneratorEntry::is_drained() const noexcept {
+    // ids start from 0, so (id + 1) ids have been handed out
+    return completed_count == send_id + 1 && completed_count == recv_id + 1;
+}
@@ -40,7 +40,30 @@ void CmdLineParser::define_options() noexcept {
         "injection-scale", "Injection scale",
         cxxopts::value<double>()->default_value("1"))(
         "rendezvous-protocol", "Whether to enable rendezvous protocol",
-        cxxopts::value<bool>()->default_value("false"));
+        cxxopts::value<bool>()->default_value("false"))(
+        "collapse-symmetric-ranks",
+        "Simulate one representative rank per set of ranks with identical "
+        "workloads (congestion_unaware only)",
+        cxxopts::value<bool>()->default_value("false"))(
+        "num-threads",
+        "Number of threads to run ranks on (congestion_unaware only)",
+        cxxopts::value<int>()->default_value("1"))(
+        "coalesce-arrivals",
+        "Deliver chunks arriving at the same time with a single event "
+        "(congestion_unaware and replay only)",
+        cxxopts::value<bool>()->default_value("false"))(
+        "checkpoint-interval",
+        "Save a checkpoint at the first quiescent point after every given "
+        "number of ns (0 to disable)",
+        cxxopts::value<uint64_t>()->default_value("0"))(
+        "checkpoint-path", "Checkpoint file to save to",
+        cxxopts::value<std::string>()->default_value("checkpoint.bin"))(
+        "restore-checkpoint", "Checkpoint file to resume from",
+        cxxopts::value<std::string>()->default_value("empty"))(
+        "workload-cache",
+        "Directory of compiled workloads to map instead of parsing the ETs "
+        "(empty to disable)",
+        cxxopts::value<std::string>()->default_value(""));
 }
 
 void CmdLineParser::parse(int argc, char* argv[]) noexcept {
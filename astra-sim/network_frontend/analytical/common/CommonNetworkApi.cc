@@ -4,6 +4,7 @@ LICENSE file in the root directory of this source tree.
 *******************************************************************************/
 
 #include "common/CommonNetworkApi.hh"
+#include "astra-sim/common/Logging.hh"
 #include <cassert>
 
 using namespace AstraSim;
@@ -20,6 +21,15 @@ int CommonNetworkApi::dims_count = -1;
 
 std::vector<Bandwidth> CommonNetworkApi::bandwidth_per_dim = {};
 
+bool CommonNetworkApi::coalesce_arrivals = false;
+
+std::unordered_map<EventTime, CommonNetworkApi::ArrivalBatch*>
+    CommonNetworkApi::arrival_batches = {};
+
+uint64_t CommonNetworkApi::arrivals_count = 0;
+
+uint64_t CommonNetworkApi::arrival_events_count = 0;
+
 void CommonNetworkApi::set_event_queue(
     std::shared_ptr<EventQueue> event_queue_ptr) noexcept {
     assert(event_queue_ptr != nullptr);
@@ -27,6 +37,10 @@ void CommonNetworkApi::set_event_queue(
     CommonNetworkApi::event_queue = std::move(event_queue_ptr);
 }
 
+void CommonNetworkApi::set_coalesce_arrivals(const bool coalesce) noexcept {
+    CommonNetworkApi::coalesce_arrivals = coalesce;
+}
+
 CallbackTracker& CommonNetworkApi::get_callback_tracker() noexcept {
     return callback_tracker;
 }
@@ -35,31 +49,82 @@ void CommonNetworkApi::process_chunk_arrival(void* args) noexcept {
     assert(args != nullptr);
 
     // parse chunk data
-    auto* const data =
-        static_cast<std::tuple<int, int, int, uint64_t, int>*>(args);
+    auto* const data = static_cast<ChunkArrivalArg*>(args);
     const auto [tag, src, dest, count, chunk_id] = *data;
-    delete data;
+    ObjectPool<ChunkArrivalArg>::destroy(data);
 
     // search tracker
     auto& tracker = CommonNetworkApi::get_callback_tracker();
     const auto entry = tracker.search_entry(tag, src, dest, count, chunk_id);
     assert(entry.has_value());  // entry must exist
 
-    // if both callbacks are registered, invoke both callbacks
-    if (entry.value()->both_callbacks_registered()) {
-        entry.value()->invoke_send_handler();
-        entry.value()->invoke_recv_handler();
+    // handlers may issue new sim_send() or sim_recv() calls that move tracker
+    // entries around, so only invoke them through a copy
+    auto callbacks = *entry.value();
 
-        // remove entry
+    // if both callbacks are registered, invoke both callbacks
+    if (callbacks.both_callbacks_registered()) {
+        // remove entry; the chunk is delivered to both sides
         tracker.pop_entry(tag, src, dest, count, chunk_id);
-    } else {
-        // run only send callback, as recv is not ready yet.
-        entry.value()->invoke_send_handler();
+        chunk_id_generator.complete_chunk(tag, src, dest, count);
 
+        callbacks.invoke_send_handler();
+        callbacks.invoke_recv_handler();
+    } else {
         // mark the transmission as finished
         // so that recv callback will be invoked immediately
         // when sim_recv() is called
         entry.value()->set_transmission_finished();
+
+        // run only send callback, as recv is not ready yet.
+        callbacks.invoke_send_handler();
+    }
+}
+
+void CommonNetworkApi::process_arrival_batch(void* const args) noexcept {
+    assert(args != nullptr);
+
+    // arrivals of this time scheduled from now on get a new event
+    auto* const batch = static_cast<ArrivalBatch*>(args);
+    arrival_batches.erase(batch->time);
+
+    for (auto* const chunk : batch->chunks) {
+        process_chunk_arrival(static_cast<void*>(chunk));
+    }
+    ObjectPool<ArrivalBatch>::destroy(batch);
+}
+
+void CommonNetworkApi::report_matching_stats() noexcept {
+    log_matching_stats(callback_tracker.get_stats(),
+                       chunk_id_generator.get_stats());
+}
+
+void CommonNetworkApi::log_matching_stats(
+    const ChunkHashTableStats& tracker_stats,
+    const ChunkHashTableStats& generator_stats) noexcept {
+    const auto hit_rate = [](const ChunkHashTableStats& stats) {
+        if (stats.lookups == 0) {
+            return 0.0;
+        }
+        return 100.0 * static_cast<double>(stats.hits) /
+               static_cast<double>(stats.lookups);
+    };
+
+    auto logger = LoggerFactory::get_logger("network");
+    logger->info("callback tracker: {} entries (peak {}, {} slots), "
+                 "{} lookups, {:.1f}% hit rate",
+                 tracker_stats.size, tracker_stats.peak_size,
+                 tracker_stats.capacity, tracker_stats.lookups,
+                 hit_rate(tracker_stats));
+    logger->info("chunk id generator: {} entries (peak {}, {} slots), "
+                 "{} lookups, {:.1f}% hit rate",
+                 generator_stats.size, generator_stats.peak_size,
+                 generator_stats.capacity, generator_stats.lookups,
+                 hit_rate(generator_stats));
+
+    if (coalesce_arrivals) {
+        logger->info("chunk arrivals: {} arrivals in {} events",
+                     arrivals_count, arrival_events_count);
     }
 }
 
@@ -77,6 +142,11 @@ timespec_t CommonNetworkApi::sim_get_time() {
     return {NS, astra_sim_time};
 }
 
+Tick CommonNetworkApi::sim_get_tick() {
+    // event queue keeps time in integer ns
+    return event_queue->get_current_time() / CLOCK_PERIOD;
+}
+
 void CommonNetworkApi::sim_schedule(const timespec_t delta,
                                     void (*fun_ptr)(void*),
                                     void* const fun_arg) {
@@ -101,8 +171,32 @@ int CommonNetworkApi::sim_recv(void* const buffer,
                                sim_request* const request,
                                void (*msg_handler)(void*),
                                void* const fun_arg) {
-    // query chunk id
     const auto dst = sim_comm_get_rank();
+    recv_chunk(src, dst, count, tag, msg_handler, fun_arg);
+
+    // return
+    return 0;
+}
+
+int CommonNetworkApi::sim_recv_batch(std::vector<BatchMessage>& messages) {
+    // every receive of the batch targets this rank
+    const auto dst = sim_comm_get_rank();
+    for (const auto& message : messages) {
+        recv_chunk(message.peer, dst, message.count, message.tag,
+                   message.msg_handler, message.fun_arg);
+    }
+
+    // return
+    return 0;
+}
+
+void CommonNetworkApi::recv_chunk(const int src,
+                                  const int dst,
+                                  const uint64_t count,
+                                  const int tag,
+                                  void (*msg_handler)(void*),
+                                  void* const fun_arg) noexcept {
+    // query chunk id
     const auto chunk_id =
         CommonNetworkApi::chunk_id_generator.create_recv_chunk_id(tag, src, dst,
                                                                   count);
@@ -118,6 +212,7 @@ int CommonNetworkApi::sim_recv(void* const buffer,
 
             // pop entry
             callback_tracker.pop_entry(tag, src, dst, count, chunk_id);
+            chunk_id_generator.complete_chunk(tag, src, dst, count);
 
             // run recv callback immediately
             const auto delta = timespec_t{NS, 0};
@@ -133,9 +228,76 @@ int CommonNetworkApi::sim_recv(void* const buffer,
             callback_tracker.create_new_entry(tag, src, dst, count, chunk_id);
         new_entry->register_recv_callback(msg_handler, fun_arg);
     }
+}
 
-    // return
-    return 0;
+void CommonNetworkApi::send_chunk_with_delay(
+    const int src,
+    const int dst,
+    const uint64_t count,
+    const int tag,
+    void (*msg_handler)(void*),
+    void* const fun_arg,
+    const EventTime send_delay_ns) noexcept {
+    // query chunk id
+    const auto chunk_id =
+        CommonNetworkApi::chunk_id_generator.create_send_chunk_id(tag, src, dst,
+                                                                  count);
+
+    // search tracker
+    const auto entry =
+        callback_tracker.search_entry(tag, src, dst, count, chunk_id);
+    if (entry.has_value()) {
+        // recv operation already issued.
+        // add send event handler to the tracker
+        entry.value()->register_send_callback(msg_handler, fun_arg);
+    } else {
+        // recv operation not issued yet
+        // create new entry and insert send callback
+        auto* const new_entry =
+            callback_tracker.create_new_entry(tag, src, dst, count, chunk_id);
+        new_entry->register_send_callback(msg_handler, fun_arg);
+    }
+
+    // create chunk
+    auto* const arg = ObjectPool<ChunkArrivalArg>::create(tag, src, dst,
+                                                          count, chunk_id);
+
+    // register chunk arrival event after send communication delay
+    schedule_chunk_arrival(send_delay_ns, arg);
+}
+
+void CommonNetworkApi::schedule_chunk_arrival(
+    const EventTime send_delay_ns,
+    ChunkArrivalArg* const arg) noexcept {
+    assert(arg != nullptr);
+
+    arrivals_count++;
+    if (!coalesce_arrivals) {
+        arrival_events_count++;
+        const auto send_delay = static_cast<double>(send_delay_ns);
+        const auto delta = timespec_t({NS, send_delay});
+        sim_schedule(delta, CommonNetworkApi::process_chunk_arrival,
+                     static_cast<void*>(arg));
+        return;
+    }
+
+    // join the batch of the arrival time, if any
+    const auto arrival_time = event_queue->get_current_time() + send_delay_ns;
+    const auto batch = arrival_batches.find(arrival_time);
+    if (batch != arrival_batches.end()) {
+        batch->second->chunks.push_back(arg);
+        return;
+    }
+
+    // first arrival of this time
+    arrival_events_count++;
+    auto* const new_batch = ObjectPool<ArrivalBatch>::create();
+    new_batch->time = arrival_time;
+    new_batch->chunks.push_back(arg);
+    arrival_batches.emplace(arrival_time, new_batch);
+    event_queue->schedule_event(arrival_time,
+                                CommonNetworkApi::process_arrival_batch,
+                                static_cast<void*>(new_batch));
 }
 
 double CommonNetworkApi::get_BW_at_dimension(const int dim) {
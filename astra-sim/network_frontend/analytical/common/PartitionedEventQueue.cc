@@ -0,0 +1,320 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/PartitionedEventQueue.hh"
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <thread>
+
+using namespace NetworkAnalytical;
+using namespace AstraSimAnalytical;
+
+thread_local int PartitionedEventQueue::current_partition = -1;
+
+thread_local uint64_t PartitionedEventQueue::current_index = 0;
+
+thread_local uint64_t PartitionedEventQueue::current_children = 0;
+
+PartitionedEventQueue::PartitionedEventQueue(const int partitions_count,
+                                             const EventTime lookahead) noexcept
+    : partitions_count(partitions_count),
+      lookahead(lookahead),
+      current_window(0),
+      window_end(0),
+      finished(false),
+      barrier_waiting(0),
+      barrier_generation(0) {
+    assert(partitions_count > 0);
+    assert(lookahead > 0);
+
+    partitions.resize(partitions_count);
+    for (auto& partition : partitions) {
+        partition.current_time = 0;
+        partition.outbox.resize(partitions_count);
+    }
+
+    // events scheduled before run() are children of a single setup event
+    window_positions[0] = {{0}};
+}
+
+int PartitionedEventQueue::get_partitions_count() const noexcept {
+    return partitions_count;
+}
+
+EventTime PartitionedEventQueue::get_lookahead() const noexcept {
+    return lookahead;
+}
+
+EventTime PartitionedEventQueue::get_current_time(
+    const int partition) const noexcept {
+    assert(0 <= partition && partition < partitions_count);
+
+    return partitions[partition].current_time;
+}
+
+void PartitionedEventQueue::schedule_event(
+    const int partition,
+    const EventTime event_time,
+    const Callback callback,
+    const CallbackArg callback_arg) noexcept {
+    const auto event = make_event(event_time, 0, callback, callback_arg);
+    insert_event(partition, event);
+}
+
+void PartitionedEventQueue::schedule_split_event(
+    const int first_partition,
+    const int second_partition,
+    const EventTime event_time,
+    const Callback first_callback,
+    const CallbackArg first_callback_arg,
+    const Callback second_callback,
+    const CallbackArg second_callback_arg) noexcept {
+    // both halves share the sibling index, the phase orders them
+    auto event = make_event(event_time, 0, first_callback, first_callback_arg);
+    insert_event(first_partition, event);
+
+    event.phase = 1;
+    event.callback = second_callback;
+    event.callback_arg = second_callback_arg;
+    insert_event(second_partition, event);
+}
+
+void PartitionedEventQueue::run(
+    const std::function<void(int)>& on_worker_start) noexcept {
+    // pick the first window
+    advance_window();
+
+    auto workers = std::vector<std::thread>();
+    for (auto i = 1; i < partitions_count; i++) {
+        workers.emplace_back(&PartitionedEventQueue::work, this, i,
+                             std::cref(on_worker_start));
+    }
+    work(0, on_worker_start);
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    // back to setup context, e.g., for events scheduled at teardown
+    current_partition = -1;
+}
+
+bool PartitionedEventQueue::runs_before(const OrderedEvent& a,
+                                        const OrderedEvent& b) const noexcept {
+    if (a.time != b.time) {
+        return a.time < b.time;
+    }
+
+    // events of earlier windows ran earlier
+    if (a.parent_window != b.parent_window) {
+        return a.parent_window < b.parent_window;
+    }
+    if (a.parent_partition != b.parent_partition) {
+        // parents ran on different partitions in the same window,
+        // which is already merged
+        const auto& positions = window_positions.at(a.parent_window);
+        return positions[a.parent_partition][a.parent_index] <
+               positions[b.parent_partition][b.parent_index];
+    }
+    if (a.parent_index != b.parent_index) {
+        return a.parent_index < b.parent_index;
+    }
+
+    // siblings run in scheduling order
+    if (a.child_index != b.child_index) {
+        return a.child_index < b.child_index;
+    }
+    return a.phase < b.phase;
+}
+
+PartitionedEventQueue::OrderedEvent PartitionedEventQueue::make_event(
+    const EventTime event_time,
+    const int phase,
+    const Callback callback,
+    const CallbackArg callback_arg) noexcept {
+    assert(callback != nullptr);
+
+    auto event = OrderedEvent();
+    event.time = event_time;
+    if (current_partition < 0) {
+        // setup
+        event.parent_window = 0;
+        event.parent_partition = 0;
+        event.parent_index = 0;
+    } else {
+        event.parent_window = current_window;
+        event.parent_partition = current_partition;
+        event.parent_index = current_index;
+    }
+    event.child_index = current_children++;
+    event.phase = phase;
+    event.callback = callback;
+    event.callback_arg = callback_arg;
+    return event;
+}
+
+void PartitionedEventQueue::insert_event(const int partition,
+                                         const OrderedEvent& event) noexcept {
+    assert(0 <= partition && partition < partitions_count);
+
+    if (current_partition < 0) {
+        // setup: nothing is running yet
+        push_event(partitions[partition], event);
+        return;
+    }
+
+    auto& current = partitions[current_partition];
+    assert(event.time >= current.current_time);
+    if (partition == current_partition) {
+        push_event(current, event);
+        return;
+    }
+
+    // the other partition may be running this window, deliver it later
+    assert(event.time >= window_end);
+    current.outbox[partition].push_back(event);
+}
+
+void PartitionedEventQueue::push_event(Partition& partition,
+                                       const OrderedEvent& event) noexcept {
+    partition.window_refs[event.parent_window]++;
+    partition.events.push_back(event);
+    std::push_heap(partition.events.begin(), partition.events.end(),
+                   [this](const OrderedEvent& a, const OrderedEvent& b) {
+                       return runs_before(b, a);
+                   });
+}
+
+void PartitionedEventQueue::run_window(const int partition_id) noexcept {
+    auto& partition = partitions[partition_id];
+    const auto later = [this](const OrderedEvent& a, const OrderedEvent& b) {
+        return runs_before(b, a);
+    };
+
+    while (!partition.events.empty() &&
+           partition.events.front().time < window_end) {
+        std::pop_heap(partition.events.begin(), partition.events.end(), later);
+        const auto event = partition.events.back();
+        partition.events.pop_back();
+
+        auto refs = partition.window_refs.find(event.parent_window);
+        assert(refs != partition.window_refs.end());
+        if (--refs->second == 0) {
+            partition.window_refs.erase(refs);
+        }
+
+        // run the event, recording it as the parent of what it schedules
+        partition.current_time = event.time;
+        current_index = partition.executed.size();
+        current_children = 0;
+        partition.executed.push_back(event);
+        event.callback(event.callback_arg);
+    }
+}
+
+void PartitionedEventQueue::deliver_events(const int partition_id) noexcept {
+    auto& partition = partitions[partition_id];
+    for (auto& source : partitions) {
+        auto& inbox = source.outbox[partition_id];
+        for (const auto& event : inbox) {
+            push_event(partition, event);
+        }
+        inbox.clear();
+    }
+}
+
+void PartitionedEventQueue::merge_executed() noexcept {
+    auto& positions = window_positions[current_window];
+    positions.assign(partitions_count, {});
+
+    // k-way merge of the execution logs. Events of a partition already ran
+    // in serial order; the parent of a head that ran in this window precedes
+    // it on the same partition, so its position is already assigned.
+    auto heads = std::vector<size_t>(partitions_count, 0);
+    auto position = uint64_t(0);
+    while (true) {
+        auto next = -1;
+        for (auto p = 0; p < partitions_count; p++) {
+            const auto& executed = partitions[p].executed;
+            if (heads[p] >= executed.size()) {
+                continue;
+            }
+            if (next < 0 ||
+                runs_before(executed[heads[p]],
+                            partitions[next].executed[heads[next]])) {
+                next = p;
+            }
+        }
+        if (next < 0) {
+            break;
+        }
+        positions[next].push_back(position++);
+        heads[next]++;
+    }
+
+    for (auto& partition : partitions) {
+        partition.executed.clear();
+    }
+}
+
+void PartitionedEventQueue::advance_window() noexcept {
+    auto next_time = std::numeric_limits<EventTime>::max();
+    auto oldest_window = current_window + 1;
+    for (const auto& partition : partitions) {
+        if (!partition.events.empty()) {
+            next_time = std::min(next_time, partition.events.front().time);
+        }
+        if (!partition.window_refs.empty()) {
+            oldest_window =
+                std::min(oldest_window, partition.window_refs.begin()->first);
+        }
+    }
+
+    // positions are only needed to order pending events
+    for (auto it = window_positions.begin(); it != window_positions.end();) {
+        if (it->first < oldest_window) {
+            it = window_positions.erase(it);
+        } else {
+            it++;
+        }
+    }
+
+    if (next_time == std::numeric_limits<EventTime>::max()) {
+        finished = true;
+        return;
+    }
+    current_window++;
+    window_end = next_time + lookahead;
+}
+
+void PartitionedEventQueue::barrier(
+    const std::function<void()>& on_complete) noexcept {
+    auto lock = std::unique_lock<std::mutex>(barrier_mutex);
+    const auto generation = barrier_generation;
+    if (++barrier_waiting == partitions_count) {
+        on_complete();
+        barrier_waiting = 0;
+        barrier_generation++;
+        barrier_cv.notify_all();
+        return;
+    }
+    barrier_cv.wait(lock,
+                    [&] { return barrier_generation != generation; });
+}
+
+void PartitionedEventQueue::work(
+    const int partition,
+    const std::function<void(int)>& on_worker_start) noexcept {
+    current_partition = partition;
+    on_worker_start(partition);
+
+    while (!finished) {
+        run_window(partition);
+        barrier([this] { merge_executed(); });
+        deliver_events(partition);
+        barrier([this] { advance_window(); });
+    }
+}
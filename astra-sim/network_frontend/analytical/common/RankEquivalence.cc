@@ -0,0 +1,203 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/RankEquivalence.hh"
+#include "astra-sim/common/Logging.hh"
+#include "astra-sim/workload/WorkloadLoader.hh"
+#include <cassert>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <json/json.hpp>
+#include <unordered_map>
+
+using namespace AstraSimAnalytical;
+using namespace NetworkAnalytical;
+
+namespace {
+
+[[noreturn]] void reject_collapse(const std::string& reason) noexcept {
+    std::cerr << "[Error] (AstraSim/analytical/common) " << reason
+              << ": rerun without --collapse-symmetric-ranks" << std::endl;
+    std::exit(-1);
+}
+
+}  // namespace
+
+void RankEquivalence::check_collapsible(
+    const std::string& system_configuration,
+    const NetworkParser& network_parser) noexcept {
+    // collectives must send to the same offsets from every rank
+    auto file = std::ifstream(system_configuration);
+    const auto system = nlohmann::json::parse(file, nullptr, false);
+    if (system.is_discarded()) {
+        reject_collapse("Unable to parse system configuration " +
+                        system_configuration);
+    }
+    for (const auto* const key :
+         {"all-reduce-implementation", "reduce-scatter-implementation",
+          "all-gather-implementation", "all-to-all-implementation"}) {
+        if (system.contains(std::string(key) + "-custom")) {
+            reject_collapse(std::string("Custom ") + key +
+                            " is not symmetric");
+        }
+        if (!system.contains(key)) {
+            continue;
+        }
+        for (const auto& implementation : system[key]) {
+            const auto name = implementation.get<std::string>();
+            if (name != "ring" && name.rfind("direct", 0) != 0) {
+                reject_collapse(std::string(key) + " " + name +
+                                " is not supported, only ring and direct "
+                                "collectives are mirrored");
+            }
+        }
+    }
+
+    // every NPU of a dimension must be in the same position
+    const auto dims_count = network_parser.get_dims_count();
+    const auto topologies = network_parser.get_topologies_per_dim();
+    const auto npus_counts = network_parser.get_npus_counts_per_dim();
+    const auto bandwidths = network_parser.get_bandwidths_per_dim();
+    const auto latencies = network_parser.get_latencies_per_dim();
+    if (topologies.size() != dims_count || npus_counts.size() != dims_count ||
+        bandwidths.size() != dims_count || latencies.size() != dims_count) {
+        reject_collapse("The network does not have a single NPU count, "
+                        "bandwidth and latency per dimension");
+    }
+    for (auto dim = 0; dim < dims_count; dim++) {
+        const auto topology = topologies[dim];
+        if (topology != TopologyBuildingBlock::Ring &&
+            topology != TopologyBuildingBlock::FullyConnected &&
+            topology != TopologyBuildingBlock::Switch) {
+            reject_collapse("Network dimension " + std::to_string(dim) +
+                            " is not a Ring, FullyConnected or Switch");
+        }
+        if (npus_counts[dim] <= 0 || bandwidths[dim] <= 0 ||
+            latencies[dim] < 0) {
+            reject_collapse("Network dimension " + std::to_string(dim) +
+                            " is not uniform");
+        }
+    }
+}
+
+RankEquivalence::RankEquivalence(const std::string& workload_configuration,
+                                 std::vector<int> npus_count_per_dim) noexcept
+    : npus_count_per_dim(std::move(npus_count_per_dim)) {
+    auto npus_count = 1;
+    for (const auto npus : this->npus_count_per_dim) {
+        assert(npus > 0);
+        npus_count *= npus;
+    }
+
+    // group ranks by the hash of their execution trace
+    const auto et_hashes =
+        AstraSim::WorkloadLoader::hash_files(workload_configuration,
+                                             npus_count);
+    auto class_of_hash = std::unordered_map<uint64_t, int>();
+    class_of_rank.resize(npus_count);
+    for (auto rank = 0; rank < npus_count; rank++) {
+        const auto et_hash = et_hashes[rank];
+
+        const auto it = class_of_hash.find(et_hash);
+        if (it == class_of_hash.end()) {
+            // first rank of a new class becomes its representative
+            const auto class_id = static_cast<int>(classes.size());
+            class_of_hash.emplace(et_hash, class_id);
+            classes.push_back({et_hash, rank, 1, 0, false});
+            representatives.push_back(rank);
+            class_of_rank[rank] = class_id;
+        } else {
+            classes[it->second].ranks_count++;
+            class_of_rank[rank] = it->second;
+        }
+    }
+}
+
+bool RankEquivalence::is_simulated(const int rank) const noexcept {
+    assert(0 <= rank && rank < class_of_rank.size());
+
+    return classes[class_of_rank[rank]].representative == rank;
+}
+
+int RankEquivalence::get_class_id(const int rank) const noexcept {
+    assert(0 <= rank && rank < class_of_rank.size());
+
+    return class_of_rank[rank];
+}
+
+const std::vector<int>& RankEquivalence::get_representatives() const noexcept {
+    return representatives;
+}
+
+int RankEquivalence::get_mirror_peer(const int src,
+                                     const int dst) const noexcept {
+    assert(0 <= src && src < class_of_rank.size());
+    assert(0 <= dst && dst < class_of_rank.size());
+
+    // reflect dst around src in every dimension
+    auto peer = 0;
+    auto stride = 1;
+    auto src_rest = src;
+    auto dst_rest = dst;
+    for (const auto npus : npus_count_per_dim) {
+        const auto src_coord = src_rest % npus;
+        const auto dst_coord = dst_rest % npus;
+        const auto peer_coord =
+            ((2 * src_coord - dst_coord) % npus + npus) % npus;
+        peer += peer_coord * stride;
+
+        src_rest /= npus;
+        dst_rest /= npus;
+        stride *= npus;
+    }
+
+    // the peers of a representative must be its own replicas
+    const auto class_id = class_of_rank[src];
+    if (class_of_rank[dst] != class_id || class_of_rank[peer] != class_id) {
+        std::cerr << "[Error] (AstraSim/analytical/common) "
+                  << "Rank " << src << " communicates with rank " << dst
+                  << " (mirrored peer " << peer
+                  << ") of a different equivalence class: "
+                  << "the workload is not symmetric, "
+                  << "rerun without --collapse-symmetric-ranks" << std::endl;
+        std::exit(-1);
+    }
+
+    return peer;
+}
+
+void RankEquivalence::set_finish_time(const int rank,
+                                      const uint64_t finish_time) noexcept {
+    assert(is_simulated(rank));
+
+    auto& rank_class = classes[class_of_rank[rank]];
+    rank_class.finish_time = finish_time;
+    rank_class.finished = true;
+}
+
+bool RankEquivalence::report() const noexcept {
+    const auto logger = AstraSim::LoggerFactory::get_logger("network");
+    auto all_finished = true;
+
+    logger->info("collapsed {} ranks into {} equivalence classes",
+                 class_of_rank.size(), classes.size());
+    for (auto class_id = 0; class_id < classes.size(); class_id++) {
+        const auto& rank_class = classes[class_id];
+        if (!rank_class.finished) {
+            logger->critical(
+                "class {}: representative sys[{}] of {} ranks did not finish",
+                class_id, rank_class.representative, rank_class.ranks_count);
+            all_finished = false;
+            continue;
+        }
+        logger->info("class {}: {} ranks (ET hash {:016x}) represented by "
+                     "sys[{}], finished at {} ns",
+                     class_id, rank_class.ranks_count, rank_class.et_hash,
+                     rank_class.representative, rank_class.finish_time);
+    }
+
+    return all_finished;
+}
@@ -0,0 +1,46 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "astra-sim/common/Logging.hh"
+#include "astra-sim/workload/WorkloadLoader.hh"
+#include "common/CmdLineParser.hh"
+
+using namespace AstraSim;
+using namespace AstraSimAnalytical;
+
+int main(int argc, char* argv[]) {
+    // Parse command line arguments
+    auto cmd_line_parser = CmdLineParser(argv[0]);
+    cmd_line_parser.get_options().add_options()(
+        "npus-count", "Number of NPUs whose ETs to compile",
+        cxxopts::value<int>());
+    cmd_line_parser.parse(argc, argv);
+
+    // Get command line arguments
+    const auto workload_configuration =
+        cmd_line_parser.get<std::string>("workload-configuration");
+    const auto workload_cache =
+        cmd_line_parser.get<std::string>("workload-cache");
+    const auto logging_configuration =
+        cmd_line_parser.get<std::string>("logging-configuration");
+    const auto logging_folder =
+        cmd_line_parser.get<std::string>("logging-folder");
+    const auto npus_count = cmd_line_parser.get<int>("npus-count");
+
+    if (workload_cache.empty()) {
+        std::cerr << "[Error] (AstraSim/analytical/compile_workload) "
+                  << "workload-cache is not given" << std::endl;
+        exit(-1);
+    }
+
+    AstraSim::LoggerFactory::init(logging_configuration, logging_folder);
+
+    // Compile the ETs missing from the cache
+    WorkloadLoader::set_cache_dir(workload_cache);
+    WorkloadLoader::compile(workload_configuration, npus_count);
+
+    AstraSim::LoggerFactory::shutdown();
+    return 0;
+}
@@ -14,12 +14,16 @@ using namespace NetworkAnalyticalCongestionAware;
 
 std::shared_ptr<Topology> CongestionAwareNetworkApi::topology;
 
+std::unique_ptr<RouteCache> CongestionAwareNetworkApi::route_cache;
+
 void CongestionAwareNetworkApi::set_topology(
     std::shared_ptr<Topology> topology_ptr) noexcept {
     assert(topology_ptr != nullptr);
 
     // move topology
     CongestionAwareNetworkApi::topology = std::move(topology_ptr);
+    CongestionAwareNetworkApi::route_cache =
+        std::make_unique<RouteCache>(CongestionAwareNetworkApi::topology);
 
     // set topology-related values
     CongestionAwareNetworkApi::dims_count =
@@ -33,6 +37,12 @@ CongestionAwareNetworkApi::CongestionAwareNetworkApi(const int rank) noexcept
     assert(rank >= 0);
 }
 
+void CongestionAwareNetworkApi::report_route_cache() noexcept {
+    assert(route_cache != nullptr);
+
+    route_cache->report();
+}
+
 int CongestionAwareNetworkApi::sim_send(void* const buffer,
                                         const uint64_t count,
                                         const int type,
@@ -41,8 +51,33 @@ int CongestionAwareNetworkApi::sim_send(void* const buffer,
                                         sim_request* const request,
                                         void (*msg_handler)(void*),
                                         void* const fun_arg) {
-    // query chunk id
     const auto src = sim_comm_get_rank();
+    send_chunk(src, dst, count, tag, msg_handler, fun_arg);
+
+    // return
+    return 0;
+}
+
+int CongestionAwareNetworkApi::sim_send_batch(
+    std::vector<BatchMessage>& messages) {
+    // every send of the batch leaves this rank
+    const auto src = sim_comm_get_rank();
+    for (const auto& message : messages) {
+        send_chunk(src, message.peer, message.count, message.tag,
+                   message.msg_handler, message.fun_arg);
+    }
+
+    // return
+    return 0;
+}
+
+void CongestionAwareNetworkApi::send_chunk(const int src,
+                                           const int dst,
+                                           const uint64_t count,
+                                           const int tag,
+                                           void (*msg_handler)(void*),
+                                           void* const fun_arg) noexcept {
+    // query chunk id
     const auto chunk_id =
         CongestionAwareNetworkApi::chunk_id_generator.create_send_chunk_id(
             tag, src, dst, count);
@@ -63,17 +98,15 @@ int CongestionAwareNetworkApi::sim_send(void* const buffer,
     }
 
     // create chunk
-    auto chunk_arrival_arg = std::tuple(tag, src, dst, count, chunk_id);
-    auto arg = std::make_unique<decltype(chunk_arrival_arg)>(chunk_arrival_arg);
-    const auto arg_ptr = static_cast<void*>(arg.release());
-    const auto route = topology->route(src, dst);
+    auto* const arg = ObjectPool<ChunkArrivalArg>::create(tag, src, dst,
+                                                          count, chunk_id);
+    const auto arg_ptr = static_cast<void*>(arg);
+    // the chunk consumes its own copy of the cached route as it moves
+    const auto& route = route_cache->get_route(src, dst);
     auto chunk = std::make_unique<Chunk>(
         count, route, CongestionAwareNetworkApi::process_chunk_arrival,
         arg_ptr);
 
     // initiate transmission from src -> dst.
     topology->send(std::move(chunk));
-
-    // return
-    return 0;
 }
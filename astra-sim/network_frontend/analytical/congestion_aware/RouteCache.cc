@@ -0,0 +1,54 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/RouteCache.hh"
+#include "astra-sim/common/Logging.hh"
+#include <cassert>
+
+using namespace AstraSimAnalyticalCongestionAware;
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+RouteCache::RouteCache(std::shared_ptr<Topology> topology) noexcept
+    : topology(std::move(topology)),
+      lookups(0),
+      hits(0) {
+    assert(this->topology != nullptr);
+
+    npus_count = this->topology->get_npus_count();
+}
+
+const Route& RouteCache::get_route(const DeviceId src,
+                                   const DeviceId dest) noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+
+    lookups++;
+
+    // search cache
+    const auto key = static_cast<uint64_t>(src) * npus_count + dest;
+    auto entry = routes.find(key);
+    if (entry != routes.end()) {
+        hits++;
+        return *entry->second;
+    }
+
+    // route the pair once
+    auto route = std::make_shared<const Route>(topology->route(src, dest));
+    entry = routes.emplace(key, std::move(route)).first;
+    return *entry->second;
+}
+
+void RouteCache::report() const noexcept {
+    auto hit_rate = 0.0;
+    if (lookups > 0) {
+        hit_rate = 100.0 * static_cast<double>(hits) /
+                   static_cast<double>(lookups);
+    }
+
+    AstraSim::LoggerFactory::get_logger("network")->info(
+        "route cache: {} routes, {} lookups, {:.1f}% hit rate", routes.size(),
+        lookups, hit_rate);
+}
@@ -4,6 +4,8 @@ LICENSE file in the root directory of this source tree.
 *******************************************************************************/
 
 #include "astra-sim/common/Logging.hh"
+#include "astra-sim/system/Checkpoint.hh"
+#include "astra-sim/workload/WorkloadLoader.hh"
 #include "common/CmdLineParser.hh"
 #include "congestion_aware/CongestionAwareNetworkApi.hh"
 #include <astra-network-analytical/common/EventQueue.h>
@@ -44,9 +46,23 @@ int main(int argc, char* argv[]) {
     const auto injection_scale = cmd_line_parser.get<double>("injection-scale");
     const auto rendezvous_protocol =
         cmd_line_parser.get<bool>("rendezvous-protocol");
+    auto checkpoint_interval =
+        cmd_line_parser.get<uint64_t>("checkpoint-interval");
+    const auto checkpoint_path =
+        cmd_line_parser.get<std::string>("checkpoint-path");
+    const auto restore_checkpoint =
+        cmd_line_parser.get<std::string>("restore-checkpoint");
+    const auto workload_cache =
+        cmd_line_parser.get<std::string>("workload-cache");
 
     AstraSim::LoggerFactory::init(logging_configuration, logging_folder);
 
+    if (cmd_line_parser.get<bool>("collapse-symmetric-ranks")) {
+        AstraSim::LoggerFactory::get_logger("network")->warn(
+            "collapse-symmetric-ranks requires the congestion_unaware "
+            "backend, simulating every rank");
+    }
+
     // Instantiate event queue
     const auto event_queue = std::make_shared<EventQueue>();
     Topology::set_event_queue(event_queue);
@@ -76,6 +92,14 @@ int main(int argc, char* argv[]) {
         queues_per_dim.push_back(num_queues_per_dim);
     }
 
+    // Parse the execution traces of all ranks ahead of Sys
+    auto ranks = std::vector<int>();
+    for (int i = 0; i < npus_count; i++) {
+        ranks.push_back(i);
+    }
+    WorkloadLoader::set_cache_dir(workload_cache);
+    WorkloadLoader::preload(workload_configuration, ranks);
+
     for (int i = 0; i < npus_count; i++) {
         // create network and system
         auto network_api = std::make_unique<CongestionAwareNetworkApi>(i);
@@ -89,17 +113,62 @@ int main(int argc, char* argv[]) {
         network_apis.push_back(std::move(network_api));
         systems.push_back(system);
     }
+    WorkloadLoader::check_streaming(systems);
 
     // Initiate ASTRA-sim simulation
-    for (int i = 0; i < npus_count; i++) {
-        systems[i]->workload->fire();
+    auto next_checkpoint = checkpoint_interval;
+    if (checkpoint_interval > 0) {
+        Checkpoint::enable(systems);
+    }
+    if (restore_checkpoint != "empty") {
+        auto reader = CheckpointReader(restore_checkpoint);
+        const auto tick = Checkpoint::load_tick(reader, systems);
+
+        // move the clock to the checkpoint
+        if (tick > 0) {
+            event_queue->schedule_event(tick, [](void*) {}, nullptr);
+            event_queue->proceed();
+        }
+        Checkpoint::restore(reader, systems);
+        if (checkpoint_interval > 0) {
+            next_checkpoint =
+                (tick / checkpoint_interval + 1) * checkpoint_interval;
+        }
+    } else {
+        for (int i = 0; i < npus_count; i++) {
+            systems[i]->workload->fire();
+        }
     }
 
     // run simulation
     while (!event_queue->finished()) {
         event_queue->proceed();
+
+        // save at the first quiescent point past each interval; no chunk is
+        // in flight once every send and recv has been matched
+        const auto now = event_queue->get_current_time();
+        if (checkpoint_interval > 0 && now >= next_checkpoint &&
+            CongestionAwareNetworkApi::get_callback_tracker().empty() &&
+            Checkpoint::is_quiescent(systems)) {
+            Checkpoint::save(checkpoint_path, now, systems);
+            next_checkpoint =
+                (now / checkpoint_interval + 1) * checkpoint_interval;
+        }
     }
 
+    // an interval passed without a quiescent point to save at
+    if (checkpoint_interval > 0 &&
+        event_queue->get_current_time() >= next_checkpoint) {
+        AstraSim::LoggerFactory::get_logger("network")->warn(
+            "no checkpoint written past tick {}, the simulation was never "
+            "quiescent after it",
+            next_checkpoint);
+    }
+
+    // report message matching structures
+    CongestionAwareNetworkApi::report_matching_stats();
+    CongestionAwareNetworkApi::report_route_cache();
+
     for (auto it : systems) {
         delete it;
     }
@@ -4,7 +4,12 @@ LICENSE file in the root directory of this source tree.
 *******************************************************************************/
 
 #include "congestion_unaware/CongestionUnawareNetworkApi.hh"
+#include "astra-sim/common/Logging.hh"
+#include <algorithm>
 #include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
 
 using namespace AstraSim;
 using namespace AstraSimAnalyticalCongestionUnaware;
@@ -13,6 +18,22 @@ using namespace NetworkAnalyticalCongestionUnaware;
 
 std::shared_ptr<Topology> CongestionUnawareNetworkApi::topology;
 
+std::shared_ptr<RankEquivalence> CongestionUnawareNetworkApi::rank_equivalence =
+    nullptr;
+
+std::shared_ptr<PartitionedEventQueue>
+    CongestionUnawareNetworkApi::partitioned_event_queue = nullptr;
+
+int CongestionUnawareNetworkApi::npus_count = -1;
+
+std::vector<CallbackTracker>
+    CongestionUnawareNetworkApi::partition_callback_trackers = {};
+
+std::vector<ChunkIdGenerator>
+    CongestionUnawareNetworkApi::partition_chunk_id_generators = {};
+
+std::vector<LatencyMemo> CongestionUnawareNetworkApi::latency_memos = {};
+
 void CongestionUnawareNetworkApi::set_topology(
     std::shared_ptr<Topology> topology_ptr) noexcept {
     assert(topology_ptr != nullptr);
@@ -25,11 +46,103 @@ void CongestionUnawareNetworkApi::set_topology(
         CongestionUnawareNetworkApi::topology->get_dims_count();
     CongestionUnawareNetworkApi::bandwidth_per_dim =
         CongestionUnawareNetworkApi::topology->get_bandwidth_per_dim();
+
+    // serial simulation memoizes latencies in a single table
+    latency_memos.assign(1,
+                         LatencyMemo(CongestionUnawareNetworkApi::topology));
+}
+
+void CongestionUnawareNetworkApi::set_rank_equivalence(
+    std::shared_ptr<RankEquivalence> rank_equivalence_ptr) noexcept {
+    assert(rank_equivalence_ptr != nullptr);
+
+    CongestionUnawareNetworkApi::rank_equivalence =
+        std::move(rank_equivalence_ptr);
+}
+
+void CongestionUnawareNetworkApi::set_partitioned_event_queue(
+    std::shared_ptr<PartitionedEventQueue> partitioned_event_queue_ptr,
+    const int npus_count) noexcept {
+    assert(partitioned_event_queue_ptr != nullptr);
+    assert(npus_count > 0);
+
+    CongestionUnawareNetworkApi::partitioned_event_queue =
+        std::move(partitioned_event_queue_ptr);
+    CongestionUnawareNetworkApi::npus_count = npus_count;
+
+    // each partition only touches its own tracker and generator
+    const auto partitions_count =
+        CongestionUnawareNetworkApi::partitioned_event_queue
+            ->get_partitions_count();
+    partition_callback_trackers.resize(partitions_count);
+    partition_chunk_id_generators.resize(partitions_count);
+    latency_memos.assign(partitions_count, LatencyMemo(topology));
+}
+
+EventTime CongestionUnawareNetworkApi::compute_lookahead(
+    const std::shared_ptr<Topology>& topology_ptr) noexcept {
+    assert(topology_ptr != nullptr);
+
+    // every message crosses at least one link of some dimension, and all
+    // NPUs of a dimension are equally far from their nearest neighbor
+    auto lookahead = std::numeric_limits<EventTime>::max();
+    auto stride = 1;
+    for (const auto npus : topology_ptr->get_npus_count_per_dim()) {
+        if (npus > 1) {
+            lookahead = std::min(lookahead, topology_ptr->send(0, stride, 1));
+        }
+        stride *= npus;
+    }
+
+    // single NPU
+    if (lookahead == std::numeric_limits<EventTime>::max()) {
+        return 0;
+    }
+    return lookahead;
+}
+
+int CongestionUnawareNetworkApi::get_partition(const int rank) noexcept {
+    if (partitioned_event_queue == nullptr) {
+        return 0;
+    }
+
+    assert(0 <= rank && rank < npus_count);
+    const auto partitions_count =
+        static_cast<int64_t>(partitioned_event_queue->get_partitions_count());
+    return static_cast<int>(rank * partitions_count / npus_count);
+}
+
+void CongestionUnawareNetworkApi::report_matching_stats() noexcept {
+    auto tracker_stats = callback_tracker.get_stats();
+    for (const auto& tracker : partition_callback_trackers) {
+        tracker_stats += tracker.get_stats();
+    }
+
+    auto generator_stats = chunk_id_generator.get_stats();
+    for (const auto& generator : partition_chunk_id_generators) {
+        generator_stats += generator.get_stats();
+    }
+
+    log_matching_stats(tracker_stats, generator_stats);
+
+    auto memo_stats = ChunkHashTableStats();
+    for (const auto& latency_memo : latency_memos) {
+        memo_stats += latency_memo.get_stats();
+    }
+    auto hit_rate = 0.0;
+    if (memo_stats.lookups > 0) {
+        hit_rate = 100.0 * static_cast<double>(memo_stats.hits) /
+                   static_cast<double>(memo_stats.lookups);
+    }
+    AstraSim::LoggerFactory::get_logger("network")->info(
+        "latency memo: {} entries, {} lookups, {:.1f}% hit rate",
+        memo_stats.size, memo_stats.lookups, hit_rate);
 }
 
 CongestionUnawareNetworkApi::CongestionUnawareNetworkApi(
     const int rank) noexcept
-    : CommonNetworkApi(rank) {
+    : CommonNetworkApi(rank),
+      partition(get_partition(rank)) {
     assert(rank >= 0);
 }
 
@@ -41,41 +154,305 @@ int CongestionUnawareNetworkApi::sim_send(void* const buffer,
                                           sim_request* const request,
                                           void (*msg_handler)(void*),
                                           void* const fun_arg) {
-    // query chunk id
     const auto src = sim_comm_get_rank();
+    return send_chunk(src, dst, count, tag, msg_handler, fun_arg);
+}
+
+int CongestionUnawareNetworkApi::sim_send_batch(
+    std::vector<BatchMessage>& messages) {
+    // every send of the batch leaves this rank, in the same simulation mode
+    const auto src = sim_comm_get_rank();
+    if (partitioned_event_queue != nullptr) {
+        for (const auto& message : messages) {
+            partitioned_send(src, message.peer, message.count, message.tag,
+                             message.msg_handler, message.fun_arg);
+        }
+        return 0;
+    }
+
+    for (const auto& message : messages) {
+        // collapsed destination: no one will receive the message
+        if (rank_equivalence != nullptr &&
+            !rank_equivalence->is_simulated(message.peer)) {
+            send_to_collapsed_rank(src, message.peer, message.count,
+                                   message.tag, message.msg_handler,
+                                   message.fun_arg);
+            continue;
+        }
+
+        const auto send_delay_ns =
+            get_latency(src, message.peer, message.count);
+        send_chunk_with_delay(src, message.peer, message.count, message.tag,
+                              message.msg_handler, message.fun_arg,
+                              send_delay_ns);
+    }
+
+    // return
+    return 0;
+}
+
+int CongestionUnawareNetworkApi::send_chunk(const int src,
+                                            const int dst,
+                                            const uint64_t count,
+                                            const int tag,
+                                            void (*msg_handler)(void*),
+                                            void* const fun_arg) {
+    if (partitioned_event_queue != nullptr) {
+        return partitioned_send(src, dst, count, tag, msg_handler, fun_arg);
+    }
+
+    // collapsed destination: no one will receive the message
+    if (rank_equivalence != nullptr && !rank_equivalence->is_simulated(dst)) {
+        send_to_collapsed_rank(src, dst, count, tag, msg_handler, fun_arg);
+        return 0;
+    }
+
+    // compute send communication delay and register chunk arrival event
+    const auto send_delay_ns = get_latency(src, dst, count);
+    send_chunk_with_delay(src, dst, count, tag, msg_handler, fun_arg,
+                          send_delay_ns);
+
+    // return
+    return 0;
+}
+
+int CongestionUnawareNetworkApi::sim_recv(void* const buffer,
+                                          const uint64_t count,
+                                          const int type,
+                                          const int src,
+                                          const int tag,
+                                          sim_request* const request,
+                                          void (*msg_handler)(void*),
+                                          void* const fun_arg) {
+    if (partitioned_event_queue != nullptr) {
+        const auto dst = sim_comm_get_rank();
+        return partitioned_recv(src, dst, count, tag, msg_handler, fun_arg);
+    }
+
+    return CommonNetworkApi::sim_recv(buffer, count, type, src, tag, request,
+                                      msg_handler, fun_arg);
+}
+
+int CongestionUnawareNetworkApi::sim_recv_batch(
+    std::vector<BatchMessage>& messages) {
+    if (partitioned_event_queue == nullptr) {
+        return CommonNetworkApi::sim_recv_batch(messages);
+    }
+
+    // every receive of the batch targets this rank
+    const auto dst = sim_comm_get_rank();
+    for (const auto& message : messages) {
+        partitioned_recv(message.peer, dst, message.count, message.tag,
+                         message.msg_handler, message.fun_arg);
+    }
+
+    // return
+    return 0;
+}
+
+timespec_t CongestionUnawareNetworkApi::sim_get_time() {
+    if (partitioned_event_queue != nullptr) {
+        const auto current_time =
+            partitioned_event_queue->get_current_time(partition);
+        return {NS, static_cast<double>(current_time)};
+    }
+
+    return CommonNetworkApi::sim_get_time();
+}
+
+Tick CongestionUnawareNetworkApi::sim_get_tick() {
+    if (partitioned_event_queue != nullptr) {
+        return partitioned_event_queue->get_current_time(partition) /
+               CLOCK_PERIOD;
+    }
+
+    return CommonNetworkApi::sim_get_tick();
+}
+
+void CongestionUnawareNetworkApi::sim_schedule(const timespec_t delta,
+                                               void (*fun_ptr)(void*),
+                                               void* const fun_arg) {
+    if (partitioned_event_queue == nullptr) {
+        CommonNetworkApi::sim_schedule(delta, fun_ptr, fun_arg);
+        return;
+    }
+
+    assert(delta.time_res == NS);
+    assert(fun_ptr != nullptr);
+
+    // calculate absolute event time
+    const auto current_time =
+        partitioned_event_queue->get_current_time(partition);
+    const auto event_time =
+        static_cast<double>(current_time) + delta.time_val;
+    const auto event_time_ns = static_cast<EventTime>(event_time);
+
+    // schedule the event to the queue of this rank's partition
+    assert(event_time_ns >= current_time);
+    partitioned_event_queue->schedule_event(partition, event_time_ns, fun_ptr,
+                                            fun_arg);
+}
+
+void CongestionUnawareNetworkApi::sim_notify_finished() {
+    if (rank_equivalence != nullptr) {
+        rank_equivalence->set_finish_time(sim_comm_get_rank(),
+                                          event_queue->get_current_time());
+    }
+}
+
+double CongestionUnawareNetworkApi::get_send_delay(const int src,
+                                                   const int dst,
+                                                   const uint64_t count) {
+    assert(src >= 0);
+    assert(dst >= 0);
+
+    // collapsed and partitioned runs do not have every rank at hand
+    if (rank_equivalence != nullptr || partitioned_event_queue != nullptr) {
+        return -1;
+    }
+
+    return static_cast<double>(get_latency(src, dst, count));
+}
+
+EventTime CongestionUnawareNetworkApi::get_latency(
+    const int src,
+    const int dst,
+    const uint64_t count) noexcept {
+    // each partition only touches its own memo
+    return latency_memos[partition].get_latency(src, dst, count);
+}
+
+void CongestionUnawareNetworkApi::send_to_collapsed_rank(
+    const int src,
+    const int dst,
+    const uint64_t count,
+    const int tag,
+    void (*msg_handler)(void*),
+    void* const fun_arg) {
+    // the send itself finishes once the chunk leaves the network
+    const auto send_delay_ns = get_latency(src, dst, count);
+    const auto send_delay = static_cast<double>(send_delay_ns);
+    const auto delta = timespec_t({NS, send_delay});
+    sim_schedule(delta, msg_handler, fun_arg);
+
+    // by symmetry, the mirrored peer sends the same chunk to src right now
+    const auto peer = rank_equivalence->get_mirror_peer(src, dst);
     const auto chunk_id =
         CongestionUnawareNetworkApi::chunk_id_generator.create_send_chunk_id(
-            tag, src, dst, count);
+            tag, peer, src, count);
 
-    // search tracker
     const auto entry =
-        callback_tracker.search_entry(tag, src, dst, count, chunk_id);
+        callback_tracker.search_entry(tag, peer, src, count, chunk_id);
     if (entry.has_value()) {
-        // recv operation already issued.
-        // add send event handler to the tracker
-        entry.value()->register_send_callback(msg_handler, fun_arg);
+        entry.value()->register_send_callback(ignore_mirrored_send, nullptr);
     } else {
-        // recv operation not issued yet
-        // create new entry and insert send callback
         auto* const new_entry =
-            callback_tracker.create_new_entry(tag, src, dst, count, chunk_id);
-        new_entry->register_send_callback(msg_handler, fun_arg);
+            callback_tracker.create_new_entry(tag, peer, src, count, chunk_id);
+        new_entry->register_send_callback(ignore_mirrored_send, nullptr);
     }
 
-    // create chunk
-    auto chunk_arrival_arg = std::tuple(tag, src, dst, count, chunk_id);
-    auto arg = std::make_unique<decltype(chunk_arrival_arg)>(chunk_arrival_arg);
-    const auto arg_ptr = static_cast<void*>(arg.release());
+    auto* const arg = ObjectPool<ChunkArrivalArg>::create(tag, peer, src,
+                                                          count, chunk_id);
+    const auto mirrored_delay_ns = get_latency(peer, src, count);
+    schedule_chunk_arrival(mirrored_delay_ns, arg);
+}
+
+void CongestionUnawareNetworkApi::ignore_mirrored_send(
+    void* const args) noexcept {
+    // the sender of a mirrored message is not simulated
+    (void)args;
+}
 
-    // compute send communication delay (in AstraSim format)
-    const auto send_delay_ns = topology->send(src, dst, count);
-    const auto send_delay = static_cast<double>(send_delay_ns);
-    const auto delta = timespec_t({NS, send_delay});
+int CongestionUnawareNetworkApi::partitioned_send(const int src,
+                                                  const int dst,
+                                                  const uint64_t count,
+                                                  const int tag,
+                                                  void (*msg_handler)(void*),
+                                                  void* const fun_arg) {
+    // query chunk id; send ids are only generated on the source partition
+    auto& chunk_id_generator = partition_chunk_id_generators[partition];
+    const auto chunk_id =
+        chunk_id_generator.create_send_chunk_id(tag, src, dst, count);
+
+    // compute send communication delay
+    const auto send_delay_ns = get_latency(src, dst, count);
+    const auto dst_partition = get_partition(dst);
+    if (dst_partition != partition &&
+        send_delay_ns < partitioned_event_queue->get_lookahead()) {
+        std::cerr << "[Error] (AstraSim/analytical/congestion_unaware) "
+                  << "Delay of the chunk from " << src << " to " << dst
+                  << " is shorter than the lookahead" << std::endl;
+        std::exit(-1);
+    }
+
+    // the send callback runs on this partition, then the arrival runs on the
+    // destination partition, at the same point of the serial order
+    auto* const arg = ObjectPool<ChunkArrivalArg>::create(tag, src, dst,
+                                                          count, chunk_id);
+    const auto arrival_time =
+        partitioned_event_queue->get_current_time(partition) + send_delay_ns;
+    partitioned_event_queue->schedule_split_event(
+        partition, dst_partition, arrival_time, msg_handler, fun_arg,
+        CongestionUnawareNetworkApi::process_partitioned_chunk_arrival,
+        static_cast<void*>(arg));
+
+    // return
+    return 0;
+}
 
-    // register chunk arrival event after send communication delay
-    sim_schedule(delta, CongestionUnawareNetworkApi::process_chunk_arrival,
-                 arg_ptr);
+int CongestionUnawareNetworkApi::partitioned_recv(const int src,
+                                                  const int dst,
+                                                  const uint64_t count,
+                                                  const int tag,
+                                                  void (*msg_handler)(void*),
+                                                  void* const fun_arg) {
+    // query chunk id
+    auto& chunk_id_generator = partition_chunk_id_generators[partition];
+    const auto chunk_id =
+        chunk_id_generator.create_recv_chunk_id(tag, src, dst, count);
+
+    // the tracker of the destination partition only holds receive callbacks
+    // and chunks that arrived before their receive
+    auto& tracker = partition_callback_trackers[partition];
+    const auto entry = tracker.search_entry(tag, src, dst, count, chunk_id);
+    if (entry.has_value()) {
+        // chunk already arrived, run callback immediately
+        assert(entry.value()->is_transmission_finished());
+        tracker.pop_entry(tag, src, dst, count, chunk_id);
+
+        const auto delta = timespec_t{NS, 0};
+        sim_schedule(delta, msg_handler, fun_arg);
+    } else {
+        auto* const new_entry =
+            tracker.create_new_entry(tag, src, dst, count, chunk_id);
+        new_entry->register_recv_callback(msg_handler, fun_arg);
+    }
 
     // return
     return 0;
 }
+
+void CongestionUnawareNetworkApi::process_partitioned_chunk_arrival(
+    void* const args) noexcept {
+    assert(args != nullptr);
+
+    // parse chunk data
+    auto* const data = static_cast<ChunkArrivalArg*>(args);
+    const auto [tag, src, dest, count, chunk_id] = *data;
+    ObjectPool<ChunkArrivalArg>::destroy(data);
+
+    // search tracker of the destination partition
+    auto& tracker = partition_callback_trackers[get_partition(dest)];
+    const auto entry = tracker.search_entry(tag, src, dest, count, chunk_id);
+    if (entry.has_value()) {
+        // recv already issued; pop before the handler touches the tracker
+        auto callbacks = *entry.value();
+        tracker.pop_entry(tag, src, dest, count, chunk_id);
+        callbacks.invoke_recv_handler();
+    } else {
+        // recv callback will be invoked immediately when sim_recv() is called
+        auto* const new_entry =
+            tracker.create_new_entry(tag, src, dest, count, chunk_id);
+        new_entry->set_transmission_finished();
+    }
+}
@@ -0,0 +1,58 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_unaware/LatencyMemo.hh"
+#include <cassert>
+
+using namespace AstraSimAnalyticalCongestionUnaware;
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionUnaware;
+
+LatencyMemo::LatencyMemo(std::shared_ptr<Topology> topology) noexcept
+    : topology(std::move(topology)) {
+    assert(this->topology != nullptr);
+
+    npus_count_per_dim = this->topology->get_npus_count_per_dim();
+}
+
+EventTime LatencyMemo::get_latency(const DeviceId src,
+                                   const DeviceId dest,
+                                   const ChunkSize chunk_size) noexcept {
+    // search memo
+    const auto key = ChunkKey(0, get_offset(src, dest), 0, chunk_size);
+    const auto* const latency = latencies.find(key);
+    if (latency != nullptr) {
+        return *latency;
+    }
+
+    // compute the latency once per (offset, size)
+    const auto new_latency = topology->send(src, dest, chunk_size);
+    *latencies.insert(key) = new_latency;
+    return new_latency;
+}
+
+ChunkHashTableStats LatencyMemo::get_stats() const noexcept {
+    return latencies.get_stats();
+}
+
+int LatencyMemo::get_offset(const DeviceId src,
+                            const DeviceId dest) const noexcept {
+    auto offset = 0;
+    auto stride = 1;
+    auto src_rest = src;
+    auto dest_rest = dest;
+    for (const auto npus : npus_count_per_dim) {
+        const auto src_coord = src_rest % npus;
+        const auto dest_coord = dest_rest % npus;
+        offset += ((dest_coord - src_coord + npus) % npus) * stride;
+
+        src_rest /= npus;
+        dest_rest /= npus;
+        stride *= npus;
+    }
+
+    assert(src_rest == 0 && dest_rest == 0);
+    return offset;
+}
@@ -4,7 +4,11 @@ LICENSE file in the root directory of this source tree.
 *******************************************************************************/
 
 #include "astra-sim/common/Logging.hh"
+#include "astra-sim/system/Checkpoint.hh"
+#include "astra-sim/workload/WorkloadLoader.hh"
 #include "common/CmdLineParser.hh"
+#include "common/PartitionedEventQueue.hh"
+#include "common/RankEquivalence.hh"
 #include "congestion_unaware/CongestionUnawareNetworkApi.hh"
 #include <astra-network-analytical/common/EventQueue.h>
 #include <astra-network-analytical/common/NetworkParser.h>
@@ -44,9 +48,31 @@ int main(int argc, char* argv[]) {
     const auto injection_scale = cmd_line_parser.get<double>("injection-scale");
     const auto rendezvous_protocol =
         cmd_line_parser.get<bool>("rendezvous-protocol");
+    auto checkpoint_interval =
+        cmd_line_parser.get<uint64_t>("checkpoint-interval");
+    const auto checkpoint_path =
+        cmd_line_parser.get<std::string>("checkpoint-path");
+    const auto restore_checkpoint =
+        cmd_line_parser.get<std::string>("restore-checkpoint");
+    auto collapse_symmetric_ranks =
+        cmd_line_parser.get<bool>("collapse-symmetric-ranks");
+    const auto num_threads = cmd_line_parser.get<int>("num-threads");
+    const auto coalesce_arrivals =
+        cmd_line_parser.get<bool>("coalesce-arrivals");
+    const auto workload_cache =
+        cmd_line_parser.get<std::string>("workload-cache");
 
     AstraSim::LoggerFactory::init(logging_configuration, logging_folder);
 
+    // communicator groups break the symmetry between identical workloads
+    if (collapse_symmetric_ranks &&
+        comm_group_configuration.find("empty") == std::string::npos) {
+        AstraSim::LoggerFactory::get_logger("network")->warn(
+            "collapse-symmetric-ranks is not supported with communicator "
+            "groups, simulating every rank");
+        collapse_symmetric_ranks = false;
+    }
+
     // Instantiate event queue
     const auto event_queue = std::make_shared<EventQueue>();
 
@@ -62,6 +88,49 @@ int main(int argc, char* argv[]) {
     // Set up Network API
     CongestionUnawareNetworkApi::set_event_queue(event_queue);
     CongestionUnawareNetworkApi::set_topology(topology);
+    CongestionUnawareNetworkApi::set_coalesce_arrivals(coalesce_arrivals);
+
+    // Set up parallel simulation
+    auto partitioned_event_queue =
+        std::shared_ptr<PartitionedEventQueue>(nullptr);
+    if (num_threads > 1) {
+        const auto lookahead =
+            CongestionUnawareNetworkApi::compute_lookahead(topology);
+        if (collapse_symmetric_ranks) {
+            AstraSim::LoggerFactory::get_logger("network")->warn(
+                "num-threads is not supported with collapse-symmetric-ranks, "
+                "running on a single thread");
+        } else if (lookahead == 0) {
+            AstraSim::LoggerFactory::get_logger("network")->warn(
+                "num-threads requires a non-zero link latency, "
+                "running on a single thread");
+        } else {
+            const auto partitions_count = std::min(num_threads, npus_count);
+            partitioned_event_queue = std::make_shared<PartitionedEventQueue>(
+                partitions_count, lookahead);
+            CongestionUnawareNetworkApi::set_partitioned_event_queue(
+                partitioned_event_queue, npus_count);
+        }
+    }
+
+    // ETs are hashed through the workload cache, if any, from here on
+    WorkloadLoader::set_cache_dir(workload_cache);
+
+    // Select the ranks to simulate
+    auto simulated_ranks = std::vector<int>();
+    auto rank_equivalence = std::shared_ptr<RankEquivalence>(nullptr);
+    if (collapse_symmetric_ranks) {
+        RankEquivalence::check_collapsible(system_configuration,
+                                           network_parser);
+        rank_equivalence = std::make_shared<RankEquivalence>(
+            workload_configuration, npus_count_per_dim);
+        CongestionUnawareNetworkApi::set_rank_equivalence(rank_equivalence);
+        simulated_ranks = rank_equivalence->get_representatives();
+    } else {
+        for (int i = 0; i < npus_count; i++) {
+            simulated_ranks.push_back(i);
+        }
+    }
 
     // Create ASTRA-sim related resources
     auto network_apis =
@@ -75,7 +144,10 @@ int main(int argc, char* argv[]) {
         queues_per_dim.push_back(num_queues_per_dim);
     }
 
-    for (int i = 0; i < npus_count; i++) {
+    // Parse the execution traces of the simulated ranks ahead of Sys
+    WorkloadLoader::preload(workload_configuration, simulated_ranks);
+
+    for (const auto i : simulated_ranks) {
         // create network and system
         auto network_api = std::make_unique<CongestionUnawareNetworkApi>(i);
         auto* const system =
@@ -88,15 +160,106 @@ int main(int argc, char* argv[]) {
         network_apis.push_back(std::move(network_api));
         systems.push_back(system);
     }
+    WorkloadLoader::check_streaming(systems);
+
+    // ranks on different threads must not share simulation state
+    if (partitioned_event_queue != nullptr) {
+        for (auto* const system : systems) {
+            if (system->tick_multiplexing ||
+                system->offline_greedy != nullptr) {
+                std::cerr << "[Error] (AstraSim/analytical/congestion_unaware) "
+                          << "num-threads is not supported with "
+                          << "tick-multiplexing or offline greedy scheduling"
+                          << std::endl;
+                exit(-1);
+            }
+        }
+    }
+
+    if (checkpoint_interval > 0 && partitioned_event_queue != nullptr) {
+        AstraSim::LoggerFactory::get_logger("network")->warn(
+            "checkpoint-interval is not supported with num-threads, "
+            "checkpointing disabled");
+        checkpoint_interval = 0;
+    }
 
     // Initiate simulation
-    for (int i = 0; i < npus_count; i++) {
-        systems[i]->workload->fire();
+    auto next_checkpoint = checkpoint_interval;
+    if (checkpoint_interval > 0) {
+        Checkpoint::enable(systems);
+    }
+    if (restore_checkpoint != "empty") {
+        if (partitioned_event_queue != nullptr) {
+            std::cerr << "[Error] (AstraSim/analytical/congestion_unaware) "
+                      << "restore-checkpoint is not supported with num-threads"
+                      << std::endl;
+            exit(-1);
+        }
+        auto reader = CheckpointReader(restore_checkpoint);
+        const auto tick = Checkpoint::load_tick(reader, systems);
+
+        // move the clock to the checkpoint
+        if (tick > 0) {
+            event_queue->schedule_event(tick, [](void*) {}, nullptr);
+            event_queue->proceed();
+        }
+        Checkpoint::restore(reader, systems);
+        if (checkpoint_interval > 0) {
+            next_checkpoint =
+                (tick / checkpoint_interval + 1) * checkpoint_interval;
+        }
+    } else {
+        for (auto* const system : systems) {
+            system->workload->fire();
+        }
     }
 
     // run simulation
-    while (!event_queue->finished()) {
-        event_queue->proceed();
+    if (partitioned_event_queue != nullptr) {
+        // each thread reads the clock of its own partition
+        partitioned_event_queue->run([&](const int partition) {
+            for (const auto& network_api : network_apis) {
+                const auto rank = network_api->sim_comm_get_rank();
+                if (CongestionUnawareNetworkApi::get_partition(rank) ==
+                    partition) {
+                    Sys::clock_source = network_api.get();
+                    break;
+                }
+            }
+        });
+        Sys::clock_source = nullptr;
+    } else {
+        while (!event_queue->finished()) {
+            event_queue->proceed();
+
+            // save at the first quiescent point past each interval
+            const auto now = event_queue->get_current_time();
+            if (checkpoint_interval > 0 && now >= next_checkpoint &&
+                CongestionUnawareNetworkApi::get_callback_tracker().empty() &&
+                Checkpoint::is_quiescent(systems)) {
+                Checkpoint::save(checkpoint_path, now, systems);
+                next_checkpoint =
+                    (now / checkpoint_interval + 1) * checkpoint_interval;
+            }
+        }
+    }
+
+    // an interval passed without a quiescent point to save at
+    if (checkpoint_interval > 0 &&
+        event_queue->get_current_time() >= next_checkpoint) {
+        AstraSim::LoggerFactory::get_logger("network")->warn(
+            "no checkpoint written past tick {}, the simulation was never "
+            "quiescent after it",
+            next_checkpoint);
+    }
+
+    // report message matching structures
+    CongestionUnawareNetworkApi::report_matching_stats();
+
+    // report per-class results
+    auto exit_code = 0;
+    if (rank_equivalence != nullptr && !rank_equivalence->report()) {
+        exit_code = -1;
     }
 
     for (auto it : systems) {
@@ -106,5 +269,5 @@ int main(int argc, char* argv[]) {
 
     // terminate simulation
     AstraSim::LoggerFactory::shutdown();
-    return 0;
+    return exit_code;
 }
@@ -6,14 +6,17 @@ LICENSE file in the root directory of this source tree.
 #pragma once
 
 #include "common/CallbackTrackerEntry.hh"
+#include "common/ChunkHashTable.hh"
 #include "common/ChunkIdGenerator.hh"
-#include <map>
+#include <optional>
 
 namespace AstraSimAnalytical {
 
 /**
  * CallbackTracker keeps track of sim_send() and sim_recv() callbacks of each
  * chunk identified by (tag, src, dest, chunk_size, chunk_id) tuple.
+ * Entries live in an open-addressing table: returned entry pointers are only
+ * valid until the next create_new_entry() or pop_entry() call.
  */
 class CallbackTracker {
   public:
@@ -71,10 +74,24 @@ class CallbackTracker {
                    ChunkSize chunk_size,
                    int chunk_id) noexcept;
 
+    /**
+     * Check whether no sim_send() or sim_recv() call is pending.
+     *
+     * @return true if the tracker has no entry, false otherwise
+     */
+    [[nodiscard]] bool empty() const noexcept;
+
+    /**
+     * Get the size and lookup counters of the tracker.
+     *
+     * @return counters of the tracker
+     */
+    [[nodiscard]] const ChunkHashTableStats& get_stats() const noexcept;
+
   private:
-    /// map from (tag, src, dest, chunk_size, chunk_id) tuple to
+    /// table from (tag, src, dest, chunk_size, chunk_id) key to
     /// CallbackTrackerEntry
-    std::map<Key, CallbackTrackerEntry> tracker;
+    ChunkHashTable<CallbackTrackerEntry> tracker;
 };
 
 }  // namespace AstraSimAnalytical
@@ -0,0 +1,32 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "astra-sim/common/MessageMatcher.hh"
+
+namespace AstraSimAnalytical {
+
+/**
+ * ChunkKey identifies a chunk (or a stream of chunks) by
+ * (tag, src, dest, chunk_size, chunk_id).
+ */
+using ChunkKey = AstraSim::MessageKey;
+
+/**
+ * Counters of a ChunkHashTable, reported at the end of the simulation.
+ */
+using ChunkHashTableStats = AstraSim::MessageTableStats;
+
+/**
+ * ChunkHashTable is the open-addressing table shared with the other network
+ * frontends, keyed by ChunkKey.
+ *
+ * @tparam Value default-constructible value type
+ */
+template <typename Value>
+using ChunkHashTable = AstraSim::MessageTable<Value>;
+
+}  // namespace AstraSimAnalytical
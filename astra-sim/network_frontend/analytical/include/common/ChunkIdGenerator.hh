@@ -5,10 +5,9 @@ LICENSE file in the root directory of this source tree.
 
 #pragma once
 
+#include "common/ChunkHashTable.hh"
 #include "common/ChunkIdGeneratorEntry.hh"
 #include <astra-network-analytical/common/Type.h>
-#include <map>
-#include <tuple>
 
 using namespace NetworkAnalytical;
 
@@ -17,12 +16,11 @@ namespace AstraSimAnalytical {
 /**
  * ChunkIdGenerator generates unique chunk id for sim_send() and sim_recv()
  * calls given (tag, src, dest, chunk_size) tuple.
+ * The entry of a tuple is reclaimed once all chunks it numbered are delivered,
+ * after which numbering restarts from 0 on both sides.
  */
 class ChunkIdGenerator {
   public:
-    /// Key = (tag, src, dest, chunk_size)
-    using Key = std::tuple<int, int, int, ChunkSize>;
-
     /**
      * Constructor.
      */
@@ -56,9 +54,31 @@ class ChunkIdGenerator {
                                            int dest,
                                            ChunkSize chunk_size) noexcept;
 
+    /**
+     * Record that a chunk has been delivered to both its sim_send() and
+     * sim_recv() callers, and reclaim the entry of the tuple once all of its
+     * chunks are delivered.
+     *
+     * @param tag tag of the chunk
+     * @param src src NPU ID of the chunk
+     * @param dest dest NPU ID of the chunk
+     * @param chunk_size size of the chunk
+     */
+    void complete_chunk(int tag,
+                        int src,
+                        int dest,
+                        ChunkSize chunk_size) noexcept;
+
+    /**
+     * Get the size and lookup counters of the generator.
+     *
+     * @return counters of the generator
+     */
+    [[nodiscard]] const ChunkHashTableStats& get_stats() const noexcept;
+
   private:
-    /// map from (tag, src, dest, chunk_size) tuple to ChunkIdGeneratorEntry
-    std::map<Key, ChunkIdGeneratorEntry> chunk_id_map;
+    /// table from (tag, src, dest, chunk_size) key to ChunkIdGeneratorEntry
+    ChunkHashTable<ChunkIdGeneratorEntry> chunk_id_map;
 };
 
 }  // namespace AstraSimAnalytical
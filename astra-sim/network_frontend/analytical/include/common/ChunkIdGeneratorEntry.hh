@@ -43,12 +43,28 @@ class ChunkIdGeneratorEntry {
      */
     void increment_recv_id() noexcept;
 
+    /**
+     * Record that a chunk of this tuple has been delivered.
+     */
+    void increment_completed_count() noexcept;
+
+    /**
+     * Check whether every chunk id handed out so far has been used by both
+     * sim_send() and sim_recv(), and all these chunks have been delivered.
+     *
+     * @return true if the entry is no longer needed, false otherwise
+     */
+    [[nodiscard]] bool is_drained() const noexcept;
+
   private:
     /// current available chunk id for sim_send() call
     int send_id;
 
     /// current available chunk id for sim_recv() call
     int recv_id;
+
+    /// number of delivered chunks
+    int completed_count;
 };
 
 }  // namespace AstraSimAnalytical
@@ -9,8 +9,11 @@ LICENSE file in the root directory of this source tree.
 #include "common/ChunkIdGenerator.hh"
 #include <astra-network-analytical/common/EventQueue.h>
 #include <astra-sim/common/AstraNetworkAPI.hh>
+#include <astra-sim/common/ObjectPool.hh>
 #include <astra-sim/system/Common.hh>
 #include <memory>
+#include <tuple>
+#include <unordered_map>
 #include <vector>
 
 using namespace AstraSim;
@@ -25,6 +28,9 @@ namespace AstraSimAnalytical {
  */
 class CommonNetworkApi : public AstraNetworkAPI {
   public:
+    /// argument of process_chunk_arrival: (tag, src, dest, count, chunk_id)
+    using ChunkArrivalArg = std::tuple<int, int, int, uint64_t, int>;
+
     /**
      * Set the event queue to be used.
      *
@@ -33,6 +39,15 @@ class CommonNetworkApi : public AstraNetworkAPI {
     static void set_event_queue(
         std::shared_ptr<EventQueue> event_queue_ptr) noexcept;
 
+    /**
+     * Deliver all chunks arriving at the same time through a single event
+     * queue event instead of one event per chunk. Arrivals of one time then
+     * run back to back, ahead of other events scheduled in between them.
+     *
+     * @param coalesce whether to coalesce chunk arrivals
+     */
+    static void set_coalesce_arrivals(bool coalesce) noexcept;
+
     /**
      * Get the reference to the callback tracker.
      *
@@ -47,6 +62,12 @@ class CommonNetworkApi : public AstraNetworkAPI {
      */
     static void process_chunk_arrival(void* args) noexcept;
 
+    /**
+     * Log the size and hit rate of the callback tracker and the chunk id
+     * generator at the end of the simulation.
+     */
+    static void report_matching_stats() noexcept;
+
     /**
      * Constructor.
      *
@@ -59,6 +80,11 @@ class CommonNetworkApi : public AstraNetworkAPI {
      */
     [[nodiscard]] timespec_t sim_get_time() override;
 
+    /**
+     * Implement sim_get_tick of AstraNetworkAPI.
+     */
+    [[nodiscard]] Tick sim_get_tick() override;
+
     /**
      * Implement sim_schedule of AstraNetworkAPI.
      */
@@ -78,12 +104,74 @@ class CommonNetworkApi : public AstraNetworkAPI {
                  void (*msg_handler)(void* fun_arg),
                  void* fun_arg) override;
 
+    /**
+     * Implement sim_recv_batch of AstraNetworkAPI.
+     */
+    int sim_recv_batch(std::vector<BatchMessage>& messages) override;
+
     /**
      * Implement get_BW_at_dimension of AstraNetworkAPI.
      */
     double get_BW_at_dimension(int dim) override;
 
   protected:
+    /**
+     * Log the given callback tracker and chunk id generator counters.
+     *
+     * @param tracker_stats counters of the callback tracker(s)
+     * @param generator_stats counters of the chunk id generator(s)
+     */
+    static void log_matching_stats(
+        const ChunkHashTableStats& tracker_stats,
+        const ChunkHashTableStats& generator_stats) noexcept;
+
+    /**
+     * Match a receive of this rank against the callback tracker.
+     *
+     * @param src src NPU ID of the chunk
+     * @param dst dst NPU ID of the chunk, i.e., this rank
+     * @param count size of the chunk
+     * @param tag tag of the chunk
+     * @param msg_handler callback to invoke when the chunk arrives
+     * @param fun_arg argument of the callback
+     */
+    void recv_chunk(int src,
+                    int dst,
+                    uint64_t count,
+                    int tag,
+                    void (*msg_handler)(void* fun_arg),
+                    void* fun_arg) noexcept;
+
+    /**
+     * Schedule the arrival of a chunk after the given delay, coalescing it
+     * with the other arrivals of the same time if enabled.
+     *
+     * @param send_delay_ns delay until the chunk arrives, in ns
+     * @param arg chunk to deliver
+     */
+    void schedule_chunk_arrival(EventTime send_delay_ns,
+                                ChunkArrivalArg* arg) noexcept;
+
+    /**
+     * Register a send of this rank in the callback tracker and schedule the
+     * arrival of the chunk after the given delay.
+     *
+     * @param src src NPU ID of the chunk, i.e., this rank
+     * @param dst dst NPU ID of the chunk
+     * @param count size of the chunk
+     * @param tag tag of the chunk
+     * @param msg_handler callback to invoke when the chunk arrives
+     * @param fun_arg argument of the callback
+     * @param send_delay_ns delay until the chunk arrives, in ns
+     */
+    void send_chunk_with_delay(int src,
+                               int dst,
+                               uint64_t count,
+                               int tag,
+                               void (*msg_handler)(void* fun_arg),
+                               void* fun_arg,
+                               EventTime send_delay_ns) noexcept;
+
     /// event queue
     static std::shared_ptr<EventQueue> event_queue;
 
@@ -98,6 +186,30 @@ class CommonNetworkApi : public AstraNetworkAPI {
 
     /// number of network dimensions of the topology
     static int dims_count;
+
+  private:
+    /// chunks arriving at the same time, delivered by a single event
+    struct ArrivalBatch {
+        EventTime time;
+        std::vector<ChunkArrivalArg*> chunks;
+    };
+
+    /**
+     * Deliver every chunk of an arrival batch.
+     *
+     * @param args ArrivalBatch to deliver
+     */
+    static void process_arrival_batch(void* args) noexcept;
+
+    /// whether chunk arrivals of the same time are coalesced
+    static bool coalesce_arrivals;
+
+    /// pending arrival batch per arrival time
+    static std::unordered_map<EventTime, ArrivalBatch*> arrival_batches;
+
+    /// number of chunk arrivals and of events delivering them
+    static uint64_t arrivals_count;
+    static uint64_t arrival_events_count;
 };
 
 }  // namespace AstraSimAnalytical
@@ -0,0 +1,250 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include <astra-network-analytical/common/Type.h>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace AstraSimAnalytical {
+
+/**
+ * PartitionedEventQueue is a conservative parallel replacement of EventQueue.
+ *
+ * Ranks are split into partitions, each owning an event queue that is run by
+ * its own worker thread. Partitions proceed in lock-step windows of
+ * `lookahead` ns: an event may only schedule events on another partition at
+ * least `lookahead` ns ahead, so every window can be run in parallel.
+ * Cross-partition events are buffered and delivered between windows.
+ *
+ * EventQueue runs events of the same time in the order they were scheduled.
+ * To reproduce that order, every event is keyed by the position of its parent
+ * (the event that scheduled it) in the serial execution order, plus its index
+ * among its siblings. Positions of the events of each window are computed
+ * between windows by merging the per-partition execution logs, so the
+ * resulting event order, and hence the simulation result, is identical to a
+ * serial run.
+ */
+class PartitionedEventQueue {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param partitions_count number of partitions (worker threads)
+     * @param lookahead minimum delay of a cross-partition event in ns
+     */
+    PartitionedEventQueue(int partitions_count, EventTime lookahead) noexcept;
+
+    /**
+     * Get the number of partitions.
+     *
+     * @return number of partitions
+     */
+    [[nodiscard]] int get_partitions_count() const noexcept;
+
+    /**
+     * Get the lookahead.
+     *
+     * @return minimum delay of a cross-partition event in ns
+     */
+    [[nodiscard]] EventTime get_lookahead() const noexcept;
+
+    /**
+     * Get the current time of a partition.
+     *
+     * @param partition partition to query
+     * @return current time of the partition
+     */
+    [[nodiscard]] EventTime get_current_time(int partition) const noexcept;
+
+    /**
+     * Schedule an event on a partition.
+     *
+     * @param partition partition to run the event on
+     * @param event_time time of the event
+     * @param callback callback function pointer
+     * @param callback_arg argument of the callback function
+     */
+    void schedule_event(int partition,
+                        EventTime event_time,
+                        Callback callback,
+                        CallbackArg callback_arg) noexcept;
+
+    /**
+     * Schedule one event whose work is split across two partitions, e.g., a
+     * chunk arrival that completes the send on the source and the receive on
+     * the destination. The first half runs immediately before the second
+     * half in the serial order.
+     *
+     * @param first_partition partition to run the first half on
+     * @param second_partition partition to run the second half on
+     * @param event_time time of the event
+     * @param first_callback callback of the first half
+     * @param first_callback_arg argument of the first half
+     * @param second_callback callback of the second half
+     * @param second_callback_arg argument of the second half
+     */
+    void schedule_split_event(int first_partition,
+                              int second_partition,
+                              EventTime event_time,
+                              Callback first_callback,
+                              CallbackArg first_callback_arg,
+                              Callback second_callback,
+                              CallbackArg second_callback_arg) noexcept;
+
+    /**
+     * Run the simulation until every partition runs out of events.
+     *
+     * @param on_worker_start invoked by each worker thread with its partition
+     *                        before it runs any event
+     */
+    void run(const std::function<void(int)>& on_worker_start) noexcept;
+
+  private:
+    /// event with its position in the serial order
+    struct OrderedEvent {
+        /// time of the event
+        EventTime time;
+
+        /// window, partition and execution index of the parent event
+        uint64_t parent_window;
+        int parent_partition;
+        uint64_t parent_index;
+
+        /// index among the events scheduled by the parent
+        uint64_t child_index;
+
+        /// 0, or 1 for the second half of a split event
+        int phase;
+
+        /// callback function pointer and its argument
+        Callback callback;
+        CallbackArg callback_arg;
+    };
+
+    /// event queue and bookkeeping of one partition
+    struct Partition {
+        /// current time of the partition
+        EventTime current_time;
+
+        /// pending events, as a heap ordered by serial position
+        std::vector<OrderedEvent> events;
+
+        /// events scheduled on each other partition during this window
+        std::vector<std::vector<OrderedEvent>> outbox;
+
+        /// events run during this window, in execution order
+        std::vector<OrderedEvent> executed;
+
+        /// number of pending events per parent window
+        std::map<uint64_t, uint64_t> window_refs;
+    };
+
+    /// number of partitions
+    int partitions_count;
+
+    /// minimum delay of a cross-partition event
+    EventTime lookahead;
+
+    /// partitions
+    std::vector<Partition> partitions;
+
+    /// index of the window being run (0 is the setup before run())
+    uint64_t current_window;
+
+    /// end of the window being run (exclusive)
+    EventTime window_end;
+
+    /// whether every partition ran out of events
+    bool finished;
+
+    /// serial position of each event run in a window, per partition
+    std::unordered_map<uint64_t, std::vector<std::vector<uint64_t>>>
+        window_positions;
+
+    /// barrier state
+    std::mutex barrier_mutex;
+    std::condition_variable barrier_cv;
+    int barrier_waiting;
+    uint64_t barrier_generation;
+
+    /// partition run by this thread, or -1 outside of run()
+    static thread_local int current_partition;
+
+    /// identity of the event being run by this thread
+    static thread_local uint64_t current_index;
+
+    /// number of events scheduled by the event being run by this thread
+    static thread_local uint64_t current_children;
+
+    /**
+     * Compare the serial positions of two events.
+     *
+     * @return true if event a runs before event b
+     */
+    [[nodiscard]] bool runs_before(const OrderedEvent& a,
+                                   const OrderedEvent& b) const noexcept;
+
+    /**
+     * Build an event scheduled by the event being run on this thread.
+     */
+    OrderedEvent make_event(EventTime event_time,
+                            int phase,
+                            Callback callback,
+                            CallbackArg callback_arg) noexcept;
+
+    /**
+     * Insert an event to the queue of a partition, or to the outbox of the
+     * current partition if it belongs to another one.
+     */
+    void insert_event(int partition, const OrderedEvent& event) noexcept;
+
+    /**
+     * Push an event to the heap of a partition.
+     */
+    void push_event(Partition& partition, const OrderedEvent& event) noexcept;
+
+    /**
+     * Run all events of a partition in the current window.
+     */
+    void run_window(int partition) noexcept;
+
+    /**
+     * Move events other partitions scheduled on this partition to its heap.
+     */
+    void deliver_events(int partition) noexcept;
+
+    /**
+     * Assign serial positions to the events run in the current window.
+     */
+    void merge_executed() noexcept;
+
+    /**
+     * Pick the next window and drop positions no pending event refers to.
+     */
+    void advance_window() noexcept;
+
+    /**
+     * Wait until every worker arrives. The last worker to arrive runs
+     * on_complete before the others are released.
+     */
+    void barrier(const std::function<void()>& on_complete) noexcept;
+
+    /**
+     * Worker loop of a partition.
+     */
+    void work(int partition,
+              const std::function<void(int)>& on_worker_start) noexcept;
+};
+
+}  // namespace AstraSimAnalytical
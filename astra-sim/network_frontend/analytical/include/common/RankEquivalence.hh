@@ -0,0 +1,141 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include <astra-network-analytical/common/NetworkParser.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace AstraSimAnalytical {
+
+/**
+ * RankEquivalence groups ranks into equivalence classes for the
+ * representative-rank (symmetric collapsing) mode.
+ *
+ * Two ranks are equivalent if their execution traces are byte-identical.
+ * Every building block of the analytical topologies (Ring, FullyConnected,
+ * Switch) is vertex-transitive, so every NPU has a symmetric position in the
+ * multi-dimensional topology and the ET content alone decides the class.
+ *
+ * Only the lowest rank of each class (its representative) is simulated.
+ * A message from a representative to a collapsed peer is answered by the
+ * mirrored message the peer on the opposite side would have sent to the
+ * representative at the same time (see get_mirror_peer). This only holds
+ * for collectives whose peers are at fixed offsets from every rank (ring and
+ * direct), which check_collapsible enforces before any rank is collapsed.
+ */
+class RankEquivalence {
+  public:
+    /**
+     * Check that the system and network configurations allow collapsing
+     * symmetric ranks. Terminates the simulation if a collective is not ring
+     * or direct (e.g., halving-doubling peers are XOR-ed, not mirrored), or
+     * if a network dimension is not a Ring, FullyConnected or Switch with a
+     * single NPU count, bandwidth and latency.
+     *
+     * @param system_configuration system configuration filename
+     * @param network_parser parsed network configuration
+     */
+    static void check_collapsible(
+        const std::string& system_configuration,
+        const NetworkAnalytical::NetworkParser& network_parser) noexcept;
+
+    /**
+     * Constructor. Hashes the execution trace of every rank and builds the
+     * equivalence classes.
+     *
+     * @param workload_configuration ET filename prefix
+     * @param npus_count_per_dim number of NPUs per each network dimension
+     */
+    RankEquivalence(const std::string& workload_configuration,
+                    std::vector<int> npus_count_per_dim) noexcept;
+
+    /**
+     * Check whether the given rank is simulated (i.e., a representative).
+     *
+     * @param rank rank to check
+     * @return true if the rank is simulated
+     */
+    [[nodiscard]] bool is_simulated(int rank) const noexcept;
+
+    /**
+     * Get the class id of the given rank.
+     *
+     * @param rank rank to query
+     * @return class id of the rank
+     */
+    [[nodiscard]] int get_class_id(int rank) const noexcept;
+
+    /**
+     * Get the representative ranks, one per class, in ascending order.
+     *
+     * @return representative ranks
+     */
+    [[nodiscard]] const std::vector<int>& get_representatives() const noexcept;
+
+    /**
+     * Get the peer whose message to src mirrors the message src sends to dst,
+     * i.e., the rank at -(dst - src) from src in every network dimension.
+     * Terminates the simulation if dst or the mirrored peer is not in the
+     * class of src, as the workload is then not symmetric.
+     *
+     * @param src representative rank sending the message
+     * @param dst collapsed destination rank
+     * @return mirrored peer rank
+     */
+    [[nodiscard]] int get_mirror_peer(int src, int dst) const noexcept;
+
+    /**
+     * Record the finish time of a representative.
+     *
+     * @param rank representative rank
+     * @param finish_time finish time in ns
+     */
+    void set_finish_time(int rank, uint64_t finish_time) noexcept;
+
+    /**
+     * Log per-class results. Returns false if any representative did not
+     * finish, which happens when a representative waits for a message from a
+     * collapsed rank of another class.
+     *
+     * @return true if every class finished
+     */
+    bool report() const noexcept;
+
+  private:
+    /// one equivalence class of ranks
+    struct RankClass {
+        /// FNV-1a hash of the execution trace
+        uint64_t et_hash;
+
+        /// simulated rank
+        int representative;
+
+        /// number of ranks in the class
+        int ranks_count;
+
+        /// finish time of the representative in ns
+        uint64_t finish_time;
+
+        /// whether the representative has finished
+        bool finished;
+    };
+
+    /// number of NPUs per each network dimension
+    std::vector<int> npus_count_per_dim;
+
+    /// class id of each rank
+    std::vector<int> class_of_rank;
+
+    /// equivalence classes
+    std::vector<RankClass> classes;
+
+    /// representative of each class
+    std::vector<int> representatives;
+};
+
+}  // namespace AstraSimAnalytical
@@ -6,6 +6,7 @@ LICENSE file in the root directory of this source tree.
 #pragma once
 
 #include "common/CommonNetworkApi.hh"
+#include "congestion_aware/RouteCache.hh"
 #include <astra-network-analytical/congestion_aware/Topology.h>
 
 using namespace AstraSim;
@@ -31,6 +32,11 @@ class CongestionAwareNetworkApi final : public CommonNetworkApi {
      */
     explicit CongestionAwareNetworkApi(int rank) noexcept;
 
+    /**
+     * Log the end-of-run counters of the route cache.
+     */
+    static void report_route_cache() noexcept;
+
     /**
      * Implement sim_send of AstraNetworkAPI.
      */
@@ -43,9 +49,27 @@ class CongestionAwareNetworkApi final : public CommonNetworkApi {
                  void (*msg_handler)(void* fun_arg),
                  void* fun_arg) override;
 
+    /**
+     * Implement sim_send_batch of AstraNetworkAPI.
+     */
+    int sim_send_batch(std::vector<BatchMessage>& messages) override;
+
   private:
     /// topology
     static std::shared_ptr<Topology> topology;
+
+    /// routes of the topology, computed once per (src, dest) pair
+    static std::unique_ptr<RouteCache> route_cache;
+
+    /**
+     * Register the send callback of a chunk and inject it into the network.
+     */
+    void send_chunk(int src,
+                    int dst,
+                    uint64_t count,
+                    int tag,
+                    void (*msg_handler)(void* fun_arg),
+                    void* fun_arg) noexcept;
 };
 
 }  // namespace AstraSimAnalyticalCongestionAware
@@ -0,0 +1,65 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include <astra-network-analytical/congestion_aware/Topology.h>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+namespace AstraSimAnalyticalCongestionAware {
+
+/**
+ * RouteCache memoizes Topology::route() per (src, dest) pair.
+ *
+ * Routes of the analytical topologies are static, so each pair is routed
+ * once and the resulting route is shared, immutable, by every later chunk
+ * between the same pair.
+ */
+class RouteCache {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param topology topology to route on
+     */
+    explicit RouteCache(std::shared_ptr<Topology> topology) noexcept;
+
+    /**
+     * Get the route from src to dest, routing the pair on first use.
+     *
+     * @param src src NPU ID
+     * @param dest dest NPU ID
+     * @return route from src to dest
+     */
+    [[nodiscard]] const Route& get_route(DeviceId src, DeviceId dest) noexcept;
+
+    /**
+     * Log the number of cached routes and the hit rate of the cache.
+     */
+    void report() const noexcept;
+
+  private:
+    /// topology to route on
+    std::shared_ptr<Topology> topology;
+
+    /// number of NPUs of the topology
+    int npus_count;
+
+    /// map from (src * npus_count + dest) to the route of the pair
+    std::unordered_map<uint64_t, std::shared_ptr<const Route>> routes;
+
+    /// number of get_route() calls
+    uint64_t lookups;
+
+    /// number of get_route() calls served from the cache
+    uint64_t hits;
+};
+
+}  // namespace AstraSimAnalyticalCongestionAware
@@ -6,6 +6,9 @@ LICENSE file in the root directory of this source tree.
 #pragma once
 
 #include "common/CommonNetworkApi.hh"
+#include "common/PartitionedEventQueue.hh"
+#include "common/RankEquivalence.hh"
+#include "congestion_unaware/LatencyMemo.hh"
 #include <astra-network-analytical/common/Type.h>
 #include <astra-network-analytical/congestion_unaware/Topology.h>
 #include <vector>
@@ -30,6 +33,54 @@ class CongestionUnawareNetworkApi final : public CommonNetworkApi {
      */
     static void set_topology(std::shared_ptr<Topology> topology_ptr) noexcept;
 
+    /**
+     * Enable the representative-rank mode: messages to collapsed ranks are
+     * mirrored back to the sender instead of being delivered.
+     *
+     * @param rank_equivalence_ptr pointer to the rank equivalence classes
+     */
+    static void set_rank_equivalence(
+        std::shared_ptr<RankEquivalence> rank_equivalence_ptr) noexcept;
+
+    /**
+     * Run ranks in parallel on the given partitioned event queue instead of
+     * the serial event queue. Ranks are split into contiguous blocks, one per
+     * partition, and each partition gets its own callback tracker and chunk
+     * id generator.
+     *
+     * @param partitioned_event_queue_ptr pointer to the partitioned queue
+     * @param npus_count number of NPUs
+     */
+    static void set_partitioned_event_queue(
+        std::shared_ptr<PartitionedEventQueue> partitioned_event_queue_ptr,
+        int npus_count) noexcept;
+
+    /**
+     * Compute the lookahead of the topology: the minimum delay of a message
+     * between two different NPUs.
+     *
+     * @param topology_ptr pointer to the topology
+     * @return lookahead in ns
+     */
+    static EventTime compute_lookahead(
+        const std::shared_ptr<Topology>& topology_ptr) noexcept;
+
+    /**
+     * Get the partition a rank belongs to.
+     *
+     * @param rank rank to query
+     * @return partition of the rank
+     */
+    static int get_partition(int rank) noexcept;
+
+    /**
+     * Log the size and hit rate of the callback trackers, chunk id
+     * generators and latency memos, summed over all partitions.
+     * Partition generators never reclaim entries: the send and recv ids of a
+     * tuple may be numbered on different partitions.
+     */
+    static void report_matching_stats() noexcept;
+
     /**
      * Constructor.
      *
@@ -49,9 +100,153 @@ class CongestionUnawareNetworkApi final : public CommonNetworkApi {
                  void (*msg_handler)(void* fun_arg),
                  void* fun_arg) override;
 
+    /**
+     * Implement sim_recv of AstraNetworkAPI.
+     */
+    int sim_recv(void* buffer,
+                 uint64_t count,
+                 int type,
+                 int src,
+                 int tag,
+                 sim_request* request,
+                 void (*msg_handler)(void* fun_arg),
+                 void* fun_arg) override;
+
+    /**
+     * Implement sim_send_batch of AstraNetworkAPI.
+     */
+    int sim_send_batch(std::vector<BatchMessage>& messages) override;
+
+    /**
+     * Implement sim_recv_batch of AstraNetworkAPI.
+     */
+    int sim_recv_batch(std::vector<BatchMessage>& messages) override;
+
+    /**
+     * Implement sim_get_time of AstraNetworkAPI.
+     */
+    [[nodiscard]] timespec_t sim_get_time() override;
+
+    /**
+     * Implement sim_get_tick of AstraNetworkAPI.
+     */
+    [[nodiscard]] Tick sim_get_tick() override;
+
+    /**
+     * Implement sim_schedule of AstraNetworkAPI.
+     */
+    void sim_schedule(timespec_t delta,
+                      void (*fun_ptr)(void* fun_arg),
+                      void* fun_arg) override;
+
+    /**
+     * Implement sim_notify_finished of AstraNetworkAPI.
+     */
+    void sim_notify_finished() override;
+
+    /**
+     * Implement get_send_delay of AstraNetworkAPI.
+     *
+     * @param src src NPU ID
+     * @param dst dst NPU ID
+     * @param count message size
+     * @return delay of the message in ns, or -1 if some ranks are not
+     *         simulated by this thread
+     */
+    double get_send_delay(int src, int dst, uint64_t count) override;
+
   private:
     /// topology
     static std::shared_ptr<Topology> topology;
+
+    /// rank equivalence classes (nullptr if every rank is simulated)
+    static std::shared_ptr<RankEquivalence> rank_equivalence;
+
+    /// partitioned event queue (nullptr for serial simulation)
+    static std::shared_ptr<PartitionedEventQueue> partitioned_event_queue;
+
+    /// number of NPUs, to map ranks to partitions
+    static int npus_count;
+
+    /// callback tracker of each partition, owned by the receiving side
+    static std::vector<CallbackTracker> partition_callback_trackers;
+
+    /// chunk id generator of each partition
+    static std::vector<ChunkIdGenerator> partition_chunk_id_generators;
+
+    /// latency memo of each partition (a single one for serial simulation)
+    static std::vector<LatencyMemo> latency_memos;
+
+    /// partition of this rank
+    int partition;
+
+    /**
+     * Get the latency of a message from the latency memo of this partition.
+     *
+     * @param src src NPU ID
+     * @param dst dst NPU ID
+     * @param count message size
+     * @return latency of the message in ns
+     */
+    [[nodiscard]] EventTime get_latency(int src,
+                                        int dst,
+                                        uint64_t count) noexcept;
+
+    /**
+     * Send a chunk from this rank, dispatching on the simulation mode.
+     */
+    int send_chunk(int src,
+                   int dst,
+                   uint64_t count,
+                   int tag,
+                   void (*msg_handler)(void* fun_arg),
+                   void* fun_arg);
+
+    /**
+     * Implement sim_send on the partitioned event queue: the send completes
+     * on the source partition and the chunk arrives on the destination
+     * partition, as the two halves of one event.
+     */
+    int partitioned_send(int src,
+                         int dst,
+                         uint64_t count,
+                         int tag,
+                         void (*msg_handler)(void* fun_arg),
+                         void* fun_arg);
+
+    /**
+     * Implement sim_recv on the partitioned event queue.
+     */
+    int partitioned_recv(int src,
+                         int dst,
+                         uint64_t count,
+                         int tag,
+                         void (*msg_handler)(void* fun_arg),
+                         void* fun_arg);
+
+    /**
+     * Receiving half of a chunk arrival on the partitioned event queue.
+     *
+     * @param args ChunkArrivalArg of the chunk
+     */
+    static void process_partitioned_chunk_arrival(void* args) noexcept;
+
+    /**
+     * Send a message to a collapsed rank: complete the send after the
+     * communication delay, and deliver the message the mirrored peer would
+     * have sent to this rank at the same time.
+     */
+    void send_to_collapsed_rank(int src,
+                                int dst,
+                                uint64_t count,
+                                int tag,
+                                void (*msg_handler)(void* fun_arg),
+                                void* fun_arg);
+
+    /**
+     * Send callback of mirrored messages, whose sender is not simulated.
+     */
+    static void ignore_mirrored_send(void* args) noexcept;
 };
 
 }  // namespace AstraSimAnalyticalCongestionUnaware
@@ -0,0 +1,77 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/ChunkHashTable.hh"
+#include <astra-network-analytical/common/Type.h>
+#include <astra-network-analytical/congestion_unaware/Topology.h>
+#include <memory>
+#include <vector>
+
+using namespace AstraSimAnalytical;
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionUnaware;
+
+namespace AstraSimAnalyticalCongestionUnaware {
+
+/**
+ * LatencyMemo memoizes Topology::send() per (offset, chunk size).
+ *
+ * The offset of a message is dest - src in every network dimension, folded
+ * into a single relative rank. Every building block of the analytical
+ * topologies (Ring, FullyConnected, Switch) is vertex-transitive, so the
+ * latency of a message only depends on its offset and size, and the few
+ * sizes of a workload are computed once per offset.
+ */
+class LatencyMemo {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param topology topology to compute latencies on
+     */
+    explicit LatencyMemo(std::shared_ptr<Topology> topology) noexcept;
+
+    /**
+     * Get the latency of a message, computing it on first use.
+     *
+     * @param src src NPU ID
+     * @param dest dest NPU ID
+     * @param chunk_size size of the message
+     * @return latency of the message in ns
+     */
+    [[nodiscard]] EventTime get_latency(DeviceId src,
+                                        DeviceId dest,
+                                        ChunkSize chunk_size) noexcept;
+
+    /**
+     * Get the counters of the memo table.
+     *
+     * @return counters of the memo table
+     */
+    [[nodiscard]] ChunkHashTableStats get_stats() const noexcept;
+
+  private:
+    /**
+     * Fold dest - src of every network dimension into a relative rank.
+     *
+     * @param src src NPU ID
+     * @param dest dest NPU ID
+     * @return relative rank of dest as seen from src
+     */
+    [[nodiscard]] int get_offset(DeviceId src, DeviceId dest) const noexcept;
+
+    /// topology to compute latencies on
+    std::shared_ptr<Topology> topology;
+
+    /// number of NPUs per each network dimension
+    std::vector<int> npus_count_per_dim;
+
+    /// latency per (offset, chunk size)
+    ChunkHashTable<EventTime> latencies;
+};
+
+}  // namespace AstraSimAnalyticalCongestionUnaware
@@ -0,0 +1,101 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/ChunkHashTable.hh"
+#include <astra-network-analytical/common/Type.h>
+#include <astra-network-analytical/congestion_unaware/Topology.h>
+#include <astra-sim/system/NetworkTrace.hh>
+#include <memory>
+#include <utility>
+#include <vector>
+
+using namespace AstraSim;
+using namespace AstraSimAnalytical;
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionUnaware;
+
+namespace AstraSimAnalyticalReplay {
+
+/**
+ * ReplayLatencyModel serves message latencies from a recorded network trace.
+ *
+ * A message is looked up in three steps:
+ *   1. the n-th send of a (tag, src, dest, size) tuple gets the latency of
+ *      the n-th recorded one (in issue order), the last one if it ran out,
+ *   2. otherwise the latency is interpolated by size between the recorded
+ *      messages of the same (src, dest) pair,
+ *   3. otherwise the congestion_unaware topology computes the latency.
+ */
+class ReplayLatencyModel {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param records messages of the network trace
+     * @param fallback topology used for messages missing from the trace
+     */
+    ReplayLatencyModel(std::vector<NetworkTraceRecord> records,
+                       std::shared_ptr<Topology> fallback) noexcept;
+
+    /**
+     * Get the latency of a message.
+     *
+     * @param tag tag of the message
+     * @param src src NPU ID of the message
+     * @param dest dest NPU ID of the message
+     * @param size size of the message
+     * @return latency of the message in ns
+     */
+    [[nodiscard]] EventTime get_latency(int tag,
+                                        int src,
+                                        int dest,
+                                        ChunkSize size) noexcept;
+
+    /**
+     * Log how many messages were served by each step.
+     */
+    void report() const noexcept;
+
+  private:
+    /// recorded latencies of a (tag, src, dest, size) tuple, in issue order
+    struct Occurrences {
+        std::vector<EventTime> latencies;
+        size_t next = 0;
+    };
+
+    /// (size, mean latency) of a (src, dest) pair, sorted by size
+    using SizeSamples = std::vector<std::pair<ChunkSize, double>>;
+
+    /**
+     * Interpolate the latency of a size between recorded samples.
+     *
+     * @param samples recorded samples of the (src, dest) pair
+     * @param size size of the message
+     * @return interpolated latency in ns
+     */
+    [[nodiscard]] static EventTime interpolate(const SizeSamples& samples,
+                                               ChunkSize size) noexcept;
+
+    /// latencies per (tag, src, dest, size)
+    ChunkHashTable<Occurrences> exact;
+
+    /// samples per (src, dest)
+    ChunkHashTable<SizeSamples> by_pair;
+
+    /// topology for messages missing from the trace
+    std::shared_ptr<Topology> fallback;
+
+    /// number of messages in the trace
+    uint64_t records_count;
+
+    /// number of messages served by each step
+    uint64_t exact_count;
+    uint64_t interpolated_count;
+    uint64_t fallback_count;
+};
+
+}  // namespace AstraSimAnalyticalReplay
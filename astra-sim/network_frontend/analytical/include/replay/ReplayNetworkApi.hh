@@ -0,0 +1,66 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/CommonNetworkApi.hh"
+#include "replay/ReplayLatencyModel.hh"
+#include <astra-network-analytical/common/Type.h>
+#include <astra-network-analytical/congestion_unaware/Topology.h>
+#include <memory>
+
+using namespace AstraSim;
+using namespace AstraSimAnalytical;
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionUnaware;
+
+namespace AstraSimAnalyticalReplay {
+
+/**
+ * ReplayNetworkApi is a AstraNetworkAPI that serves message latencies
+ * from a recorded network trace instead of simulating the network.
+ */
+class ReplayNetworkApi final : public CommonNetworkApi {
+  public:
+    /**
+     * Set the topology, used for the bandwidth of each dimension.
+     *
+     * @param topology_ptr pointer to the topology
+     */
+    static void set_topology(std::shared_ptr<Topology> topology_ptr) noexcept;
+
+    /**
+     * Set the latency model to be used.
+     *
+     * @param latency_model_ptr pointer to the latency model
+     */
+    static void set_latency_model(
+        std::shared_ptr<ReplayLatencyModel> latency_model_ptr) noexcept;
+
+    /**
+     * Constructor.
+     *
+     * @param rank id of the API
+     */
+    explicit ReplayNetworkApi(int rank) noexcept;
+
+    /**
+     * Implement sim_send of AstraNetworkAPI.
+     */
+    int sim_send(void* buffer,
+                 uint64_t count,
+                 int type,
+                 int dst,
+                 int tag,
+                 sim_request* request,
+                 void (*msg_handler)(void* fun_arg),
+                 void* fun_arg) override;
+
+  private:
+    /// latency model
+    static std::shared_ptr<ReplayLatencyModel> latency_model;
+};
+
+}  // namespace AstraSimAnalyticalReplay
@@ -0,0 +1,114 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "replay/ReplayLatencyModel.hh"
+#include <algorithm>
+#include <astra-sim/common/Logging.hh>
+#include <cassert>
+#include <map>
+
+using namespace AstraSimAnalyticalReplay;
+
+ReplayLatencyModel::ReplayLatencyModel(
+    std::vector<NetworkTraceRecord> records,
+    std::shared_ptr<Topology> fallback) noexcept
+    : fallback(std::move(fallback)),
+      records_count(records.size()),
+      exact_count(0),
+      interpolated_count(0),
+      fallback_count(0) {
+    assert(this->fallback != nullptr);
+
+    // records are written on completion, replay them in issue order
+    std::stable_sort(records.begin(), records.end(),
+                     [](const auto& a, const auto& b) {
+                         return a.issue_tick < b.issue_tick;
+                     });
+
+    // (src, dest) -> size -> (latency sum, count)
+    auto sums = std::map<std::pair<int, int>,
+                         std::map<ChunkSize, std::pair<double, uint64_t>>>();
+
+    for (const auto& record : records) {
+        const auto key = ChunkKey(record.tag, record.src, record.dst,
+                                  record.size);
+        auto* occurrences = exact.find(key);
+        if (occurrences == nullptr) {
+            occurrences = exact.insert(key);
+        }
+        occurrences->latencies.push_back(record.latency_ns);
+
+        auto& sum = sums[{record.src, record.dst}][record.size];
+        sum.first += static_cast<double>(record.latency_ns);
+        sum.second++;
+    }
+
+    for (const auto& [pair, sizes] : sums) {
+        auto* const samples =
+            by_pair.insert(ChunkKey(0, pair.first, pair.second, 0));
+        for (const auto& [size, sum] : sizes) {
+            samples->emplace_back(size, sum.first / sum.second);
+        }
+    }
+}
+
+EventTime ReplayLatencyModel::get_latency(const int tag,
+                                          const int src,
+                                          const int dest,
+                                          const ChunkSize size) noexcept {
+    // 1. same message in the trace
+    auto* const occurrences = exact.find(ChunkKey(tag, src, dest, size));
+    if (occurrences != nullptr) {
+        exact_count++;
+        const auto index =
+            std::min(occurrences->next, occurrences->latencies.size() - 1);
+        occurrences->next++;
+        return occurrences->latencies[index];
+    }
+
+    // 2. other sizes between the same pair
+    const auto* const samples = by_pair.find(ChunkKey(0, src, dest, 0));
+    if (samples != nullptr && samples->size() >= 2) {
+        interpolated_count++;
+        return interpolate(*samples, size);
+    }
+
+    // 3. analytical model
+    fallback_count++;
+    return fallback->send(src, dest, size);
+}
+
+EventTime ReplayLatencyModel::interpolate(const SizeSamples& samples,
+                                          const ChunkSize size) noexcept {
+    assert(samples.size() >= 2);
+
+    // segment around the size, or the closest one outside the samples
+    auto upper = std::lower_bound(
+        samples.begin(), samples.end(), size,
+        [](const auto& sample, const auto value) {
+            return sample.first < value;
+        });
+    if (upper == samples.begin()) {
+        upper++;
+    } else if (upper == samples.end()) {
+        upper--;
+    }
+    const auto lower = upper - 1;
+
+    const auto [x0, y0] = *lower;
+    const auto [x1, y1] = *upper;
+    const auto slope = (y1 - y0) / static_cast<double>(x1 - x0);
+    const auto latency =
+        y0 + slope * (static_cast<double>(size) - static_cast<double>(x0));
+
+    return latency > 0 ? static_cast<EventTime>(latency + 0.5) : 0;
+}
+
+void ReplayLatencyModel::report() const noexcept {
+    AstraSim::LoggerFactory::get_logger("network")->info(
+        "network replay: {} messages in trace, {} replayed, {} interpolated, "
+        "{} from the analytical model",
+        records_count, exact_count, interpolated_count, fallback_count);
+}
@@ -0,0 +1,56 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "replay/ReplayNetworkApi.hh"
+#include <cassert>
+
+using namespace AstraSim;
+using namespace AstraSimAnalytical;
+using namespace AstraSimAnalyticalReplay;
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionUnaware;
+
+std::shared_ptr<ReplayLatencyModel> ReplayNetworkApi::latency_model = nullptr;
+
+void ReplayNetworkApi::set_topology(
+    std::shared_ptr<Topology> topology_ptr) noexcept {
+    assert(topology_ptr != nullptr);
+
+    // set topology-related values
+    ReplayNetworkApi::dims_count = topology_ptr->get_dims_count();
+    ReplayNetworkApi::bandwidth_per_dim = topology_ptr->get_bandwidth_per_dim();
+}
+
+void ReplayNetworkApi::set_latency_model(
+    std::shared_ptr<ReplayLatencyModel> latency_model_ptr) noexcept {
+    assert(latency_model_ptr != nullptr);
+
+    ReplayNetworkApi::latency_model = std::move(latency_model_ptr);
+}
+
+ReplayNetworkApi::ReplayNetworkApi(const int rank) noexcept
+    : CommonNetworkApi(rank) {
+    assert(rank >= 0);
+}
+
+int ReplayNetworkApi::sim_send(void* const buffer,
+                               const uint64_t count,
+                               const int type,
+                               const int dst,
+                               const int tag,
+                               sim_request* const request,
+                               void (*msg_handler)(void*),
+                               void* const fun_arg) {
+    assert(latency_model != nullptr);
+
+    // the chunk arrives after the recorded latency
+    const auto src = sim_comm_get_rank();
+    const auto latency_ns = latency_model->get_latency(tag, src, dst, count);
+    send_chunk_with_delay(src, dst, count, tag, msg_handler, fun_arg,
+                          latency_ns);
+
+    // return
+    return 0;
+}
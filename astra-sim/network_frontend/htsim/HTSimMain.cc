@@ -5,12 +5,15 @@ LICENSE file in the root directory of this source tree.
 
 #include "HTSimNetworkApi.hh"
 #include "astra-sim/common/Logging.hh"
+#include "astra-sim/workload/WorkloadLoader.hh"
 #include "common/CmdLineParser.hh"
 #include "HTSimSession.hh"
+#include "HybridNetworkApi.hh"
 #include <astra-network-analytical/common/EventQueue.h>
 #include <astra-network-analytical/common/NetworkParser.h>
 #include <astra-network-analytical/congestion_unaware/Helper.h>
 #include <remote_memory_backend/analytical/AnalyticalRemoteMemory.hh>
+#include <algorithm>
 
 using namespace HTSim;
 
@@ -19,7 +22,9 @@ int main(int argc, char* argv[]) {
     auto cmd_line_parser = CmdLineParser(argv[0]);
     cmd_line_parser.get_options().add_options()(
         "htsim-proto", "HTSim Network Protocol [tcp]",
-        cxxopts::value<HTSimProto>()->default_value("tcp"));
+        cxxopts::value<HTSimProto>()->default_value("tcp"))(
+        "htsim-verbose", "Report every flow sent to HTSim",
+        cxxopts::value<bool>()->default_value("false"));
     cmd_line_parser.parse(argc, argv);
 
     // Get command line arguments
@@ -35,7 +40,9 @@ int main(int argc, char* argv[]) {
     const auto comm_scale = cmd_line_parser.get<double>("comm-scale");
     const auto injection_scale = cmd_line_parser.get<double>("injection-scale");
     const auto rendezvous_protocol = cmd_line_parser.get<bool>("rendezvous-protocol");
+    const auto workload_cache = cmd_line_parser.get<std::string>("workload-cache");
     const auto proto = cmd_line_parser.get<HTSimProto>("htsim-proto");
+    HTSimSession::conf.verbose = cmd_line_parser.get<bool>("htsim-verbose");
 
     AstraSim::LoggerFactory::init(logging_configuration);
 
@@ -49,12 +56,20 @@ int main(int argc, char* argv[]) {
     const auto dims_count = topology->get_dims_count();
 
     // Set up Network API
-    HTSimNetworkApi::set_topology(topology);
+    // Dimensions marked analytical in the network configuration skip HTSim.
+    auto analytical_dims = HybridNetworkApi::parse_analytical_dims(network_configuration, dims_count);
+    const auto hybrid = std::find(analytical_dims.begin(), analytical_dims.end(), true) !=
+                        analytical_dims.end();
+    if (hybrid) {
+        HybridNetworkApi::set_topology(topology, std::move(analytical_dims));
+    } else {
+        HTSimNetworkApi::set_topology(topology);
+    }
     auto completion_tracker = std::make_shared<CompletionTracker>(npus_count);
     HTSimNetworkApi::set_completion_tracker(completion_tracker);
 
     // Create ASTRA-sim related resources
-    auto network_apis = std::vector<std::unique_ptr<HTSimNetworkApi>>();
+    auto network_apis = std::vector<std::unique_ptr<AstraNetworkAPI>>();
     const auto memory_api =
         std::make_unique<Analytical::AnalyticalRemoteMemory>(remote_memory_configuration);
     auto systems = std::vector<Sys*>();
@@ -64,9 +79,18 @@ int main(int argc, char* argv[]) {
         queues_per_dim.push_back(num_queues_per_dim);
     }
 
+    // Parse the execution traces of all ranks ahead of Sys
+    auto ranks = std::vector<int>();
+    for (int i = 0; i < npus_count; i++) {
+        ranks.push_back(i);
+    }
+    WorkloadLoader::set_cache_dir(workload_cache);
+    WorkloadLoader::preload(workload_configuration, ranks);
+
     for (int i = 0; i < npus_count; i++) {
         // create network and system
-        auto network_api = std::make_unique<HTSimNetworkApi>(i);
+        auto network_api = hybrid ? std::unique_ptr<AstraNetworkAPI>(new HybridNetworkApi(i))
+                                  : std::unique_ptr<AstraNetworkAPI>(new HTSimNetworkApi(i));
         auto* const system =
             new Sys(i, workload_configuration, comm_group_configuration, system_configuration,
                     memory_api.get(), network_api.get(), npus_count_per_dim, queues_per_dim,
@@ -76,6 +100,7 @@ int main(int argc, char* argv[]) {
         network_apis.push_back(std::move(network_api));
         systems.push_back(system);
     }
+    WorkloadLoader::check_streaming(systems);
 
     // Get HTSim opts
     int htsim_argc = 0;
@@ -67,6 +67,11 @@ AstraSim::timespec_t HTSimNetworkApi::sim_get_time() {
     return timeSpec;
 }
 
+AstraSim::Tick HTSimNetworkApi::sim_get_tick() {
+    auto& htsim_session = HTSimSession::instance();
+    return htsim_session.get_time_ps() / 1000 / AstraSim::CLOCK_PERIOD;
+}
+
 int HTSimNetworkApi::sim_send(void* const buffer,
                               const uint64_t count,
                               const int type,
@@ -105,47 +110,11 @@ int HTSimNetworkApi::sim_recv(void* const buffer,
                               sim_request* const request,
                               void (*msg_handler)(void*),
                               void* const fun_arg) {
-    // query chunk id
+    // Wait for the bytes HTSim has simulated arriving, or call the handler
+    // right away if they already arrived.
     const auto dst = sim_comm_get_rank();
-    auto recv_event = MsgEvent(src, dst, Dir::Receive, message_size, fun_arg, msg_handler);
-    MsgEventKey recv_event_key =
-        std::make_pair(tag, std::make_pair(recv_event.src_id, recv_event.dst_id));
-    if (HTSimSession::msg_standby.find(recv_event_key) !=
-        HTSimSession::msg_standby.end()) {
-        // HTSim received the message before sim_recv was called.
-        int received_msg_bytes = HTSimSession::msg_standby[recv_event_key];
-        if (received_msg_bytes == message_size) {
-            // Message matches what we expected.
-            HTSimSession::msg_standby.erase(recv_event_key);
-            recv_event.callHandler();
-        } else if (received_msg_bytes >= message_size) {
-            // Node received more than it expected.
-            // This can happen if the message is split into multiple chunks as part of
-            // one collective phase, for example in Ring.
-            HTSimSession::msg_standby[recv_event_key] -= message_size;
-            recv_event.callHandler();
-        } else {
-            // Node received less than it expected.
-            // Reduce the number of bytes we are waiting to receive.
-            HTSimSession::msg_standby.erase(recv_event_key);
-            recv_event.remaining_msg_bytes -= received_msg_bytes;
-            HTSimSession::recv_waiting[recv_event_key] = recv_event;
-        }
-    } else {
-        // HTSim has not yet received anything.
-        if (HTSimSession::recv_waiting.find(recv_event_key) ==
-            HTSimSession::recv_waiting.end()) {
-            // We have not been expecting anything.
-            HTSimSession::recv_waiting[recv_event_key] = recv_event;
-        } else {
-            // We have already been expecting something.
-            //Increment the number of bytes we are waiting to receive.
-            int expecting_msg_bytes =
-                HTSimSession::recv_waiting[recv_event_key].remaining_msg_bytes;
-            recv_event.remaining_msg_bytes += expecting_msg_bytes;
-            HTSimSession::recv_waiting[recv_event_key] = recv_event;
-        }
-    }
+    HTSimSession::recv_matcher.post_recv(make_msg_event_key(tag, src, dst), message_size,
+                                         msg_handler, fun_arg);
     return 0;
 }
 
@@ -71,6 +71,8 @@ class HTSimNetworkApi final : public CommonNetworkApi {
 
     AstraSim::timespec_t sim_get_time() override;
 
+    AstraSim::Tick sim_get_tick() override;
+
     void sim_schedule(timespec_t delta, void (*fun_ptr)(void* fun_arg), void* fun_arg) override;
 
     void sim_notify_finished() override;
@@ -6,12 +6,11 @@
 
 namespace HTSim {
 
-std::map<std::pair<int, HTSim::Dir>, int> HTSimSession::node_bytes_sent;
-std::map<std::pair<HTSim::MsgEventKey, int>, HTSim::MsgEvent>
-    HTSimSession::send_waiting;
-std::map<HTSim::MsgEventKey, HTSim::MsgEvent> HTSimSession::recv_waiting;
-std::map<HTSim::MsgEventKey, int> HTSimSession::msg_standby;
-std::map<int, int> HTSimSession::flow_id_to_tag;
+std::vector<uint64_t> HTSimSession::node_bytes_sent;
+std::vector<uint64_t> HTSimSession::node_bytes_received;
+AstraSim::MessageTable<HTSim::MsgEvent> HTSimSession::send_waiting;
+AstraSim::MessageMatcher HTSimSession::recv_matcher;
+std::vector<int> HTSimSession::flow_id_to_tag;
 HTSimSession* HTSimSession::session = nullptr;
 HTSimConf HTSimSession::conf;
 
@@ -19,7 +18,8 @@ typedef void (*EventHandler)(void*);
 
 class AstraEventSrc : public EventSource {
 public:
-    AstraEventSrc(EventHandler msg_handler, void* fun_arg, EventList& eventList);
+    AstraEventSrc(EventList& eventList);
+    void set_handler(EventHandler msg_handler, void* fun_arg);
     void doNextEvent();
 
 private:
@@ -27,18 +27,30 @@ private:
     void* _fun_arg;
 };
 
-// Event source for scheduling callbacks to be executed by HTSim
-std::vector<AstraEventSrc*> astra_events;
+// Event sources for scheduling callbacks to be executed by HTSim.
+// Every source ever created is owned by astra_events; sources whose event
+// already fired wait in free_astra_events to be reused.
+std::vector<std::unique_ptr<AstraEventSrc>> astra_events;
+std::vector<AstraEventSrc*> free_astra_events;
 
-AstraEventSrc::AstraEventSrc(EventHandler msg_handler,
-                             void* fun_arg,
-                             EventList& eventList)
-    : EventSource(eventList, "astraSimSrc"), _msg_handler(msg_handler), _fun_arg(fun_arg) {
+AstraEventSrc::AstraEventSrc(EventList& eventList)
+    : EventSource(eventList, "astraSimSrc"), _msg_handler(nullptr), _fun_arg(nullptr) {
+}
+
+void AstraEventSrc::set_handler(EventHandler msg_handler, void* fun_arg) {
+    _msg_handler = msg_handler;
+    _fun_arg = fun_arg;
 }
 
 void AstraEventSrc::doNextEvent() {
+    // Release the source before running the handler, which may schedule
+    // new events and reuse it.
+    EventHandler msg_handler = _msg_handler;
+    void* fun_arg = _fun_arg;
+    free_astra_events.push_back(this);
+
     // Run the handler
-    _msg_handler(_fun_arg);
+    msg_handler(fun_arg);
 }
 
 std::stringstream& operator>> (std::stringstream& is, HTSimProto& proto) {
@@ -58,14 +70,19 @@ void HTSimSession::send_flow(FlowInfo flow,
                             int flow_id,
                             void (*msg_handler)(void* fun_arg),
                             void* fun_arg) {
+    if (conf.verbose) {
+        std::cout << "Send flow " << flow_id << " from " << flow.src << " to " << flow.dst
+                  << " with size " << flow.size << "\n";
+    }
+
     // Create a MsgEvent instance and register callback function.
-    std::cout << "Send flow " << flow_id << " from " << flow.src << " to " << flow.dst
-              << " with size " << flow.size << "\n";
     MsgEvent send_event = MsgEvent(flow.src, flow.dst, Dir::Send, flow.size, fun_arg, msg_handler);
+    if (flow_id_to_tag.size() <= (size_t)flow_id) {
+        flow_id_to_tag.resize(flow_id + 1);
+    }
     flow_id_to_tag[flow_id] = flow.tag;
-    std::pair<MsgEventKey, int> send_event_key = std::make_pair(
-        std::make_pair(flow.tag, std::make_pair(send_event.src_id, send_event.dst_id)), flow_id);
-    HTSimSession::send_waiting[send_event_key] = send_event;
+    MsgEventKey send_event_key = make_msg_event_key(flow.tag, flow.src, flow.dst, flow_id);
+    *HTSimSession::send_waiting.insert(send_event_key) = send_event;
 
     // Create a queue pair and schedule within the HTSim simulator.
     impl->schedule_htsim_event(flow, flow_id);
@@ -82,50 +99,12 @@ void HTSimSession::notify_receiver_receive_data(int src_id,
                                                 int message_size,
                                                 int tag,
                                                 int flow_id) {
-    MsgEventKey recv_expect_event_key = make_pair(tag, make_pair(src_id, dst_id));
-
-    if (HTSimSession::recv_waiting.find(recv_expect_event_key) !=
-        HTSimSession::recv_waiting.end()) {
-        // The Sys object is waiting for packets to arrive.
-        MsgEvent recv_expect_event = recv_waiting[recv_expect_event_key];
-        if (message_size == recv_expect_event.remaining_msg_bytes) {
-            // We received exactly the amount of data what Sys object was expecting.
-            HTSimSession::recv_waiting.erase(recv_expect_event_key);
-            recv_expect_event.callHandler();
-        } else if (message_size > recv_expect_event.remaining_msg_bytes) {
-            // We received more packets than the Sys object is expecting.
-            // Place task in received_msg_standby_hash and wait for Sys object to issue more sim_recv
-            // calls. Call callback handler for the amount Sys object was waiting for.
-            HTSimSession::msg_standby[recv_expect_event_key] = message_size - recv_expect_event.remaining_msg_bytes;
-            HTSimSession::recv_waiting.erase(recv_expect_event_key);
-            recv_expect_event.callHandler();
-        } else {
-            // There are still packets to arrive.
-            // Reduce the number of packets we are waiting for. Do not call callback
-            // handler.
-            recv_expect_event.remaining_msg_bytes -= message_size;
-            HTSimSession::recv_waiting[recv_expect_event_key] = recv_expect_event;
-        }
-    } else {
-        // The Sys object is not yet waiting for packets to arrive.
-        if (HTSimSession::msg_standby.find(recv_expect_event_key) ==
-            HTSimSession::msg_standby.end()) {
-            // Place task in msg_standby and wait for Sys object to issue more sim_recv
-            // calls.
-            HTSimSession::msg_standby[recv_expect_event_key] = message_size;
-        } else {
-            // Sys object is still waiting. Add number of bytes we are waiting for.
-            HTSimSession::msg_standby[recv_expect_event_key] += message_size;
-        }
-    }
-
     // Add to the number of total bytes received.
-    if (HTSimSession::node_bytes_sent.find(make_pair(dst_id, Dir::Receive)) ==
-        HTSimSession::node_bytes_sent.end()) {
-        HTSimSession::node_bytes_sent[make_pair(dst_id, Dir::Receive)] = message_size;
-    } else {
-        HTSimSession::node_bytes_sent[make_pair(dst_id, Dir::Receive)] += message_size;
-    }
+    add_node_bytes(dst_id, Dir::Receive, message_size);
+
+    // Call the handlers of the sim_recv calls these bytes complete, or keep
+    // the bytes until sim_recv is called.
+    HTSimSession::recv_matcher.deliver(make_msg_event_key(tag, src_id, dst_id), message_size);
 }
 
 void HTSimSession::notify_sender_sending_finished(int src_id,
@@ -134,9 +113,9 @@ void HTSimSession::notify_sender_sending_finished(int src_id,
                                                   int tag,
                                                   int flow_id) {
     // Lookup the send_event registered at send_flow().
-    std::pair<MsgEventKey, int> send_event_key =
-        make_pair(make_pair(tag, make_pair(src_id, dst_id)), flow_id);
-    if (HTSimSession::send_waiting.find(send_event_key) == HTSimSession::send_waiting.end()) {
+    MsgEventKey send_event_key = make_msg_event_key(tag, src_id, dst_id, flow_id);
+    MsgEvent* send_waiting_event = HTSimSession::send_waiting.find(send_event_key);
+    if (send_waiting_event == nullptr) {
         std::cerr << "Cannot find send_event in sent_hash. Something is wrong."
              << "src_id, dst_id: " << src_id << " " << dst_id << " : " << tag << " - " << flow_id
              << "\n";
@@ -145,19 +124,23 @@ void HTSimSession::notify_sender_sending_finished(int src_id,
 
     // Verify that the (HTSim identified) sent message size matches what was
     // expected by the system layer.
-    MsgEvent send_event = HTSimSession::send_waiting[send_event_key];
+    MsgEvent send_event = *send_waiting_event;
     HTSimSession::send_waiting.erase(send_event_key);
 
     // Add to the number of total bytes sent.
-    if (HTSimSession::node_bytes_sent.find(make_pair(src_id, Dir::Send)) ==
-        HTSimSession::node_bytes_sent.end()) {
-        HTSimSession::node_bytes_sent[make_pair(src_id, Dir::Send)] = message_size;
-    } else {
-        HTSimSession::node_bytes_sent[make_pair(src_id, Dir::Send)] += message_size;
-    }
+    add_node_bytes(src_id, Dir::Send, message_size);
     send_event.callHandler();
 }
 
+void HTSimSession::add_node_bytes(int node_id, HTSim::Dir dir, int bytes) {
+    std::vector<uint64_t>& node_bytes =
+        (dir == Dir::Send) ? node_bytes_sent : node_bytes_received;
+    if (node_bytes.size() <= (size_t)node_id) {
+        node_bytes.resize(node_id + 1, 0);
+    }
+    node_bytes[node_id] += bytes;
+}
+
 // flow_finish is triggered by HTSim to indicate that a flow has finished.
 // Registered as the callback handler for the source
 // instance created at send_flow.
@@ -230,8 +213,15 @@ HTSimSession::HTSimSession(const HTSim::tm_info* const tm, int argc, char** argv
 void HTSimSession::schedule_astra_event(long double when_ns,
                                         void (*msg_handler)(void* fun_arg),
                                         void* fun_arg) {
-    AstraEventSrc* src = new AstraEventSrc(msg_handler, fun_arg, impl->eventlist);
-    astra_events.push_back(src);
+    AstraEventSrc* src;
+    if (free_astra_events.empty()) {
+        astra_events.push_back(std::make_unique<AstraEventSrc>(impl->eventlist));
+        src = astra_events.back().get();
+    } else {
+        src = free_astra_events.back();
+        free_astra_events.pop_back();
+    }
+    src->set_handler(msg_handler, fun_arg);
     impl->eventlist.sourceIsPendingRel(*src, timeFromNs(when_ns));
 }
 
@@ -245,6 +235,10 @@ double HTSimSession::get_time_ns() {
     return timeAsNs(impl->eventlist.now());
 }
 
+simtime_picosec HTSimSession::get_time_ps() {
+    return impl->eventlist.now();
+}
+
 double HTSimSession::get_time_us() {
     return timeAsUs(impl->eventlist.now());
 }
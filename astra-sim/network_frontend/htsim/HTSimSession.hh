@@ -1,5 +1,7 @@
 #pragma once
 
+#include "astra-sim/common/MessageMatcher.hh"
+
 #include <cstdint>
 #include <ios>
 #include <map>
@@ -40,6 +42,8 @@ struct HTSimConf {
     // When this option is true, a flow will be marked as finished for the receiver
     // as soon as the last packet is received instead of waiting for sender to get ack.
     bool recv_flow_finish;
+    // When this option is true, every flow is reported on stdout when it is sent.
+    bool verbose;
 };
 
 class MsgEvent {
@@ -87,8 +91,14 @@ public:
 };
 
 // MsgEventKey is a key to uniquely identify each MsgEvent.
-//  - Pair <Tag, Pair <src_id, dst_id>>
-typedef std::pair<int, std::pair<int, int>> MsgEventKey;
+//  - (tag, src_id, dst_id) packed into a MessageKey. Messages are matched by
+//    their remaining bytes, so the size of the key is always 0.
+//  - The id slot holds the flow id for send events.
+typedef AstraSim::MessageKey MsgEventKey;
+
+inline MsgEventKey make_msg_event_key(int tag, int src_id, int dst_id, int flow_id = 0) {
+    return MsgEventKey(tag, src_id, dst_id, 0, flow_id);
+}
 
 struct tm_info {
     int nodes;
@@ -111,43 +121,35 @@ class HTSimSession {
                        EventHandler msg_handler,
                        void* fun_arg);
         double get_time_ns();
+        simtime_picosec get_time_ps();
         double get_time_us();
         void schedule_astra_event(long double delta, EventHandler msg_handler, void* fun_arg);
 
         // Used to count how many bytes were sent/received by this node.
         // Refer to sim_finish().
-        //   - key: Pair <node_id, send/receive>. Where 'send/receive' indicates if the
-        //   value is for send or receive
-        //   - value: Number of bytes this node has sent (if send/receive is 0) and
-        //   received (if send/receive is 1)
-        static std::map<std::pair<int, HTSim::Dir>, int> node_bytes_sent;
-
-        // SentHash stores a MsgEvent for sim_send events and its callback handler.
-        //   - key: A pair of <MsgEventKey, port_id>.
+        //   - index: node_id
+        //   - value: Number of bytes this node has sent (node_bytes_sent) and
+        //   received (node_bytes_received)
+        static std::vector<uint64_t> node_bytes_sent;
+        static std::vector<uint64_t> node_bytes_received;
+        static void add_node_bytes(int node_id, HTSim::Dir dir, int bytes);
+
+        // send_waiting stores a MsgEvent for sim_send events and its callback handler.
+        //   - key: MsgEventKey of the flow, including its flow id.
         //          A single collective phase can be split into multiple sim_send messages, which all
-        //          have the same MsgEventKey.
-        //          TODO: Adding port_id as key is a hacky solution. The real solution would be to split
-        //          this map, similar to recv_waiting and msg_standby.
+        //          have the same (tag, src_id, dst_id), so the flow id tells them apart.
         //   - value: A MsgEvent instance that indicates that Sys layer is waiting for a
         //   send event to finish
-        static std::map<std::pair<HTSim::MsgEventKey, int>, HTSim::MsgEvent> send_waiting;
-
-        //   - recv_waiting holds messages where sim_recv has been called but HTSim has
-        //   not yet simulated the message arriving,
-        //   - msg_standby holds messages which HTSim has simulated the arrival, but sim_recv
-        //   has not yet been called.
-
-        //   - key: A MsgEventKey instance.
-        //   - value: A MsgEvent instance that indicates that Sys layer is waiting for a
-        //   receive event to finish
-        static std::map<HTSim::MsgEventKey, HTSim::MsgEvent> recv_waiting;
+        static AstraSim::MessageTable<HTSim::MsgEvent> send_waiting;
 
-        //   - key: A MsgEventKey instance.
-        //   - value: The number of bytes that HTSim has simulated completed, but the
-        //   System layer has not yet called sim_recv
-        static std::map<HTSim::MsgEventKey, int> msg_standby;
+        // recv_matcher pairs sim_recv calls with the bytes HTSim has simulated
+        // arriving, in whichever order they happen.
+        //   - key: A MsgEventKey instance (without flow id).
+        static AstraSim::MessageMatcher recv_matcher;
 
-        static std::map<int, int> flow_id_to_tag;
+        // Tag of each flow, indexed by flow id. Flow ids are handed out
+        // sequentially by HTSimNetworkApi, so the vector stays dense.
+        static std::vector<int> flow_id_to_tag;
 
         static void notify_receiver_receive_data(int src_id,
                                                  int dst_id,
@@ -0,0 +1,133 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "HybridNetworkApi.hh"
+#include <cassert>
+#include <iostream>
+#include <yaml-cpp/yaml.h>
+
+using namespace AstraSim;
+using namespace NetworkAnalytical;
+using namespace HTSim;
+
+std::shared_ptr<Topology> HybridNetworkApi::topology;
+std::vector<bool> HybridNetworkApi::analytical_dims;
+std::vector<int> HybridNetworkApi::npus_count_per_dim;
+
+std::vector<bool> HybridNetworkApi::parse_analytical_dims(const std::string& network_configuration,
+                                                          const int dims_count) {
+    auto dims = std::vector<bool>(dims_count, false);
+
+    const auto network_config = YAML::LoadFile(network_configuration);
+    if (!network_config["fidelity"]) {
+        return dims;
+    }
+
+    const auto fidelity = network_config["fidelity"].as<std::vector<std::string>>();
+    if (fidelity.size() != static_cast<size_t>(dims_count)) {
+        std::cerr << "[Error] (network/htsim) "
+                  << "fidelity has " << fidelity.size() << " entries, but the topology has "
+                  << dims_count << " dimensions" << std::endl;
+        std::exit(-1);
+    }
+
+    for (auto dim = 0; dim < dims_count; dim++) {
+        if (fidelity[dim] == "analytical") {
+            dims[dim] = true;
+        } else if (fidelity[dim] != "htsim") {
+            std::cerr << "[Error] (network/htsim) "
+                      << "Unknown fidelity " << fidelity[dim] << " of dimension " << dim
+                      << ", expected analytical or htsim" << std::endl;
+            std::exit(-1);
+        }
+    }
+    return dims;
+}
+
+void HybridNetworkApi::set_topology(std::shared_ptr<Topology> topology_ptr,
+                                    std::vector<bool> analytical_dims) noexcept {
+    assert(topology_ptr != nullptr);
+    assert(analytical_dims.size() == static_cast<size_t>(topology_ptr->get_dims_count()));
+
+    // HTSim sets the topology-related values shared with CommonNetworkApi
+    HTSimNetworkApi::set_topology(topology_ptr);
+
+    HybridNetworkApi::npus_count_per_dim = topology_ptr->get_npus_count_per_dim();
+    HybridNetworkApi::analytical_dims = std::move(analytical_dims);
+    HybridNetworkApi::topology = std::move(topology_ptr);
+}
+
+HybridNetworkApi::HybridNetworkApi(const int rank) noexcept
+    : CommonNetworkApi(rank),
+      packet_api(rank) {
+    assert(rank >= 0);
+}
+
+bool HybridNetworkApi::is_analytical(int src, int dst) noexcept {
+    // NPU IDs are laid out with the first dimension varying fastest
+    for (auto dim = 0; dim < static_cast<int>(npus_count_per_dim.size()); dim++) {
+        const auto npus_count = npus_count_per_dim[dim];
+        if (src % npus_count != dst % npus_count && !analytical_dims[dim]) {
+            return false;
+        }
+        src /= npus_count;
+        dst /= npus_count;
+    }
+    return true;
+}
+
+int HybridNetworkApi::sim_send(void* const buffer,
+                               const uint64_t count,
+                               const int type,
+                               const int dst,
+                               const int tag,
+                               sim_request* const request,
+                               void (*msg_handler)(void*),
+                               void* const fun_arg) {
+    const auto src = sim_comm_get_rank();
+    if (!is_analytical(src, dst)) {
+        return packet_api.sim_send(buffer, count, type, dst, tag, request, msg_handler, fun_arg);
+    }
+
+    // the chunk arrives after the analytical delay on the HTSim clock
+    const auto send_delay_ns = topology->send(src, dst, count);
+    send_chunk_with_delay(src, dst, count, tag, msg_handler, fun_arg, send_delay_ns);
+    return 0;
+}
+
+int HybridNetworkApi::sim_recv(void* const buffer,
+                               const uint64_t count,
+                               const int type,
+                               const int src,
+                               const int tag,
+                               sim_request* const request,
+                               void (*msg_handler)(void*),
+                               void* const fun_arg) {
+    const auto dst = sim_comm_get_rank();
+    if (!is_analytical(src, dst)) {
+        return packet_api.sim_recv(buffer, count, type, src, tag, request, msg_handler, fun_arg);
+    }
+
+    recv_chunk(src, dst, count, tag, msg_handler, fun_arg);
+    return 0;
+}
+
+timespec_t HybridNetworkApi::sim_get_time() {
+    return packet_api.sim_get_time();
+}
+
+Tick HybridNetworkApi::sim_get_tick() {
+    return packet_api.sim_get_tick();
+}
+
+void HybridNetworkApi::sim_schedule(const timespec_t delta,
+                                    void (*fun_ptr)(void*),
+                                    void* const fun_arg) {
+    packet_api.sim_schedule(delta, fun_ptr, fun_arg);
+}
+
+void HybridNetworkApi::sim_notify_finished() {
+    packet_api.sim_notify_finished();
+}
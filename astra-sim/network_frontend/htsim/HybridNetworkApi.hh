@@ -0,0 +1,104 @@
+#pragma once
+
+#include "HTSimNetworkApi.hh"
+#include "common/CommonNetworkApi.hh"
+#include <astra-network-analytical/congestion_unaware/Topology.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace HTSim {
+
+/**
+ * HybridNetworkApi is a AstraNetworkAPI that simulates each message at the
+ * fidelity of the dimensions it crosses.
+ *
+ * Dimensions marked "analytical" in the `fidelity` list of the network
+ * configuration are simulated by the congestion-unaware analytical model,
+ * the remaining ones by HTSim. A message goes through the analytical model
+ * only if src and dst differ in analytical dimensions alone. Both models
+ * share the HTSim event list as their clock.
+ *
+ * Analytical messages are matched by the CommonNetworkApi callback tracker,
+ * packet-level messages by the HTSimNetworkApi of the same rank.
+ */
+class HybridNetworkApi final : public CommonNetworkApi {
+  public:
+    /**
+     * Read the fidelity of each dimension from the network configuration.
+     * Dimensions without an entry are simulated by HTSim.
+     *
+     * @param network_configuration path to the network configuration
+     * @param dims_count number of dimensions of the topology
+     * @return true for each dimension simulated by the analytical model
+     */
+    static std::vector<bool> parse_analytical_dims(const std::string& network_configuration,
+                                                   int dims_count);
+
+    /**
+     * Set the topology used for the analytical dimensions.
+     *
+     * @param topology_ptr pointer to the topology
+     * @param analytical_dims true for each dimension simulated analytically
+     */
+    static void set_topology(std::shared_ptr<Topology> topology_ptr,
+                             std::vector<bool> analytical_dims) noexcept;
+
+    /**
+     * Constructor.
+     *
+     * @param rank id of the API
+     */
+    explicit HybridNetworkApi(int rank) noexcept;
+
+    int sim_send(void* buffer,
+                 uint64_t count,
+                 int type,
+                 int dst,
+                 int tag,
+                 sim_request* request,
+                 void (*msg_handler)(void* fun_arg),
+                 void* fun_arg) override;
+
+    int sim_recv(void* buffer,
+                 uint64_t count,
+                 int type,
+                 int src,
+                 int tag,
+                 sim_request* request,
+                 void (*msg_handler)(void* fun_arg),
+                 void* fun_arg) override;
+
+    timespec_t sim_get_time() override;
+
+    Tick sim_get_tick() override;
+
+    void sim_schedule(timespec_t delta, void (*fun_ptr)(void* fun_arg), void* fun_arg) override;
+
+    void sim_notify_finished() override;
+
+  private:
+    /**
+     * Check whether a message between two NPUs only crosses analytical
+     * dimensions.
+     *
+     * @param src src NPU ID of the message
+     * @param dst dst NPU ID of the message
+     * @return true if the message is simulated by the analytical model
+     */
+    static bool is_analytical(int src, int dst) noexcept;
+
+    /// topology of all dimensions, used for the analytical ones
+    static std::shared_ptr<Topology> topology;
+
+    /// true for each dimension simulated by the analytical model
+    static std::vector<bool> analytical_dims;
+
+    /// number of NPUs of each dimension
+    static std::vector<int> npus_count_per_dim;
+
+    /// HTSim frontend of this rank, used for packet-level messages and the clock
+    HTSimNetworkApi packet_api;
+};
+
+}  // namespace HTSim
@@ -0,0 +1,59 @@
+#include "HTSimPathCache.hh"
+
+namespace HTSim {
+
+HTSimPathCache::HTSimPathCache(Topology* topology, size_t capacity)
+    : topology(topology), capacity(capacity) {
+}
+
+HTSimPathCache::~HTSimPathCache() {
+    for (auto& entry : lru) {
+        release(entry.paths);
+    }
+}
+
+std::vector<const Route*>* HTSimPathCache::get_paths(uint32_t src, uint32_t dst) {
+    uint64_t key = ((uint64_t)src << 32) | dst;
+
+    auto it = index.find(key);
+    if (it != index.end()) {
+        // Move the pair to the front.
+        hits++;
+        lru.splice(lru.begin(), lru, it->second);
+        return it->second->paths;
+    }
+
+    misses++;
+    if (capacity > 0 && lru.size() >= capacity) {
+        // Drop the least recently used pair. Flows copy the route they use,
+        // so nothing points into the dropped paths anymore.
+        release(lru.back().paths);
+        index.erase(lru.back().key);
+        lru.pop_back();
+    }
+
+    lru.push_front(Entry{key, topology->get_paths(src, dst)});
+    index[key] = lru.begin();
+    return lru.front().paths;
+}
+
+size_t HTSimPathCache::size() const {
+    return lru.size();
+}
+
+uint64_t HTSimPathCache::get_hits() const {
+    return hits;
+}
+
+uint64_t HTSimPathCache::get_misses() const {
+    return misses;
+}
+
+void HTSimPathCache::release(std::vector<const Route*>* paths) {
+    for (const Route* route : *paths) {
+        delete route;
+    }
+    delete paths;
+}
+
+} // namespace HTSim
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include "route.h"
+#include "topology.h"
+
+namespace HTSim {
+
+// LRU cache of the paths between pairs of hosts.
+// Paths are computed by the topology the first time a pair is used, instead of
+// keeping a table with a slot for every (src, dst) pair. Once the cache holds
+// `capacity` pairs, the least recently used pair is dropped (0 = unbounded).
+//
+// The returned paths stay valid until the next call to get_paths().
+class HTSimPathCache {
+    public:
+        HTSimPathCache(Topology* topology, size_t capacity);
+        ~HTSimPathCache();
+        HTSimPathCache(const HTSimPathCache&) = delete;
+        void operator=(const HTSimPathCache&) = delete;
+
+        std::vector<const Route*>* get_paths(uint32_t src, uint32_t dst);
+
+        size_t size() const;
+        uint64_t get_hits() const;
+        uint64_t get_misses() const;
+
+    private:
+        struct Entry {
+            uint64_t key;
+            std::vector<const Route*>* paths;
+        };
+
+        static void release(std::vector<const Route*>* paths);
+
+        Topology* topology;
+        size_t capacity;
+        // Most recently used pair first.
+        std::list<Entry> lru;
+        std::unordered_map<uint64_t, std::list<Entry>::iterator> index;
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+};
+
+} // namespace HTSim
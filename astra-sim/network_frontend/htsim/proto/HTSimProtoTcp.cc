@@ -1,5 +1,6 @@
 #include "HTSimProtoTcp.hh"
 #include "HTSimSession.hh"
+#include "astra-sim/common/Logging.hh"
 
 // Adapted from HTSim main_tcp.cpp
 
@@ -29,6 +30,10 @@ static size_t subflow_count = 1;
 #define USE_FIRST_FIT 0
 #define FIRST_FIT_INTERVAL 100
 
+#if USE_FIRST_FIT
+#error "FirstFit needs the full table of paths, which is no longer built"
+#endif
+
 namespace HTSim {
 
 static void exit_error(char* progr) {
@@ -66,6 +71,10 @@ HTSimProtoTcp::HTSimProtoTcp(const HTSim::tm_info* const tm, int argc, char** ar
             filename << argv[i+1];
             i++;
         }
+        else if (!strcmp(argv[i],"-pathcache")){
+            path_cache_pairs = atoi(argv[i+1]);
+            i++;
+        }
         else if (!strcmp(argv[i],"-sub")){
             subflow_count = atoi(argv[i+1]);
             i++;
@@ -176,18 +185,18 @@ if (topo_file) {
     no_of_nodes = top->no_of_nodes();
     std::cout << "actual nodes " << no_of_nodes << std::endl;
 
-    net_paths = new vector<const Route*>**[no_of_nodes];
     is_dest = new int[no_of_nodes];
-
     for (uint32_t i=0;i<no_of_nodes;i++){
         is_dest[i] = 0;
-        net_paths[i] = new vector<const Route*>*[no_of_nodes];
-        for (uint32_t j = 0;j<no_of_nodes;j++)
-            net_paths[i][j] = NULL;
     }
 
-    if (ff)
-        ff->net_paths = net_paths;
+#ifdef PACKET_SCATTER
+    // Sources keep a pointer to the paths of their pair, which must not be dropped.
+    path_cache_pairs = 0;
+#endif
+    AstraSim::LoggerFactory::get_logger("network")
+        ->debug("Path cache: {} pairs (0 = unbounded)", path_cache_pairs);
+    path_cache = std::make_unique<HTSimPathCache>(top.get(), path_cache_pairs);
 }
 
 // Schedule_htsim_event creates a new connection and schedules it in HTSim.
@@ -199,9 +208,7 @@ void HTSimProtoTcp::schedule_htsim_event(FlowInfo flow, int flow_id) {
     double start = eventlist.now();
     connID++;
 
-    if (!net_paths[src][dst]) {
-        net_paths[src][dst] = top->get_paths(src,dst);
-    }
+    vector<const Route*>* pair_paths = path_cache->get_paths(src, dst);
 
 
     if (algo == COUPLED_EPSILON) {
@@ -216,10 +223,10 @@ void HTSimProtoTcp::schedule_htsim_event(FlowInfo flow, int flow_id) {
     tot_subs += crt_subflow_count;
     cnt_con++;
 
-    it_sub = crt_subflow_count > net_paths[src][dst]->size()?net_paths[src][dst]->size():crt_subflow_count;
+    it_sub = crt_subflow_count > pair_paths->size()?pair_paths->size():crt_subflow_count;
 
 #ifdef MH_FAT_TREE
-    int use_all = it_sub==net_paths[src][dst]->size();
+    int use_all = it_sub==pair_paths->size();
 #endif
 
     for (uint32_t inter = 0; inter < it_sub; inter++) {
@@ -243,22 +250,22 @@ void HTSimProtoTcp::schedule_htsim_event(FlowInfo flow, int flow_id) {
         size_t choice = 0;
 
 #ifdef FAT_TREE
-        choice = rand()%net_paths[src][dst]->size();
+        choice = rand()%pair_paths->size();
 #endif
 
 #ifdef OV_FAT_TREE
-        choice = rand()%net_paths[src][dst]->size();
+        choice = rand()%pair_paths->size();
 #endif
 
 #ifdef MH_FAT_TREE
         if (use_all)
             choice = inter;
         else
-            choice = rand()%net_paths[src][dst]->size();
+            choice = rand()%pair_paths->size();
 #endif
 
 #ifdef VL2
-        choice = rand()%net_paths[src][dst]->size();
+        choice = rand()%pair_paths->size();
 #endif
 
 #ifdef STAR
@@ -271,31 +278,33 @@ void HTSimProtoTcp::schedule_htsim_event(FlowInfo flow, int flow_id) {
         int min = -1, max = -1,minDist = 1000,maxDist = 0;
         if (subflow_count==1){
             //find shortest and longest path
-            for (uint32_t dd=0;dd<net_paths[src][dst]->size();dd++){
-                if (net_paths[src][dst]->at(dd)->size()<minDist){
-                    minDist = net_paths[src][dst]->at(dd)->size();
+            for (uint32_t dd=0;dd<pair_paths->size();dd++){
+                if (pair_paths->at(dd)->size()<minDist){
+                    minDist = pair_paths->at(dd)->size();
                     min = dd;
                 }
-                if (net_paths[src][dst]->at(dd)->size()>maxDist){
-                    maxDist = net_paths[src][dst]->at(dd)->size();
+                if (pair_paths->at(dd)->size()>maxDist){
+                    maxDist = pair_paths->at(dd)->size();
                     max = dd;
                 }
             }
             choice = min;
         } else
-            choice = rand()%net_paths[src][dst]->size();
+            choice = rand()%pair_paths->size();
 #endif
-        if (choice>=net_paths[src][dst]->size()){
-            printf("Weird path choice %lu out of %lu\n",choice,net_paths[src][dst]->size());
+        if (choice>=pair_paths->size()){
+            AstraSim::LoggerFactory::get_logger("network")
+                ->critical("Weird path choice {} out of {}", choice,
+                           pair_paths->size());
             exit(1);
         }
 
 #if PRINT_PATHS
         paths << "Route from "<< ntoa(src) << " to " << ntoa(dst) << "  (" << choice << ") -> " ;
-        print_path(paths,net_paths[src][dst]->at(choice));
+        print_path(paths,pair_paths->at(choice));
 #endif
 
-        routeout = new Route(*(net_paths[src][dst]->at(choice)));
+        routeout = new Route(*(pair_paths->at(choice)));
         routeout->push_back(tcpSnk);
 
         routein = new Route();
@@ -319,7 +328,7 @@ void HTSimProtoTcp::schedule_htsim_event(FlowInfo flow, int flow_id) {
         }
 
 #ifdef PACKET_SCATTER
-        tcpSrc->set_paths(net_paths[src][dst]);
+        tcpSrc->set_paths(pair_paths);
         cout << "Using PACKET SCATTER!!!!"<<endl;
 #endif
 
@@ -350,10 +359,11 @@ void HTSimProtoTcp::finish() {
 #if USE_FIRST_FIT
     delete ff
 #endif
-    for (uint32_t i=0;i<no_of_nodes;i++){
-        delete net_paths[i];
-    }
-    delete[] net_paths;
+    AstraSim::LoggerFactory::get_logger("network")
+        ->debug("Path cache: {} pairs cached, {} hits, {} misses",
+                path_cache->size(), path_cache->get_hits(),
+                path_cache->get_misses());
+    path_cache.reset();
     delete[] is_dest;
     std::cout << std::endl << "Simulation of events finished" << std::endl;
 }
@@ -9,6 +9,7 @@
 #include <fstream>
 
 #include "HTSimSessionImpl.hh"
+#include "HTSimPathCache.hh"
 
 #include "config.h"
 #include "clock.h"
@@ -55,7 +56,10 @@ class HTSimProtoTcp final : public HTSimSession::HTSimSessionImpl {
         std::unique_ptr<QueueLoggerFactory> qlf;
         std::unique_ptr<Logfile> logfile;
 
-        vector<const Route*>*** net_paths;
+        // Paths between pairs of hosts, computed on first use.
+        static const size_t DEFAULT_PATH_CACHE_PAIRS = 1024;
+        size_t path_cache_pairs = DEFAULT_PATH_CACHE_PAIRS;
+        std::unique_ptr<HTSimPathCache> path_cache;
         int* is_dest;
 
         char* topo_file = NULL;
@@ -1,5 +1,6 @@
 #include "astra-sim/common/AstraNetworkAPI.hh"
 #include "astra-sim/system/Sys.hh"
+#include "astra-sim/workload/WorkloadLoader.hh"
 #include "extern/remote_memory_backend/analytical/AnalyticalRemoteMemory.hh"
 #include <json/json.hpp>
 
@@ -36,13 +37,11 @@ using json = nlohmann::json;
  * @class NS3BackendCompletionTracker
  * @brief Tracks the completion status of ranks in the NS3 backend.
  *
- * This is a hacky approach to track which ranks have completed their workload.
  * The purpose of this class is to end the ns3 simulation once all ranks have
- * completed. The hacky approach is necessary because each ASTRASimNetwork
- * instance only corresponds to one rank. That is, someone needs to keep track
- * of the completion status of all of the ranks. Because there is no exit point
- * once the ns3 simulator has started, we cannot implement such tracker in the
- * main function.
+ * completed. Each ASTRASimNetwork instance only corresponds to one rank, so
+ * someone needs to keep track of the completion status of all of the ranks.
+ * Once the last rank finishes, the tracker stops the ns3 simulator, which
+ * returns control from Simulator::Run() to the main function for cleanup.
  */
 class NS3BackendCompletionTracker {
   public:
@@ -59,10 +58,7 @@ class NS3BackendCompletionTracker {
         if (num_unfinished_ranks_ == 0) {
             AstraSim::LoggerFactory::get_logger("network")->debug(
                 "All ranks have finished. Exiting simulation.");
-            // cout << "All ranks have finished. Exiting simulation.\n";
             Simulator::Stop();
-            Simulator::Destroy();
-            exit(0);
         }
     }
 
@@ -112,6 +108,10 @@ class ASTRASimNetwork : public AstraSim::AstraNetworkAPI {
         return timeSpec;
     }
 
+    AstraSim::Tick sim_get_tick() override {
+        return Simulator::Now().GetNanoSeconds() / AstraSim::CLOCK_PERIOD;
+    }
+
     virtual void sim_schedule(AstraSim::timespec_t delta,
                               void (*fun_ptr)(void* fun_arg),
                               void* fun_arg) {
@@ -142,51 +142,11 @@ class ASTRASimNetwork : public AstraSim::AstraNetworkAPI {
                          AstraSim::sim_request* request,
                          void (*msg_handler)(void* fun_arg),
                          void* fun_arg) {
+        // Wait for the bytes ns3 has simulated arriving, or call the handler
+        // right away if they already arrived.
         int dst_id = rank;
-        MsgEvent recv_event =
-            MsgEvent(src_id, dst_id, 1, message_size, fun_arg, msg_handler);
-        MsgEventKey recv_event_key =
-            make_pair(tag, make_pair(recv_event.src_id, recv_event.dst_id));
-
-        if (received_msg_standby_hash.find(recv_event_key) !=
-            received_msg_standby_hash.end()) {
-            // 1) ns3 has already received some message before sim_recv is
-            // called.
-            int received_msg_bytes = received_msg_standby_hash[recv_event_key];
-            if (received_msg_bytes == message_size) {
-                // 1-1) The received message size is same as what we expect.
-                // Exit.
-                received_msg_standby_hash.erase(recv_event_key);
-                recv_event.callHandler();
-            } else if (received_msg_bytes > message_size) {
-                // 1-2) The node received more than expected.
-                // Do trigger the callback handler for this message, but wait
-                // for Sys layer to call sim_recv for more messages.
-                received_msg_standby_hash[recv_event_key] =
-                    received_msg_bytes - message_size;
-                recv_event.callHandler();
-            } else {
-                // 1-3) The node received less than what we expected.
-                // Reduce the number of bytes we are waiting to receive.
-                received_msg_standby_hash.erase(recv_event_key);
-                recv_event.remaining_msg_bytes -= received_msg_bytes;
-                sim_recv_waiting_hash[recv_event_key] = recv_event;
-            }
-        } else {
-            // 2) ns3 has not yet received anything.
-            if (sim_recv_waiting_hash.find(recv_event_key) ==
-                sim_recv_waiting_hash.end()) {
-                // 2-1) We have not been expecting anything.
-                sim_recv_waiting_hash[recv_event_key] = recv_event;
-            } else {
-                // 2-2) We have already been expecting something.
-                // Increment the number of bytes we are waiting to receive.
-                int expecting_msg_bytes =
-                    sim_recv_waiting_hash[recv_event_key].remaining_msg_bytes;
-                recv_event.remaining_msg_bytes += expecting_msg_bytes;
-                sim_recv_waiting_hash[recv_event_key] = recv_event;
-            }
-        }
+        recv_matcher.post_recv(make_msg_event_key(tag, src_id, dst_id),
+                               message_size, msg_handler, fun_arg);
         return 0;
     }
 
@@ -206,6 +166,7 @@ int num_queues_per_dim = 1;
 double comm_scale = 1;
 double injection_scale = 1;
 bool rendezvous_protocol = false;
+string workload_cache;
 auto logical_dims = vector<int>();
 int num_npus = 1;
 auto queues_per_dim = vector<int>();
@@ -267,6 +228,10 @@ void parse_args(int argc, char* argv[]) {
     cmd.AddValue("injection-scale", "Injection scale", injection_scale);
     cmd.AddValue("rendezvous-protocol", "Whether to enable rendezvous protocol",
                  rendezvous_protocol);
+    cmd.AddValue("workload-cache",
+                 "Directory of compiled workloads to map instead of parsing "
+                 "the ETs",
+                 workload_cache);
 
     cmd.Parse(argc, argv);
 }
@@ -290,6 +255,14 @@ int main(int argc, char* argv[]) {
     NS3BackendCompletionTracker* completion_tracker =
         new NS3BackendCompletionTracker(num_npus);
 
+    // Parse the execution traces of all NPUs ahead of Sys.
+    vector<int> npu_ids(num_npus);
+    for (int npu_id = 0; npu_id < num_npus; npu_id++) {
+        npu_ids[npu_id] = npu_id;
+    }
+    AstraSim::WorkloadLoader::set_cache_dir(workload_cache);
+    AstraSim::WorkloadLoader::preload(workload_configuration, npu_ids);
+
     for (int npu_id = 0; npu_id < num_npus; npu_id++) {
         networks[npu_id] = new ASTRASimNetwork(npu_id, completion_tracker);
         systems[npu_id] = new AstraSim::Sys(
@@ -297,6 +270,7 @@ int main(int argc, char* argv[]) {
             system_configuration, mem, networks[npu_id], logical_dims,
             queues_per_dim, injection_scale, comm_scale, rendezvous_protocol);
     }
+    AstraSim::WorkloadLoader::check_streaming(systems);
 
     // Initialize ns3 simulation.
     if (auto ok = setup_ns3_simulation(network_configuration); ok == -1) {
@@ -311,5 +285,19 @@ int main(int argc, char* argv[]) {
 
     // Run the simulation by triggering the ns3 event queue.
     Simulator::Run();
+
+    // Write the remaining FCT records.
+    flush_fct_log();
+
+    // Deleting the last Sys reports the object pools.
+    for (int i = 0; i < num_npus; i++) {
+        delete systems[i];
+        delete networks[i];
+    }
+    delete completion_tracker;
+    delete mem;
+
+    Simulator::Destroy();
+    AstraSim::LoggerFactory::shutdown();
     return 0;
 }
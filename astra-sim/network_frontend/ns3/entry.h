@@ -1,6 +1,7 @@
 #undef PGO_TRAINING
 #define PATH_TO_PGO_CONFIG "path_to_pgo_config"
 
+#include "astra-sim/common/MessageMatcher.hh"
 #include "common.h"
 #include "ns3/applications-module.h"
 #include "ns3/core-module.h"
@@ -11,6 +12,7 @@
 #include "ns3/packet.h"
 #include "ns3/point-to-point-helper.h"
 #include "ns3/qbb-helper.h"
+#include <cstdio>
 #include <fstream>
 #include <iostream>
 #include <ns3/rdma-client-helper.h>
@@ -19,6 +21,7 @@
 #include <ns3/rdma.h>
 #include <ns3/sim-setting.h>
 #include <ns3/switch-node.h>
+#include <string>
 #include <time.h>
 #include <unordered_map>
 
@@ -74,17 +77,32 @@ public:
 };
 
 // MsgEventKey is a key to uniquely identify each MsgEvent.
-//  - Pair <Tag, Pair <src_id, dst_id>>
-typedef pair<int, pair<int, int>> MsgEventKey;
+//  - (tag, src_id, dst_id) packed into a MessageKey. Messages are matched by
+//    their remaining bytes, so the size of the key is always 0.
+//  - The id slot holds the source port of the queue pair for send events.
+typedef AstraSim::MessageKey MsgEventKey;
+
+inline MsgEventKey make_msg_event_key(int tag, int src_id, int dst_id,
+                                      int port = 0) {
+  return MsgEventKey(tag, src_id, dst_id, 0, port);
+}
+
+// NodeBytesKeyHash hashes the <node_id, send/receive> keys of
+// node_to_bytes_sent_map.
+struct NodeBytesKeyHash {
+  size_t operator()(const pair<int, int> &key) const {
+    return MsgEventKey(0, key.first, key.second).hash();
+  }
+};
 
 // The ns3 RdmaClient structure cannot hold the 'tag' information, which is a
 // Astra-sim specific implementation. We use a mapping with the source port
 // number (another unique value) to hold tag information.
-//   - key: Pair <port_id, Pair <src_id, dst_id>>
+//   - key: make_msg_event_key(0, src_id, dst_id, port_id)
 //   - value: tag
 // TODO: It seems we *can* obtain the tag through q->GetTag() at qp_finish.
 // Verify & Simplify.
-map<pair<int, pair<int, int>>, int> sender_src_port_map;
+AstraSim::MessageTable<int> sender_src_port_map;
 
 // NodeHash is used to count how many bytes were sent/received by this node.
 // Refer to sim_finish().
@@ -92,33 +110,39 @@ map<pair<int, pair<int, int>>, int> sender_src_port_map;
 //   value is for send or receive
 //   - value: Number of bytes this node has sent (if send/receive is 0) and
 //   received (if send/receive is 1)
-map<pair<int, int>, int> node_to_bytes_sent_map;
+unordered_map<pair<int, int>, int, NodeBytesKeyHash> node_to_bytes_sent_map;
 
 // SentHash stores a MsgEvent for sim_send events and its callback handler.
-//   - key: A pair of <MsgEventKey, port_id>. 
-//          A single collective phase can be split into multiple sim_send messages, which all have the same MsgEventKey. 
-//          TODO: Adding port_id as key is a hacky solution. The real solution would be to split this map, similar to sim_recv_waiting_hash and received_msg_standby_hash.
+//   - key: MsgEventKey of the message, including the port_id.
+//          A single collective phase can be split into multiple sim_send
+//          messages, which all have the same (tag, src_id, dst_id), so the
+//          port_id tells them apart.
 //   - value: A MsgEvent instance that indicates that Sys layer is waiting for a
 //   send event to finish
-map<pair<MsgEventKey, int>, MsgEvent> sim_send_waiting_hash;
+AstraSim::MessageTable<MsgEvent> sim_send_waiting_hash;
 
 // While ns3 cannot send packets before System layer calls sim_send, it
 // is possible for ns3 to simulate Incoming messages before System layer calls
-// sim_recv to 'reap' the messages. Therefore, we maintain two maps:
-//   - sim_recv_waiting_hash holds messages where sim_recv has been called but ns3 has
-//   not yet simulated the message arriving,
-//   - received_msg_standby_hash holds messages which ns3 has simulated the arrival, but sim_recv
-//   has not yet been called.
-
-//   - key: A MsgEventKey isntance.
-//   - value: A MsgEvent instance that indicates that Sys layer is waiting for a
-//   receive event to finish
-map<MsgEventKey, MsgEvent> sim_recv_waiting_hash;
-
-//   - key: A MsgEventKey isntance.
-//   - value: The number of bytes that ns3 has simulated completed, but the
-//   System layer has not yet called sim_recv
-map<MsgEventKey, int> received_msg_standby_hash;
+// sim_recv to 'reap' the messages. recv_matcher pairs sim_recv calls with the
+// bytes ns3 has simulated arriving, in whichever order they happen.
+//   - key: A MsgEventKey instance (without port_id).
+AstraSim::MessageMatcher recv_matcher;
+
+// FCT records are appended to fct_log_buffer and written to the FCT output file
+// in large blocks instead of being flushed once per queue pair. The remainder
+// is written by flush_fct_log() once the simulation has stopped.
+constexpr size_t FCT_LOG_BUFFER_SIZE = 1 << 20;
+string fct_log_buffer;
+FILE *fct_log_file = nullptr;
+
+void flush_fct_log() {
+  if (fct_log_file == nullptr) {
+    return;
+  }
+  fwrite(fct_log_buffer.data(), 1, fct_log_buffer.size(), fct_log_file);
+  fflush(fct_log_file);
+  fct_log_buffer.clear();
+}
 
 // send_flow commands the ns3 simulator to schedule a RDMA message to be sent
 // between two pair of nodes. send_flow is triggered by sim_send.
@@ -126,16 +150,16 @@ void send_flow(int src_id, int dst, int maxPacketCount,
                void (*msg_handler)(void *fun_arg), void *fun_arg, int tag) {
   // Get a new port number.
   uint32_t port = portNumber[src_id][dst]++;
-  sender_src_port_map[make_pair(port, make_pair(src_id, dst))] = tag;
+  *sender_src_port_map.insert(make_msg_event_key(0, src_id, dst, port)) = tag;
   int pg = 3, dport = 100;
   flow_input.idx++;
 
   // Create a MsgEvent instance and register callback function.
   MsgEvent send_event =
       MsgEvent(src_id, dst, 0, maxPacketCount, fun_arg, msg_handler);
-  pair<MsgEventKey, int> send_event_key =
-      make_pair(make_pair(tag, make_pair(send_event.src_id, send_event.dst_id)),port) ;
-  sim_send_waiting_hash[send_event_key] = send_event;
+  MsgEventKey send_event_key =
+      make_msg_event_key(tag, send_event.src_id, send_event.dst_id, port);
+  *sim_send_waiting_hash.insert(send_event_key) = send_event;
 
   // Create a queue pair and schedule within the ns3 simulator.
   RdmaClientHelper clientHelper(
@@ -157,56 +181,19 @@ void send_flow(int src_id, int dst, int maxPacketCount,
 // is called.
 void notify_receiver_receive_data(int src_id, int dst_id, int message_size,
                                   int tag) {
-
-  MsgEventKey recv_expect_event_key = make_pair(tag, make_pair(src_id, dst_id));
-
-  if (sim_recv_waiting_hash.find(recv_expect_event_key) != sim_recv_waiting_hash.end()) {
-    // The Sys object is waiting for packets to arrive.
-    MsgEvent recv_expect_event = sim_recv_waiting_hash[recv_expect_event_key];
-    if (message_size == recv_expect_event.remaining_msg_bytes) {
-      // We received exactly the amount of data what Sys object was expecting.
-      sim_recv_waiting_hash.erase(recv_expect_event_key);
-      recv_expect_event.callHandler();
-    } else if (message_size > recv_expect_event.remaining_msg_bytes) {
-      // We received more packets than the Sys object is expecting.
-      // Place task in received_msg_standby_hash and wait for Sys object to issue more sim_recv
-      // calls. Call callback handler for the amount Sys object was waiting for.
-      received_msg_standby_hash[recv_expect_event_key] =
-          message_size - recv_expect_event.remaining_msg_bytes;
-      sim_recv_waiting_hash.erase(recv_expect_event_key);
-      recv_expect_event.callHandler();
-    } else {
-      // There are still packets to arrive.
-      // Reduce the number of packets we are waiting for. Do not call callback
-      // handler.
-      recv_expect_event.remaining_msg_bytes -= message_size;
-      sim_recv_waiting_hash[recv_expect_event_key] = recv_expect_event;
-    }
-  } else {
-    // The Sys object is not yet waiting for packets to arrive.
-    if (received_msg_standby_hash.find(recv_expect_event_key) == received_msg_standby_hash.end()) {
-      // Place task in received_msg_standby_hash and wait for Sys object to issue more sim_recv
-      // calls.
-      received_msg_standby_hash[recv_expect_event_key] = message_size;
-    } else {
-      // Sys object is still waiting. Add number of bytes we are waiting for.
-      received_msg_standby_hash[recv_expect_event_key] += message_size;
-    }
-  }
-
   // Add to the number of total bytes received.
-  if (node_to_bytes_sent_map.find(make_pair(dst_id, 1)) == node_to_bytes_sent_map.end()) {
-    node_to_bytes_sent_map[make_pair(dst_id, 1)] = message_size;
-  } else {
-    node_to_bytes_sent_map[make_pair(dst_id, 1)] += message_size;
-  }
+  node_to_bytes_sent_map[make_pair(dst_id, 1)] += message_size;
+
+  recv_matcher.deliver(make_msg_event_key(tag, src_id, dst_id), message_size);
 }
 
 void notify_sender_sending_finished(int src_id, int dst_id, int message_size,
                                     int tag, int src_port) {
   // Lookup the send_event registered at send_flow().
-  pair<MsgEventKey, int> send_event_key = make_pair(make_pair(tag, make_pair(src_id, dst_id)), src_port);
-  if (sim_send_waiting_hash.find(send_event_key) == sim_send_waiting_hash.end()) {
+  MsgEventKey send_event_key =
+      make_msg_event_key(tag, src_id, dst_id, src_port);
+  MsgEvent *send_waiting_event = sim_send_waiting_hash.find(send_event_key);
+  if (send_waiting_event == nullptr) {
     cerr << "Cannot find send_event in sent_hash. Something is wrong."
          << "tag, src_id, dst_id: " << tag << " " << src_id << " " << dst_id
          << "\n";
@@ -215,7 +202,7 @@ void notify_sender_sending_finished(int src_id, int dst_id, int message_size,
 
   // Verify that the (ns3 identified) sent message size matches what was
   // expected by the system layer.
-  MsgEvent send_event = sim_send_waiting_hash[send_event_key];
+  MsgEvent send_event = *send_waiting_event;
   if (send_event.remaining_msg_bytes != message_size) {
     cerr << "The message size does not match what is expected. Something is "
             "wrong."
@@ -227,11 +214,7 @@ void notify_sender_sending_finished(int src_id, int dst_id, int message_size,
   sim_send_waiting_hash.erase(send_event_key);
 
   // Add to the number of total bytes sent.
-  if (node_to_bytes_sent_map.find(make_pair(src_id, 0)) == node_to_bytes_sent_map.end()) {
-    node_to_bytes_sent_map[make_pair(src_id, 0)] = message_size;
-  } else {
-    node_to_bytes_sent_map[make_pair(src_id, 0)] += message_size;
-  }
+  node_to_bytes_sent_map[make_pair(src_id, 0)] += message_size;
   send_event.callHandler();
 }
 
@@ -246,10 +229,21 @@ void qp_finish_print_log(FILE *fout, Ptr<RdmaQueuePair> q) {
                                         // required (with header but no INT)
   uint64_t standalone_fct = base_rtt + total_bytes * 8000000000lu / b;
   // sip, dip, sport, dport, size (B), start_time, fct (ns), standalone_fct (ns)
-  fprintf(fout, "%08x %08x %u %u %lu %lu %lu %lu\n", q->sip.Get(), q->dip.Get(),
-          q->sport, q->dport, q->m_size, q->startTime.GetTimeStep(),
-          (Simulator::Now() - q->startTime).GetTimeStep(), standalone_fct);
-  fflush(fout);
+  char line[128];
+  int length = snprintf(
+      line, sizeof(line), "%08x %08x %u %u %lu %lu %lu %lu\n", q->sip.Get(),
+      q->dip.Get(), q->sport, q->dport, q->m_size, q->startTime.GetTimeStep(),
+      (Simulator::Now() - q->startTime).GetTimeStep(), standalone_fct);
+
+  if (fct_log_file != fout) {
+    flush_fct_log();
+    fct_log_file = fout;
+    fct_log_buffer.reserve(FCT_LOG_BUFFER_SIZE);
+  }
+  fct_log_buffer.append(line, min(length, (int)sizeof(line) - 1));
+  if (fct_log_buffer.size() >= FCT_LOG_BUFFER_SIZE) {
+    flush_fct_log();
+  }
 }
 
 // qp_finish is triggered by NS3 to indicate that an RDMA queue pair has
@@ -266,13 +260,14 @@ void qp_finish(FILE *fout, Ptr<RdmaQueuePair> q) {
   rdma->m_rdma->DeleteRxQp(q->sip.Get(), q->m_pg, q->sport);
 
   // Identify the tag of this message.
-  if (sender_src_port_map.find(make_pair(q->sport, make_pair(sid, did))) ==
-      sender_src_port_map.end()) {
+  MsgEventKey port_key = make_msg_event_key(0, sid, did, q->sport);
+  int *sender_tag = sender_src_port_map.find(port_key);
+  if (sender_tag == nullptr) {
     cout << "could not find the tag, there must be something wrong" << endl;
     exit(-1);
   }
-  int tag = sender_src_port_map[make_pair(q->sport, make_pair(sid, did))];
-  sender_src_port_map.erase(make_pair(q->sport, make_pair(sid, did)));
+  int tag = *sender_tag;
+  sender_src_port_map.erase(port_key);
 
   // Let sender knows that the flow has finished.
   notify_sender_sending_finished(sid, did, q->m_size, tag, q->sport);
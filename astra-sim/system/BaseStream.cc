@@ -9,8 +9,9 @@ LICENSE file in the root directory of this source tree.
 
 using namespace AstraSim;
 
-std::map<int, int> BaseStream::synchronizer;
-std::map<int, int> BaseStream::ready_counter;
+std::vector<int> BaseStream::synchronizer;
+std::vector<int> BaseStream::ready_counter;
+std::mutex BaseStream::counters_mutex;
 std::map<int, std::list<BaseStream*>> BaseStream::suspended_streams;
 
 void BaseStream::changeState(StreamState state) {
@@ -23,12 +24,15 @@ BaseStream::BaseStream(int stream_id,
     this->stream_id = stream_id;
     this->owner = owner;
     this->initialized = false;
+    this->before_cursor = false;
     this->phases_to_go = phases_to_go;
-    if (synchronizer.find(stream_id) != synchronizer.end()) {
+    {
+        std::lock_guard<std::mutex> lock(counters_mutex);
+        if (stream_id >= synchronizer.size()) {
+            synchronizer.resize(stream_id + 1, 0);
+            ready_counter.resize(stream_id + 1, 0);
+        }
         synchronizer[stream_id]++;
-    } else {
-        synchronizer[stream_id] = 1;
-        ready_counter[stream_id] = 0;
     }
     for (auto& vn : phases_to_go) {
         if (vn.algorithm != nullptr) {
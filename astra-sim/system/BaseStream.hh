@@ -8,6 +8,8 @@ LICENSE file in the root directory of this source tree.
 
 #include <list>
 #include <map>
+#include <mutex>
+#include <vector>
 
 #include "astra-sim/system/Callable.hh"
 #include "astra-sim/system/CollectivePhase.hh"
@@ -31,8 +33,12 @@ class BaseStream : public Callable, public StreamStat {
     virtual void consume(RecvPacketEventHandlerData* message) = 0;
     virtual void init() = 0;
 
-    static std::map<int, int> synchronizer;
-    static std::map<int, int> ready_counter;
+    // indexed by stream id: number of ranks that created the stream, and
+    // number of ranks whose ready list currently starts with it
+    // guarded by counters_mutex, as ranks may run on different threads
+    static std::vector<int> synchronizer;
+    static std::vector<int> ready_counter;
+    static std::mutex counters_mutex;
     static std::map<int, std::list<BaseStream*>> suspended_streams;
     int stream_id;
     int total_packets_sent;
@@ -50,6 +56,10 @@ class BaseStream : public Callable, public StreamStat {
     int priority;
     StreamState state;
     bool initialized;
+    // position in the ready list or active list the stream was last put in
+    std::list<BaseStream*>::iterator queue_position;
+    // true while the stream is before the cursor of its queue
+    bool before_cursor;
 
     Tick last_phase_change;
 
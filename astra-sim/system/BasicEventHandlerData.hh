@@ -6,6 +6,7 @@ LICENSE file in the root directory of this source tree.
 #ifndef __BASIC_EVENT_HANDLER_DATA_HH__
 #define __BASIC_EVENT_HANDLER_DATA_HH__
 
+#include "astra-sim/common/ObjectPool.hh"
 #include "astra-sim/system/CallData.hh"
 #include "astra-sim/system/Common.hh"
 
@@ -13,6 +14,13 @@ namespace AstraSim {
 
 class BasicEventHandlerData : public CallData {
   public:
+    static void* operator new(size_t size) {
+        return ObjectPool<BasicEventHandlerData>::allocate(size);
+    }
+    static void operator delete(void* ptr, size_t size) {
+        ObjectPool<BasicEventHandlerData>::deallocate(ptr, size);
+    }
+
     BasicEventHandlerData();
     BasicEventHandlerData(int sys_id, EventType event);
 
@@ -0,0 +1,190 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "astra-sim/system/Checkpoint.hh"
+
+#include <cstdio>
+#include <cstring>
+
+#include "astra-sim/system/Sys.hh"
+#include "astra-sim/workload/Workload.hh"
+
+using namespace std;
+using namespace AstraSim;
+
+namespace {
+constexpr uint64_t CHECKPOINT_MAGIC = 0x4b43505354534141ULL;  // "AASTSPCK"
+constexpr uint64_t CHECKPOINT_VERSION = 1;
+}  // namespace
+
+// CheckpointWriter -----------------------------------------------------------
+CheckpointWriter::CheckpointWriter(const string& filename)
+    : filename(filename), tmp_filename(filename + ".tmp") {
+    out.open(tmp_filename, ios::binary | ios::trunc);
+    if (!out.is_open()) {
+        Sys::sys_panic("Unable to open checkpoint file " + tmp_filename);
+    }
+}
+
+void CheckpointWriter::write_u64(uint64_t value) {
+    unsigned char bytes[8];
+    for (int i = 0; i < 8; i++) {
+        bytes[i] = static_cast<unsigned char>(value >> (8 * i));
+    }
+    out.write(reinterpret_cast<const char*>(bytes), sizeof(bytes));
+}
+
+void CheckpointWriter::write_i64(int64_t value) {
+    write_u64(static_cast<uint64_t>(value));
+}
+
+void CheckpointWriter::write_double(double value) {
+    uint64_t bits;
+    static_assert(sizeof(bits) == sizeof(value));
+    memcpy(&bits, &value, sizeof(bits));
+    write_u64(bits);
+}
+
+void CheckpointWriter::write_string(const string& value) {
+    write_u64(value.size());
+    out.write(value.data(), value.size());
+}
+
+void CheckpointWriter::commit() {
+    out.close();
+    if (out.fail() || rename(tmp_filename.c_str(), filename.c_str()) != 0) {
+        Sys::sys_panic("Unable to write checkpoint file " + filename);
+    }
+}
+//-----------------------------------------------------------------------------
+
+// CheckpointReader -----------------------------------------------------------
+CheckpointReader::CheckpointReader(const string& filename)
+    : filename(filename) {
+    in.open(filename, ios::binary);
+    if (!in.is_open()) {
+        Sys::sys_panic("Unable to open checkpoint file " + filename);
+    }
+}
+
+uint64_t CheckpointReader::read_u64() {
+    unsigned char bytes[8];
+    in.read(reinterpret_cast<char*>(bytes), sizeof(bytes));
+    if (!in) {
+        Sys::sys_panic("Checkpoint file " + filename + " is truncated");
+    }
+    uint64_t value = 0;
+    for (int i = 0; i < 8; i++) {
+        value |= static_cast<uint64_t>(bytes[i]) << (8 * i);
+    }
+    return value;
+}
+
+int64_t CheckpointReader::read_i64() {
+    return static_cast<int64_t>(read_u64());
+}
+
+double CheckpointReader::read_double() {
+    uint64_t bits = read_u64();
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+string CheckpointReader::read_string() {
+    uint64_t size = read_u64();
+    string value(size, '\0');
+    in.read(value.data(), size);
+    if (!in) {
+        Sys::sys_panic("Checkpoint file " + filename + " is truncated");
+    }
+    return value;
+}
+//-----------------------------------------------------------------------------
+
+// Checkpoint -----------------------------------------------------------------
+void Checkpoint::enable(const vector<Sys*>& systems) {
+    bool streaming = false;
+    for (auto sys : systems) {
+        // restore replays the finished nodes, which streaming does not keep
+        if (sys->streaming_execution) {
+            streaming = true;
+            continue;
+        }
+        sys->workload->enable_checkpoints();
+    }
+    if (streaming) {
+        LoggerFactory::get_logger("system")->warn(
+            "checkpoints are disabled by streaming-execution");
+    }
+}
+
+bool Checkpoint::is_quiescent(const vector<Sys*>& systems) {
+    for (auto sys : systems) {
+        if (!sys->is_checkpointable()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void Checkpoint::save(const string& filename,
+                      Tick tick,
+                      const vector<Sys*>& systems) {
+    CheckpointWriter writer(filename);
+    writer.write_u64(CHECKPOINT_MAGIC);
+    writer.write_u64(CHECKPOINT_VERSION);
+    writer.write_u64(tick);
+    writer.write_u64(systems.size());
+    for (auto sys : systems) {
+        writer.write_i64(sys->id);
+        sys->checkpoint(writer);
+    }
+    writer.commit();
+
+    LoggerFactory::get_logger("system")->info(
+        "checkpoint of {} ranks at tick {} written to {}", systems.size(),
+        tick, filename);
+}
+
+Tick Checkpoint::load_tick(CheckpointReader& reader,
+                           const vector<Sys*>& systems) {
+    if (reader.read_u64() != CHECKPOINT_MAGIC) {
+        Sys::sys_panic("Not a checkpoint file");
+    }
+    if (reader.read_u64() != CHECKPOINT_VERSION) {
+        Sys::sys_panic("Unsupported checkpoint version");
+    }
+    Tick tick = reader.read_u64();
+    if (reader.read_u64() != systems.size()) {
+        Sys::sys_panic("Checkpoint was taken with a different number of "
+                       "ranks");
+    }
+    return tick;
+}
+
+void Checkpoint::restore(CheckpointReader& reader,
+                         const vector<Sys*>& systems) {
+    for (auto sys : systems) {
+        if (reader.read_i64() != sys->id) {
+            Sys::sys_panic("Checkpoint was taken with different ranks");
+        }
+        sys->restore(reader);
+    }
+
+    // pick up where the checkpoint left off; at a quiescent tick every
+    // issuable node was already issued, so this only re-checks completion.
+    // Finished ranks were already reported by their restore.
+    for (auto sys : systems) {
+        if (!sys->workload->is_finished) {
+            sys->workload->fire();
+        }
+    }
+
+    LoggerFactory::get_logger("system")->info(
+        "restored {} ranks from checkpoint at tick {}", systems.size(),
+        Sys::boostedTick());
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,119 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#ifndef __CHECKPOINT_HH__
+#define __CHECKPOINT_HH__
+
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "astra-sim/system/Common.hh"
+
+namespace AstraSim {
+
+class Sys;
+
+// Little-endian binary stream of fixed-width values. Errors are fatal.
+class CheckpointWriter {
+  public:
+    explicit CheckpointWriter(const std::string& filename);
+    void write_u64(uint64_t value);
+    void write_i64(int64_t value);
+    void write_double(double value);
+    void write_string(const std::string& value);
+    template <typename T>
+    void write_optional(const std::optional<T>& value) {
+        write_u64(value.has_value());
+        if (value.has_value()) {
+            write_value(value.value());
+        }
+    }
+    // flushes and atomically replaces the target file
+    void commit();
+
+  private:
+    void write_value(uint64_t value) {
+        write_u64(value);
+    }
+    void write_value(double value) {
+        write_double(value);
+    }
+    void write_value(bool value) {
+        write_u64(value);
+    }
+
+    std::string filename;
+    std::string tmp_filename;
+    std::ofstream out;
+};
+
+class CheckpointReader {
+  public:
+    explicit CheckpointReader(const std::string& filename);
+    uint64_t read_u64();
+    int64_t read_i64();
+    double read_double();
+    std::string read_string();
+    template <typename T>
+    std::optional<T> read_optional() {
+        if (read_u64() == 0) {
+            return std::nullopt;
+        }
+        return read_value(T());
+    }
+
+  private:
+    uint64_t read_value(uint64_t) {
+        return read_u64();
+    }
+    double read_value(double) {
+        return read_double();
+    }
+    bool read_value(bool) {
+        return read_u64() != 0;
+    }
+
+    std::string filename;
+    std::ifstream in;
+};
+
+// Snapshot of a whole simulation, taken at a tick where no communication is
+// in flight: no collective streams, no send/recv nodes and no pending events
+// other than compute/replay node completions. At such a point the state of a
+// rank reduces to its workload progress, counters and statistics, plus the
+// completion ticks of running compute nodes, all of which can be rebuilt on
+// fresh Sys/Workload objects. Backends additionally check that they have no
+// chunk in flight before saving.
+class Checkpoint {
+  public:
+    // Makes the given systems keep the progress a checkpoint saves. Call
+    // before the simulation starts if checkpoints are saved. Systems with
+    // streaming-execution are left out, so no checkpoint is ever saved.
+    static void enable(const std::vector<Sys*>& systems);
+
+    // Whether all given systems can be saved at the current tick.
+    static bool is_quiescent(const std::vector<Sys*>& systems);
+
+    static void save(const std::string& filename,
+                     Tick tick,
+                     const std::vector<Sys*>& systems);
+
+    // Opens a checkpoint and returns the tick it was taken at. The backend
+    // clock has to be advanced to that tick before calling restore().
+    static Tick load_tick(CheckpointReader& reader,
+                          const std::vector<Sys*>& systems);
+
+    // Rebuilds the state of the given systems. Call instead of
+    // Workload::fire().
+    static void restore(CheckpointReader& reader,
+                        const std::vector<Sys*>& systems);
+};
+
+}  // namespace AstraSim
+
+#endif /* __CHECKPOINT_HH__ */
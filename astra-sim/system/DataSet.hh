@@ -6,6 +6,8 @@ LICENSE file in the root directory of this source tree.
 #ifndef __DATASET_HH__
 #define __DATASET_HH__
 
+#include <atomic>
+
 #include "astra-sim/system/CallData.hh"
 #include "astra-sim/system/Callable.hh"
 #include "astra-sim/system/Common.hh"
@@ -21,7 +23,7 @@ class DataSet : public Callable, public StreamStat {
     void call(EventType event, CallData* data);
     bool is_finished();
 
-    static int id_auto_increment;
+    static std::atomic<int> id_auto_increment;
     int my_id;
     int total_streams;
     int finished_streams;
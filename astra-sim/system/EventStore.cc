@@ -0,0 +1,140 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "astra-sim/system/EventStore.hh"
+
+using namespace std;
+using namespace AstraSim;
+
+EventStore* EventStore::create(const string& type, uint64_t buckets) {
+    if (type == "map") {
+        return new MapEventStore();
+    } else if (type == "calendar") {
+        return new CalendarEventStore(buckets);
+    }
+    return nullptr;
+}
+
+// MapEventStore --------------------------------------------------------------
+bool MapEventStore::insert(Tick tick,
+                           Callable* callable,
+                           EventType event,
+                           CallData* data) {
+    auto& bucket = buckets[tick];
+    bucket.push_back({callable, event, data});
+    return bucket.size() == 1;
+}
+
+vector<PendingEvent>* MapEventStore::find(Tick tick) {
+    auto it = buckets.find(tick);
+    if (it == buckets.end()) {
+        return nullptr;
+    }
+    return &it->second;
+}
+
+void MapEventStore::release(Tick tick) {
+    buckets.erase(tick);
+}
+
+void MapEventStore::collect(vector<pair<Tick, PendingEvent>>& events) const {
+    for (const auto& bucket : buckets) {
+        for (const auto& event : bucket.second) {
+            events.push_back({bucket.first, event});
+        }
+    }
+}
+//-----------------------------------------------------------------------------
+
+// CalendarEventStore ---------------------------------------------------------
+CalendarEventStore::CalendarEventStore(uint64_t buckets) {
+    // round up to a power of two so that the slot index is a mask
+    uint64_t size = 1;
+    while (size < buckets) {
+        size <<= 1;
+    }
+    this->ring.resize(size);
+    this->mask = size - 1;
+}
+
+bool CalendarEventStore::insert(Tick tick,
+                                Callable* callable,
+                                EventType event,
+                                CallData* data) {
+    // a tick that already spilled keeps using its overflow bucket, even if
+    // its slot has been freed in the meantime
+    if (!overflow.empty()) {
+        auto it = overflow.find(tick);
+        if (it != overflow.end()) {
+            it->second.push_back({callable, event, data});
+            return false;
+        }
+    }
+
+    Slot& slot = ring[tick & mask];
+    if (slot.events.empty()) {
+        slot.tick = tick;
+        slot.events.push_back({callable, event, data});
+        return true;
+    }
+    if (slot.tick == tick) {
+        slot.events.push_back({callable, event, data});
+        return false;
+    }
+
+    // slot is owned by another pending tick
+    auto& bucket = overflow[tick];
+    if (!spare.empty()) {
+        bucket.swap(spare.back());
+        spare.pop_back();
+    }
+    bucket.push_back({callable, event, data});
+    return true;
+}
+
+vector<PendingEvent>* CalendarEventStore::find(Tick tick) {
+    Slot& slot = ring[tick & mask];
+    if (slot.tick == tick && !slot.events.empty()) {
+        return &slot.events;
+    }
+    if (!overflow.empty()) {
+        auto it = overflow.find(tick);
+        if (it != overflow.end()) {
+            return &it->second;
+        }
+    }
+    return nullptr;
+}
+
+void CalendarEventStore::release(Tick tick) {
+    Slot& slot = ring[tick & mask];
+    if (slot.tick == tick && !slot.events.empty()) {
+        slot.events.clear();
+        return;
+    }
+    if (!overflow.empty()) {
+        auto it = overflow.find(tick);
+        if (it != overflow.end()) {
+            it->second.clear();
+            spare.push_back(std::move(it->second));
+            overflow.erase(it);
+        }
+    }
+}
+
+void CalendarEventStore::collect(
+    vector<pair<Tick, PendingEvent>>& events) const {
+    for (const auto& slot : ring) {
+        for (const auto& event : slot.events) {
+            events.push_back({slot.tick, event});
+        }
+    }
+    for (const auto& bucket : overflow) {
+        for (const auto& event : bucket.second) {
+            events.push_back({bucket.first, event});
+        }
+    }
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,107 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#ifndef __EVENT_STORE_HH__
+#define __EVENT_STORE_HH__
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "astra-sim/system/CallData.hh"
+#include "astra-sim/system/Callable.hh"
+#include "astra-sim/system/Common.hh"
+
+namespace AstraSim {
+
+// One pending callback registered through Sys::try_register_event.
+struct PendingEvent {
+    Callable* callable;
+    EventType event;
+    CallData* data;
+};
+
+// Per-Sys storage of pending events, grouped by the tick they fire at.
+// Events of the same tick are kept in registration order. Events registered
+// for a tick while that tick is being drained are appended to the same
+// bucket, so call_events() observes them in the same pass.
+class EventStore {
+  public:
+    virtual ~EventStore() = default;
+
+    // Appends an event to the bucket of the given tick. Returns true if the
+    // bucket was empty, i.e. the caller has to schedule a backend event.
+    virtual bool insert(Tick tick,
+                        Callable* callable,
+                        EventType event,
+                        CallData* data) = 0;
+
+    // Returns the bucket of the given tick, or nullptr if nothing is pending.
+    // The returned vector stays valid until release() is called on the tick,
+    // even if more events are inserted for the same tick in the meantime.
+    virtual std::vector<PendingEvent>* find(Tick tick) = 0;
+
+    // Drops the bucket of the given tick.
+    virtual void release(Tick tick) = 0;
+
+    // Appends every pending event and its tick to the given vector, in no
+    // particular order of ticks.
+    virtual void collect(
+        std::vector<std::pair<Tick, PendingEvent>>& events) const = 0;
+
+    static EventStore* create(const std::string& type, uint64_t buckets);
+};
+
+// Ordered map from tick to bucket.
+class MapEventStore : public EventStore {
+  public:
+    bool insert(Tick tick,
+                Callable* callable,
+                EventType event,
+                CallData* data) override;
+    std::vector<PendingEvent>* find(Tick tick) override;
+    void release(Tick tick) override;
+    void collect(
+        std::vector<std::pair<Tick, PendingEvent>>& events) const override;
+
+  private:
+    std::map<Tick, std::vector<PendingEvent>> buckets;
+};
+
+// Calendar queue: a power-of-two ring of per-tick buckets indexed by
+// tick % ring size. A slot is owned by one tick at a time; a tick whose slot
+// is taken by another pending tick (i.e. one that is at least a full ring
+// away) spills into an overflow table. Bucket vectors keep their capacity
+// once drained so steady-state registration does not allocate.
+class CalendarEventStore : public EventStore {
+  public:
+    explicit CalendarEventStore(uint64_t buckets);
+    bool insert(Tick tick,
+                Callable* callable,
+                EventType event,
+                CallData* data) override;
+    std::vector<PendingEvent>* find(Tick tick) override;
+    void release(Tick tick) override;
+    void collect(
+        std::vector<std::pair<Tick, PendingEvent>>& events) const override;
+
+  private:
+    struct Slot {
+        Tick tick;
+        std::vector<PendingEvent> events;
+    };
+
+    std::vector<Slot> ring;
+    uint64_t mask;
+    std::unordered_map<Tick, std::vector<PendingEvent>> overflow;
+    std::vector<std::vector<PendingEvent>> spare;
+};
+
+}  // namespace AstraSim
+
+#endif /* __EVENT_STORE_HH__ */
@@ -48,10 +48,11 @@ void MemBus::send_from_NPU_to_MA(MemBus::Transmition transmition,
         NPU_side->request_read(bytes, processed, send_back, callable);
     } else {
         if (transmition == Transmition::Fast) {
-            SharedBusStat* ss = new SharedBusStat(BusType::Shared, 0, 10, 0, 0);
+            SharedBusStat* ss =
+                new SharedBusStat(BusType::Shared, 0, fast_delay, 0, 0);
             ss->sys_id = sys->id;
             ss->event = EventType::NPU_to_MA;
-            sys->register_event(callable, EventType::NPU_to_MA, ss, 10);
+            sys->register_event(callable, EventType::NPU_to_MA, ss, fast_delay);
         } else {
             SharedBusStat* ss = new SharedBusStat(BusType::Shared, 0,
                                                   communication_delay, 0, 0);
@@ -72,10 +73,11 @@ void MemBus::send_from_MA_to_NPU(MemBus::Transmition transmition,
         MA_side->request_read(bytes, processed, send_back, callable);
     } else {
         if (transmition == Transmition::Fast) {
-            SharedBusStat* ss = new SharedBusStat(BusType::Shared, 0, 10, 0, 0);
+            SharedBusStat* ss =
+                new SharedBusStat(BusType::Shared, 0, fast_delay, 0, 0);
             ss->sys_id = sys->id;
             ss->event = EventType::MA_to_NPU;
-            sys->register_event(callable, EventType::MA_to_NPU, ss, 10);
+            sys->register_event(callable, EventType::MA_to_NPU, ss, fast_delay);
         } else {
             SharedBusStat* ss = new SharedBusStat(BusType::Shared, 0,
                                                   communication_delay, 0, 0);
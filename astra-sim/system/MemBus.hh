@@ -19,6 +19,9 @@ class MemBus {
   public:
     enum class Transmition { Fast, Usual };
 
+    // delay of a Transmition::Fast transfer
+    static constexpr Tick fast_delay = 10;
+
     MemBus(std::string side1,
            std::string side2,
            Sys* sys,
@@ -6,6 +6,7 @@ LICENSE file in the root directory of this source tree.
 #ifndef __MEM_EVENT_HANDLER_DATA_HH__
 #define __MEM_EVENT_HANDLER_DATA_HH__
 
+#include "astra-sim/common/ObjectPool.hh"
 #include "astra-sim/system/BasicEventHandlerData.hh"
 
 namespace AstraSim {
@@ -15,6 +16,13 @@ class WorkloadLayerHandlerData;
 
 class MemEventHandlerData : public BasicEventHandlerData {
   public:
+    static void* operator new(size_t size) {
+        return ObjectPool<MemEventHandlerData>::allocate(size);
+    }
+    static void operator delete(void* ptr, size_t size) {
+        ObjectPool<MemEventHandlerData>::deallocate(ptr, size);
+    }
+
     MemEventHandlerData();
     Workload* workload;
     WorkloadLayerHandlerData* wlhd;
@@ -6,6 +6,8 @@ LICENSE file in the root directory of this source tree.
 #ifndef __MEM_MOV_REQUEST_HH__
 #define __MEM_MOV_REQUEST_HH__
 
+#include <atomic>
+
 #include "astra-sim/system/Callable.hh"
 #include "astra-sim/system/Common.hh"
 #include "astra-sim/system/SharedBusStat.hh"
@@ -30,7 +32,7 @@ class MemMovRequest : public Callable, public SharedBusStat {
     }
     void call(EventType event, CallData* data);
 
-    static int id;
+    static std::atomic<int> id;
     int my_id;
     int size;
     int latency;
@@ -0,0 +1,231 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "astra-sim/system/NetworkTrace.hh"
+
+#include <cstdlib>
+
+#include "astra-sim/common/Logging.hh"
+#include "astra-sim/common/ObjectPool.hh"
+#include "astra-sim/system/Sys.hh"
+
+using namespace std;
+using namespace AstraSim;
+
+namespace {
+constexpr uint64_t NETWORK_TRACE_MAGIC = 0x4352544e54534141ULL;  // "AASTNTRC"
+constexpr uint64_t NETWORK_TRACE_VERSION = 1;
+constexpr size_t NETWORK_TRACE_RECORD_BYTES = 36;
+constexpr size_t NETWORK_TRACE_BUFFER_BYTES = 1 << 20;
+
+NetworkTraceWriter* network_trace_writer = nullptr;
+
+void put_bytes(unsigned char* out, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        out[i] = static_cast<unsigned char>(value >> (8 * i));
+    }
+}
+
+uint64_t get_bytes(const unsigned char* in, int bytes) {
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; i++) {
+        value |= static_cast<uint64_t>(in[i]) << (8 * i);
+    }
+    return value;
+}
+}  // namespace
+
+// NetworkTraceWriter ---------------------------------------------------------
+NetworkTraceWriter* NetworkTraceWriter::open(const string& filename) {
+    if (network_trace_writer == nullptr) {
+        network_trace_writer = new NetworkTraceWriter(filename);
+        // frontends that never delete their Sys objects still get the tail
+        atexit(NetworkTraceWriter::close);
+    } else if (network_trace_writer->filename != filename) {
+        Sys::sys_panic("All ranks have to record to the same network trace");
+    }
+    return network_trace_writer;
+}
+
+void NetworkTraceWriter::close() {
+    delete network_trace_writer;
+    network_trace_writer = nullptr;
+}
+
+NetworkTraceWriter::NetworkTraceWriter(const string& filename)
+    : filename(filename), records_count(0) {
+    file = fopen(filename.c_str(), "wb");
+    if (file == nullptr) {
+        Sys::sys_panic("Unable to open network trace file " + filename);
+    }
+    buffer.reserve(NETWORK_TRACE_BUFFER_BYTES);
+
+    unsigned char header[16];
+    put_bytes(header, NETWORK_TRACE_MAGIC, 8);
+    put_bytes(header + 8, NETWORK_TRACE_VERSION, 8);
+    buffer.insert(buffer.end(), header, header + sizeof(header));
+}
+
+NetworkTraceWriter::~NetworkTraceWriter() {
+    flush();
+    fclose(file);
+    LoggerFactory::get_logger("system")->info(
+        "{} messages recorded to network trace {}", records_count, filename);
+}
+
+void NetworkTraceWriter::append(const NetworkTraceRecord& record) {
+    unsigned char bytes[NETWORK_TRACE_RECORD_BYTES];
+    put_bytes(bytes, static_cast<uint32_t>(record.src), 4);
+    put_bytes(bytes + 4, static_cast<uint32_t>(record.dst), 4);
+    put_bytes(bytes + 8, static_cast<uint32_t>(record.tag), 4);
+    put_bytes(bytes + 12, record.size, 8);
+    put_bytes(bytes + 20, record.issue_tick, 8);
+    put_bytes(bytes + 28, record.latency_ns, 8);
+
+    lock_guard<mutex> lock(buffer_mutex);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(bytes));
+    records_count++;
+    if (buffer.size() >= NETWORK_TRACE_BUFFER_BYTES) {
+        flush();
+    }
+}
+
+void NetworkTraceWriter::flush() {
+    if (fwrite(buffer.data(), 1, buffer.size(), file) != buffer.size()) {
+        Sys::sys_panic("Unable to write network trace file " + filename);
+    }
+    buffer.clear();
+}
+//-----------------------------------------------------------------------------
+
+// NetworkTraceReader ---------------------------------------------------------
+vector<NetworkTraceRecord> NetworkTraceReader::load(const string& filename) {
+    FILE* file = fopen(filename.c_str(), "rb");
+    if (file == nullptr) {
+        Sys::sys_panic("Unable to open network trace file " + filename);
+    }
+
+    unsigned char header[16];
+    if (fread(header, 1, sizeof(header), file) != sizeof(header) ||
+        get_bytes(header, 8) != NETWORK_TRACE_MAGIC) {
+        Sys::sys_panic("Not a network trace file: " + filename);
+    }
+    if (get_bytes(header + 8, 8) != NETWORK_TRACE_VERSION) {
+        Sys::sys_panic("Unsupported network trace version: " + filename);
+    }
+
+    vector<NetworkTraceRecord> records;
+    unsigned char bytes[NETWORK_TRACE_RECORD_BYTES];
+    while (fread(bytes, 1, sizeof(bytes), file) == sizeof(bytes)) {
+        NetworkTraceRecord record;
+        record.src = static_cast<int32_t>(get_bytes(bytes, 4));
+        record.dst = static_cast<int32_t>(get_bytes(bytes + 4, 4));
+        record.tag = static_cast<int32_t>(get_bytes(bytes + 8, 4));
+        record.size = get_bytes(bytes + 12, 8);
+        record.issue_tick = get_bytes(bytes + 20, 8);
+        record.latency_ns = get_bytes(bytes + 28, 8);
+        records.push_back(record);
+    }
+    fclose(file);
+    return records;
+}
+//-----------------------------------------------------------------------------
+
+// RecordingNetworkApi --------------------------------------------------------
+RecordingNetworkApi::RecordingNetworkApi(AstraNetworkAPI* backend,
+                                         NetworkTraceWriter* writer)
+    : AstraNetworkAPI(backend->sim_comm_get_rank()),
+      backend(backend),
+      writer(writer) {}
+
+int RecordingNetworkApi::sim_send(void* buffer,
+                                  uint64_t count,
+                                  int type,
+                                  int dst,
+                                  int tag,
+                                  sim_request* request,
+                                  void (*msg_handler)(void* fun_arg),
+                                  void* fun_arg) {
+    PendingSend* pending = ObjectPool<PendingSend>::create();
+    pending->api = this;
+    pending->record = {backend->sim_comm_get_rank(), dst, tag, count,
+                       backend->sim_get_tick(), 0};
+    pending->issue_ns = backend->sim_get_time().time_val;
+    pending->msg_handler = msg_handler;
+    pending->fun_arg = fun_arg;
+    return backend->sim_send(buffer, count, type, dst, tag, request,
+                             &RecordingNetworkApi::send_finished, pending);
+}
+
+void RecordingNetworkApi::send_finished(void* fun_arg) {
+    PendingSend* pending = static_cast<PendingSend*>(fun_arg);
+    RecordingNetworkApi* api = pending->api;
+    double latency_ns =
+        api->backend->sim_get_time().time_val - pending->issue_ns;
+    pending->record.latency_ns =
+        latency_ns > 0 ? static_cast<uint64_t>(latency_ns + 0.5) : 0;
+    api->writer->append(pending->record);
+
+    void (*msg_handler)(void*) = pending->msg_handler;
+    void* handler_arg = pending->fun_arg;
+    ObjectPool<PendingSend>::destroy(pending);
+    msg_handler(handler_arg);
+}
+
+int RecordingNetworkApi::sim_recv(void* buffer,
+                                  uint64_t count,
+                                  int type,
+                                  int src,
+                                  int tag,
+                                  sim_request* request,
+                                  void (*msg_handler)(void* fun_arg),
+                                  void* fun_arg) {
+    return backend->sim_recv(buffer, count, type, src, tag, request,
+                             msg_handler, fun_arg);
+}
+
+int RecordingNetworkApi::sim_recv_batch(vector<BatchMessage>& messages) {
+    return backend->sim_recv_batch(messages);
+}
+
+void RecordingNetworkApi::sim_schedule(timespec_t delta,
+                                       void (*fun_ptr)(void* fun_arg),
+                                       void* fun_arg) {
+    backend->sim_schedule(delta, fun_ptr, fun_arg);
+}
+
+AstraNetworkAPI::BackendType RecordingNetworkApi::get_backend_type() {
+    return backend->get_backend_type();
+}
+
+int RecordingNetworkApi::sim_comm_get_rank() {
+    return backend->sim_comm_get_rank();
+}
+
+int RecordingNetworkApi::sim_comm_set_rank(int rank) {
+    this->rank = backend->sim_comm_set_rank(rank);
+    return this->rank;
+}
+
+timespec_t RecordingNetworkApi::sim_get_time() {
+    return backend->sim_get_time();
+}
+
+Tick RecordingNetworkApi::sim_get_tick() {
+    return backend->sim_get_tick();
+}
+
+double RecordingNetworkApi::get_BW_at_dimension(int dim) {
+    return backend->get_BW_at_dimension(dim);
+}
+
+double RecordingNetworkApi::get_send_delay(int src, int dst, uint64_t count) {
+    return backend->get_send_delay(src, dst, count);
+}
+
+void RecordingNetworkApi::sim_notify_finished() {
+    backend->sim_notify_finished();
+}
+//-----------------------------------------------------------------------------
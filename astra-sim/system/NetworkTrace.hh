@@ -0,0 +1,112 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#ifndef __NETWORK_TRACE_HH__
+#define __NETWORK_TRACE_HH__
+
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "astra-sim/common/AstraNetworkAPI.hh"
+
+namespace AstraSim {
+
+// One message of a network trace: a sim_send issued at issue_tick whose send
+// handler ran latency_ns later.
+struct NetworkTraceRecord {
+    int src;
+    int dst;
+    int tag;
+    uint64_t size;
+    Tick issue_tick;
+    uint64_t latency_ns;
+};
+
+// Binary network trace: a header followed by fixed-size little-endian
+// records of 36 bytes. All ranks of a simulation append to the same file.
+class NetworkTraceWriter {
+  public:
+    // Returns the writer of the given file, opening it on the first call.
+    static NetworkTraceWriter* open(const std::string& filename);
+    // Writes the buffered records and closes the file.
+    static void close();
+
+    void append(const NetworkTraceRecord& record);
+
+  private:
+    explicit NetworkTraceWriter(const std::string& filename);
+    ~NetworkTraceWriter();
+    void flush();
+
+    std::string filename;
+    FILE* file;
+    std::vector<unsigned char> buffer;
+    // ranks may run on different threads
+    std::mutex buffer_mutex;
+    uint64_t records_count;
+};
+
+class NetworkTraceReader {
+  public:
+    static std::vector<NetworkTraceRecord> load(const std::string& filename);
+};
+
+// AstraNetworkAPI that forwards every call to the backend of a rank and
+// records each sim_send in a network trace once its send handler runs.
+class RecordingNetworkApi : public AstraNetworkAPI {
+  public:
+    RecordingNetworkApi(AstraNetworkAPI* backend, NetworkTraceWriter* writer);
+
+    int sim_send(void* buffer,
+                 uint64_t count,
+                 int type,
+                 int dst,
+                 int tag,
+                 sim_request* request,
+                 void (*msg_handler)(void* fun_arg),
+                 void* fun_arg) override;
+    int sim_recv(void* buffer,
+                 uint64_t count,
+                 int type,
+                 int src,
+                 int tag,
+                 sim_request* request,
+                 void (*msg_handler)(void* fun_arg),
+                 void* fun_arg) override;
+    int sim_recv_batch(std::vector<BatchMessage>& messages) override;
+    void sim_schedule(timespec_t delta,
+                      void (*fun_ptr)(void* fun_arg),
+                      void* fun_arg) override;
+    BackendType get_backend_type() override;
+    int sim_comm_get_rank() override;
+    int sim_comm_set_rank(int rank) override;
+    timespec_t sim_get_time() override;
+    Tick sim_get_tick() override;
+    double get_BW_at_dimension(int dim) override;
+    double get_send_delay(int src, int dst, uint64_t count) override;
+    void sim_notify_finished() override;
+
+  private:
+    // sim_send waiting for its send handler
+    struct PendingSend {
+        RecordingNetworkApi* api;
+        NetworkTraceRecord record;
+        double issue_ns;
+        void (*msg_handler)(void* fun_arg);
+        void* fun_arg;
+    };
+
+    static void send_finished(void* fun_arg);
+
+    AstraNetworkAPI* backend;
+    NetworkTraceWriter* writer;
+};
+
+}  // namespace AstraSim
+
+#endif /* __NETWORK_TRACE_HH__ */
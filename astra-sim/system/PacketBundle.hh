@@ -6,6 +6,7 @@ LICENSE file in the root directory of this source tree.
 #ifndef __PACKET_BUNDLE_HH__
 #define __PACKET_BUNDLE_HH__
 
+#include "astra-sim/common/ObjectPool.hh"
 #include "astra-sim/system/BaseStream.hh"
 #include "astra-sim/system/Callable.hh"
 #include "astra-sim/system/Common.hh"
@@ -17,6 +18,13 @@ namespace AstraSim {
 class Sys;
 class PacketBundle : public Callable {
   public:
+    static void* operator new(size_t size) {
+        return ObjectPool<PacketBundle>::allocate(size);
+    }
+    static void operator delete(void* ptr, size_t size) {
+        ObjectPool<PacketBundle>::deallocate(ptr, size);
+    }
+
     PacketBundle(Sys* sys,
                  BaseStream* stream,
                  std::list<MyPacket*> locked_packets,
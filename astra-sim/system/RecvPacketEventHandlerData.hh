@@ -6,6 +6,7 @@ LICENSE file in the root directory of this source tree.
 #ifndef __RECV_PACKET_EVENT_HANDLER_DATA_HH__
 #define __RECV_PACKET_EVENT_HANDLER_DATA_HH__
 
+#include "astra-sim/common/ObjectPool.hh"
 #include "astra-sim/system/BaseStream.hh"
 #include "astra-sim/system/BasicEventHandlerData.hh"
 #include "astra-sim/system/astraccl/custom_collectives/CustomAlgorithm.hh"
@@ -16,6 +17,13 @@ class WorkloadLayerHandlerData;
 
 class RecvPacketEventHandlerData : public BasicEventHandlerData {
   public:
+    static void* operator new(size_t size) {
+        return ObjectPool<RecvPacketEventHandlerData>::allocate(size);
+    }
+    static void operator delete(void* ptr, size_t size) {
+        ObjectPool<RecvPacketEventHandlerData>::deallocate(ptr, size);
+    }
+
     RecvPacketEventHandlerData();
     RecvPacketEventHandlerData(BaseStream* owner,
                                int sys_id,
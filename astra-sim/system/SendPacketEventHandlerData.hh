@@ -6,6 +6,7 @@ LICENSE file in the root directory of this source tree.
 #ifndef __SEND_PACKET_EVENT_HANDLER_DATA_HH__
 #define __SEND_PACKET_EVENT_HANDLER_DATA_HH__
 
+#include "astra-sim/common/ObjectPool.hh"
 #include "astra-sim/system/BasicEventHandlerData.hh"
 #include "astra-sim/system/Callable.hh"
 #include "astra-sim/system/Common.hh"
@@ -15,6 +16,13 @@ namespace AstraSim {
 
 class SendPacketEventHandlerData : public BasicEventHandlerData {
   public:
+    static void* operator new(size_t size) {
+        return ObjectPool<SendPacketEventHandlerData>::allocate(size);
+    }
+    static void operator delete(void* ptr, size_t size) {
+        ObjectPool<SendPacketEventHandlerData>::deallocate(ptr, size);
+    }
+
     int tag;
     Callable* callable;
     WorkloadLayerHandlerData* wlhd;
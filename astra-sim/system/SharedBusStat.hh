@@ -6,12 +6,20 @@ LICENSE file in the root directory of this source tree.
 #ifndef __SHARED_BUS_STAT_HH__
 #define __SHARED_BUS_STAT_HH__
 
+#include "astra-sim/common/ObjectPool.hh"
 #include "astra-sim/system/BasicEventHandlerData.hh"
 
 namespace AstraSim {
 
 class SharedBusStat : public BasicEventHandlerData {
   public:
+    static void* operator new(size_t size) {
+        return ObjectPool<SharedBusStat>::allocate(size);
+    }
+    static void operator delete(void* ptr, size_t size) {
+        ObjectPool<SharedBusStat>::deallocate(ptr, size);
+    }
+
     SharedBusStat(BusType busType,
                   double total_bus_transfer_queue_delay,
                   double total_bus_transfer_delay,
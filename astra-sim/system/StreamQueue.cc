@@ -0,0 +1,151 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "astra-sim/system/StreamQueue.hh"
+
+#include <algorithm>
+#include <limits>
+
+#include "astra-sim/system/BaseStream.hh"
+
+using namespace std;
+using namespace AstraSim;
+
+StreamQueue::StreamQueue() {
+    this->order_violations = 0;
+    this->cursor = streams.end();
+    this->cursor_index = 0;
+}
+
+StreamQueue::iterator StreamQueue::begin() {
+    return streams.begin();
+}
+
+StreamQueue::iterator StreamQueue::end() {
+    return streams.end();
+}
+
+BaseStream* StreamQueue::front() {
+    return streams.front();
+}
+
+size_t StreamQueue::size() const {
+    return streams.size();
+}
+
+bool StreamQueue::empty() const {
+    return streams.empty();
+}
+
+int64_t StreamQueue::order_key(const BaseStream* stream) {
+    if (stream->initialized) {
+        return numeric_limits<int64_t>::max();
+    }
+    return stream->priority;
+}
+
+void StreamQueue::count_pair(iterator first, iterator second, int64_t sign) {
+    if (first == streams.end() || second == streams.end()) {
+        return;
+    }
+    if (order_key(*first) < order_key(*second)) {
+        order_violations += sign;
+    }
+}
+
+void StreamQueue::count_pairs_around(iterator position, int64_t sign) {
+    if (position != streams.begin()) {
+        count_pair(prev(position), position, sign);
+    }
+    count_pair(position, next(position), sign);
+}
+
+StreamQueue::iterator StreamQueue::insert(iterator position,
+                                          BaseStream* stream) {
+    if (position != streams.begin()) {
+        count_pair(prev(position), position, -1);
+    }
+    iterator it = streams.insert(position, stream);
+    count_pairs_around(it, 1);
+    // keep the cursor on the same index
+    stream->before_cursor = false;
+    if (position == cursor) {
+        cursor = it;
+    } else if (position != streams.end() && (*position)->before_cursor) {
+        stream->before_cursor = true;
+        cursor_index++;
+    }
+    return it;
+}
+
+StreamQueue::iterator StreamQueue::erase(iterator position) {
+    count_pairs_around(position, -1);
+    // keep the cursor on the same index
+    if (position == cursor) {
+        cursor = next(cursor);
+    } else if ((*position)->before_cursor) {
+        cursor_index--;
+    }
+    iterator it = streams.erase(position);
+    if (it != streams.begin()) {
+        count_pair(prev(it), it, 1);
+    }
+    return it;
+}
+
+void StreamQueue::pop_front() {
+    erase(streams.begin());
+}
+
+StreamQueue::iterator StreamQueue::at(size_t index) {
+    index = min(index, streams.size());
+    while (cursor_index < index) {
+        (*cursor)->before_cursor = true;
+        ++cursor;
+        cursor_index++;
+    }
+    while (cursor_index > index) {
+        --cursor;
+        cursor_index--;
+        (*cursor)->before_cursor = false;
+    }
+    return cursor;
+}
+
+void StreamQueue::init_stream(iterator position) {
+    count_pairs_around(position, -1);
+    (*position)->initialized = true;
+    count_pairs_around(position, 1);
+    (*position)->init();
+}
+
+StreamQueue::iterator StreamQueue::find_fifo_position(int priority) {
+    if (order_violations != 0) {
+        iterator it = streams.begin();
+        while (it != streams.end() && order_key(*it) >= priority) {
+            ++it;
+        }
+        return it;
+    }
+    // keys are non-increasing, so the answer is the boundary between keys
+    // >= priority and keys < priority; close in on it from both ends
+    iterator front_it = streams.begin();
+    iterator back_it = streams.end();
+    while (front_it != back_it) {
+        if (order_key(*front_it) < priority) {
+            return front_it;
+        }
+        ++front_it;
+        if (front_it == back_it) {
+            break;
+        }
+        iterator last = prev(back_it);
+        if (order_key(*last) >= priority) {
+            return back_it;
+        }
+        back_it = last;
+    }
+    return front_it;
+}
@@ -0,0 +1,72 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#ifndef __STREAM_QUEUE_HH__
+#define __STREAM_QUEUE_HH__
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+
+namespace AstraSim {
+
+class BaseStream;
+
+// Ordered queue of streams used for the ready list and the per-queue active
+// lists of Sys. Besides the list itself it keeps the number of adjacent pairs
+// that break the FIFO ordering (initialized streams first, then uninitialized
+// streams by non-increasing priority). While that count is zero, the FIFO
+// insertion point can be searched from both ends at once instead of walking
+// the whole list from the front. It also keeps a cursor on the stream at a
+// given index, so looking up an index close to the previous one does not
+// walk from the front either.
+class StreamQueue {
+  public:
+    typedef std::list<BaseStream*>::iterator iterator;
+
+    StreamQueue();
+    // the cursor points into this queue's own list, so it can not be copied
+    // or moved along with the streams
+    StreamQueue(const StreamQueue&) = delete;
+    StreamQueue& operator=(const StreamQueue&) = delete;
+
+    iterator begin();
+    iterator end();
+    BaseStream* front();
+    size_t size() const;
+    bool empty() const;
+
+    iterator insert(iterator position, BaseStream* stream);
+    iterator erase(iterator position);
+    void pop_front();
+
+    // Returns the position of the stream at index (end() if index >= size()).
+    // Costs the distance from the previously looked up index.
+    iterator at(size_t index);
+
+    // Marks the stream at position as initialized and calls its init().
+    void init_stream(iterator position);
+
+    // Returns the first position whose stream is neither initialized nor of
+    // priority >= the given priority (end() if none), exactly like a linear
+    // walk from the front would.
+    iterator find_fifo_position(int priority);
+
+  private:
+    static int64_t order_key(const BaseStream* stream);
+    void count_pairs_around(iterator position, int64_t sign);
+    void count_pair(iterator first, iterator second, int64_t sign);
+
+    std::list<BaseStream*> streams;
+    int64_t order_violations;
+    // position of the last looked up index; the streams before it have
+    // before_cursor set
+    iterator cursor;
+    size_t cursor_index;
+};
+
+}  // namespace AstraSim
+
+#endif /* __STREAM_QUEUE_HH__ */
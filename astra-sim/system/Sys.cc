@@ -9,11 +9,14 @@ LICENSE file in the root directory of this source tree.
 #include <iostream>
 
 #include "astra-sim/common/Logging.hh"
+#include "astra-sim/common/ObjectPool.hh"
 #include "astra-sim/system/BaseStream.hh"
+#include "astra-sim/system/Checkpoint.hh"
 #include "astra-sim/system/CollectivePlan.hh"
 #include "astra-sim/system/DataSet.hh"
 #include "astra-sim/system/MemBus.hh"
 #include "astra-sim/system/MemEventHandlerData.hh"
+#include "astra-sim/system/NetworkTrace.hh"
 #include "astra-sim/system/QueueLevels.hh"
 #include "astra-sim/system/RendezvousRecvData.hh"
 #include "astra-sim/system/RendezvousSendData.hh"
@@ -21,9 +24,11 @@ LICENSE file in the root directory of this source tree.
 #include "astra-sim/system/SimRecvCaller.hh"
 #include "astra-sim/system/SimSendCaller.hh"
 #include "astra-sim/system/StreamBaseline.hh"
+#include "astra-sim/system/TickMultiplexer.hh"
 #include "astra-sim/system/WorkloadLayerHandlerData.hh"
 #include "astra-sim/system/astraccl/custom_collectives/CustomAlgorithm.hh"
 #include "astra-sim/system/astraccl/native_collectives/collective_algorithm/AllToAll.hh"
+#include "astra-sim/system/astraccl/native_collectives/collective_algorithm/ClosedFormCollective.hh"
 #include "astra-sim/system/astraccl/native_collectives/collective_algorithm/DoubleBinaryTreeAllReduce.hh"
 #include "astra-sim/system/astraccl/native_collectives/collective_algorithm/HalvingDoubling.hh"
 #include "astra-sim/system/astraccl/native_collectives/collective_algorithm/HyperCube.hh"
@@ -43,6 +48,9 @@ using json = nlohmann::json;
 namespace AstraSim {
 uint8_t* Sys::dummy_data = new uint8_t[2];
 vector<Sys*> Sys::all_sys;
+thread_local Tick Sys::cached_tick = 0;
+thread_local int Sys::clock_depth = 0;
+thread_local AstraNetworkAPI* Sys::clock_source = nullptr;
 
 // SchedulerUnit --------------------------------------------------------------
 Sys::SchedulerUnit::SchedulerUnit(Sys* sys,
@@ -63,7 +71,7 @@ Sys::SchedulerUnit::SchedulerUnit(Sys* sys,
     for (auto q : queues) {
         for (int i = 0; i < q; i++) {
             this->running_streams[base] = 0;
-            list<BaseStream*>::iterator it;
+            StreamQueue::iterator it;
             this->stream_pointer[base] = it;
             this->queue_id_to_dimension[base] = dimension;
             base++;
@@ -79,11 +87,10 @@ void Sys::SchedulerUnit::notify_stream_added(int vnet) {
         ++total_active_chunks_per_dimension[queue_id_to_dimension[vnet]] == 1) {
         usage[queue_id_to_dimension[vnet]].increase_usage();
     }
-    stream_pointer[vnet] = sys->active_Streams[vnet].begin();
-    advance(stream_pointer[vnet], running_streams[vnet]);
+    stream_pointer[vnet] = sys->active_Streams[vnet].at(running_streams[vnet]);
     while (stream_pointer[vnet] != sys->active_Streams[vnet].end() &&
            running_streams[vnet] < queue_threshold) {
-        (*stream_pointer[vnet])->init();
+        sys->active_Streams[vnet].init_stream(stream_pointer[vnet]);
         running_streams[vnet]++;
         advance(stream_pointer[vnet], 1);
     }
@@ -120,11 +127,10 @@ void Sys::SchedulerUnit::notify_stream_removed(int vnet, Tick running_time) {
         }
         sys->schedule(max);
     }
-    stream_pointer[vnet] = sys->active_Streams[vnet].begin();
-    advance(stream_pointer[vnet], running_streams[vnet]);
+    stream_pointer[vnet] = sys->active_Streams[vnet].at(running_streams[vnet]);
     while (stream_pointer[vnet] != sys->active_Streams[vnet].end() &&
            running_streams[vnet] < queue_threshold) {
-        (*stream_pointer[vnet])->init();
+        sys->active_Streams[vnet].init_stream(stream_pointer[vnet]);
         running_streams[vnet]++;
         advance(stream_pointer[vnet], 1);
     }
@@ -192,9 +198,17 @@ Sys::Sys(int id,
     this->active_chunks_per_dimension = 1;
     this->priority_counter = 0;
     this->pending_events = 0;
+    this->event_queue = nullptr;
+    this->event_queue_type = "calendar";
+    this->event_queue_buckets = 256;
+    this->tick_multiplexing = false;
     this->preferred_dataset_splits = 0;
 
     this->last_scheduled_collective = 0;
+    this->collective_engine = CollectiveEngine::MessageLevel;
+    this->validated_phases = 0;
+    this->validation_error_sum = 0;
+    this->validation_max_error = 0;
 
     this->first_phase_streams = 0;
     this->total_running_streams = 0;
@@ -202,11 +216,18 @@ Sys::Sys(int id,
     this->communication_delay = 10;
     this->local_reduction_delay = 1;
 
+    this->recording_network = nullptr;
     if (initialize_sys(system_configuration) == false) {
         sys_panic("Unable to initialize the system layer because the file can "
                   "not be openned");
     }
 
+    if (!network_trace_filename.empty()) {
+        recording_network = new RecordingNetworkApi(
+            comm_NI, NetworkTraceWriter::open(network_trace_filename));
+        this->comm_NI = recording_network;
+    }
+
     // scheduler
     this->physical_dims = physical_dims;
     this->queues_per_dim = queues_per_dim;
@@ -219,8 +240,7 @@ Sys::Sys(int id,
             this->total_nodes *= physical_dims[current_dim];
         }
         for (int j = 0; j < queues_per_dim[current_dim]; j++) {
-            list<BaseStream*> temp;
-            active_Streams[element] = temp;
+            active_Streams.try_emplace(element);
             list<int> pri;
             stream_priorities[element] = pri;
             element++;
@@ -313,6 +333,14 @@ Sys::~Sys() {
         delete offline_greedy;
     }
 
+    if (event_queue != nullptr) {
+        delete event_queue;
+    }
+
+    if (recording_network != nullptr) {
+        delete recording_network;
+    }
+
     bool shouldExit = true;
     for (auto& a : all_sys) {
         if (a != nullptr) {
@@ -322,6 +350,8 @@ Sys::~Sys() {
     }
 
     if (shouldExit) {
+        ObjectPoolRegistry::report();
+        NetworkTraceWriter::close();
         exit_sim_loop("Exiting");
     }
 }
@@ -434,6 +464,18 @@ bool Sys::initialize_sys(string name) {
                 "unknown value for collective optimization in sys input file");
         }
     }
+    if (j.contains("collective-engine")) {
+        string inp_collective_engine = j["collective-engine"];
+        if (inp_collective_engine == "message-level") {
+            collective_engine = CollectiveEngine::MessageLevel;
+        } else if (inp_collective_engine == "closed-form") {
+            collective_engine = CollectiveEngine::ClosedForm;
+        } else if (inp_collective_engine == "validate") {
+            collective_engine = CollectiveEngine::Validate;
+        } else {
+            sys_panic("unknown value for collective engine in sys input file");
+        }
+    }
     if (j.contains("local-reduction-delay")) {
         local_reduction_delay = j["local-reduction-delay"];
     }
@@ -508,11 +550,49 @@ bool Sys::initialize_sys(string name) {
         }
     }
 
+    if (j.contains("event-queue")) {
+        string inp_event_queue = j["event-queue"];
+        event_queue_type = inp_event_queue;
+    }
+    if (j.contains("event-queue-buckets")) {
+        event_queue_buckets = j["event-queue-buckets"];
+        if (event_queue_buckets == 0) {
+            sys_panic("event-queue-buckets should be positive");
+        }
+    }
+    if (j.contains("tick-multiplexing")) {
+        if (j["tick-multiplexing"] != 0) {
+            this->tick_multiplexing = true;
+        } else {
+            this->tick_multiplexing = false;
+        }
+    }
+    event_queue = EventStore::create(event_queue_type, event_queue_buckets);
+    if (event_queue == nullptr) {
+        sys_panic("unknown value for event queue in sys input file");
+    }
+
     this->local_mem_trace_filename = "local_mem_trace";
     if (j.contains("local-mem-trace-filename")) {
         this->local_mem_trace_filename = j["local-mem-trace-filename"];
     }
 
+    if (j.contains("network-trace-record")) {
+        this->network_trace_filename = j["network-trace-record"];
+    }
+
+    this->streaming_execution = false;
+    if (j.contains("streaming-execution")) {
+        if (j["streaming-execution"] != 0) {
+            this->streaming_execution = true;
+        } else {
+            this->streaming_execution = false;
+        }
+    }
+    if (j.contains("streaming-spill-file")) {
+        this->streaming_spill_filename = j["streaming-spill-file"];
+    }
+
     inFile.close();
     return true;
 }
@@ -558,13 +638,43 @@ CollectiveImpl* Sys::generate_collective_impl_from_input(
     }
 }
 
+bool Sys::is_checkpointable() {
+    if (!ready_list.empty() || total_running_streams > 0 ||
+        first_phase_streams > 0) {
+        return false;
+    }
+    for (auto& queue : active_Streams) {
+        if (!queue.second.empty()) {
+            return false;
+        }
+    }
+    return workload->is_checkpointable();
+}
+
+void Sys::checkpoint(CheckpointWriter& writer) {
+    writer.write_i64(num_streams);
+    writer.write_i64(priority_counter);
+    writer.write_u64(last_scheduled_collective);
+    workload->checkpoint(writer);
+}
+
+void Sys::restore(CheckpointReader& reader) {
+    num_streams = reader.read_i64();
+    priority_counter = reader.read_i64();
+    last_scheduled_collective = reader.read_u64();
+    workload->restore(reader);
+}
+
 CollectiveImpl* Sys::generate_custom_collective_impl(
     string chakra_filepath) {
     string filename = chakra_filepath + "." + to_string(id) + ".et";
     return new CustomCollectiveImpl(CollectiveImplType::CustomCollectiveImpl, filename);
 }
 
-Tick Sys::boostedTick() {
+Tick Sys::query_tick() {
+    if (clock_source != nullptr) {
+        return clock_source->sim_get_tick();
+    }
     Sys* ts = all_sys[0];
     if (ts == nullptr) {
         for (uint64_t i = 1; i < all_sys.size(); i++) {
@@ -574,9 +684,7 @@ Tick Sys::boostedTick() {
             }
         }
     }
-    timespec_t tmp = ts->comm_NI->sim_get_time();
-    Tick tick = tmp.time_val / CLOCK_PERIOD;
-    return tick;
+    return ts->comm_NI->sim_get_tick();
 }
 
 void Sys::sys_panic(string msg) {
@@ -593,20 +701,25 @@ void Sys::exit_sim_loop(string msg) {
 void Sys::call(EventType type, CallData* data) {}
 
 void Sys::call_events() {
-    for (auto& callable : event_queue[Sys::boostedTick()]) {
+    Tick current_tick = Sys::boostedTick();
+    vector<PendingEvent>* events = event_queue->find(current_tick);
+    if (events == nullptr) {
+        return;
+    }
+    // callables may register more events for the current tick, which are
+    // appended to the same bucket, so it is walked by index
+    for (size_t i = 0; i < events->size(); i++) {
+        PendingEvent pending = (*events)[i];
         try {
             pending_events--;
-            (get<0>(callable))->call(get<1>(callable), get<2>(callable));
+            pending.callable->call(pending.event, pending.data);
         } catch (const std::exception& e) {
             auto logger = LoggerFactory::get_logger("system");
             logger->critical("warning! a callable is removed before call {}",
                              e.what());
         }
     }
-    if (event_queue[Sys::boostedTick()].size() > 0) {
-        event_queue[Sys::boostedTick()].clear();
-    }
-    event_queue.erase(Sys::boostedTick());
+    event_queue->release(current_tick);
 }
 
 void Sys::register_event(Callable* callable,
@@ -620,15 +733,12 @@ void Sys::try_register_event(Callable* callable,
                              EventType event,
                              CallData* callData,
                              Tick& delta_cycles) {
-    bool should_schedule = false;
     auto event_time = Sys::boostedTick() + delta_cycles;
-    if (event_queue.find(event_time) == event_queue.end()) {
-        list<tuple<Callable*, EventType, CallData*>> tmp;
-        event_queue[event_time] = tmp;
-        should_schedule = true;
-    }
-    event_queue[event_time].push_back(make_tuple(callable, event, callData));
-    if (should_schedule) {
+    bool should_schedule =
+        event_queue->insert(event_time, callable, event, callData);
+    if (should_schedule && tick_multiplexing) {
+        TickMultiplexer::register_tick(this, event_time, delta_cycles);
+    } else if (should_schedule) {
         timespec_t tmp;
         tmp.time_res = NS;
         tmp.time_val = delta_cycles;
@@ -646,6 +756,7 @@ void Sys::handleEvent(void* arg) {
     if (arg == nullptr) {
         return;
     }
+    ClockScope clock_scope;
     BasicEventHandlerData* ehd = (BasicEventHandlerData*)arg;
     int id = ehd->sys_id;
     EventType event = ehd->event;
@@ -1044,6 +1155,14 @@ DataSet* Sys::generate_collective(
                 remain_size = phase.final_data_size;
             }
         }
+        if (collective_engine != CollectiveEngine::MessageLevel) {
+            for (auto& phase : vect) {
+                if (ClosedFormCollective::supports(this, phase.algorithm)) {
+                    phase.algorithm = new ClosedFormCollective(
+                        phase.algorithm, collective_engine);
+                }
+            }
+        }
         if (vect.size() > 0) {
             int stream_id = num_streams++;
             if (communicator_group != nullptr) {
@@ -1286,27 +1405,35 @@ int Sys::get_priority(int explicit_priority) {
 }
 
 void Sys::insert_into_ready_list(BaseStream* stream) {
+    BaseStream* previous_front =
+        ready_list.empty() ? nullptr : ready_list.front();
     insert_stream(&ready_list, stream);
+    ready_list_front_changed(previous_front);
     scheduler_unit->notify_stream_added_into_ready_list();
 }
 
-void Sys::insert_stream(list<BaseStream*>* queue, BaseStream* baseStream) {
-    list<BaseStream*>::iterator it = queue->begin();
+void Sys::ready_list_front_changed(BaseStream* previous_front) {
+    BaseStream* current_front =
+        ready_list.empty() ? nullptr : ready_list.front();
+    if (current_front == previous_front) {
+        return;
+    }
+    lock_guard<mutex> lock(BaseStream::counters_mutex);
+    if (previous_front != nullptr) {
+        BaseStream::ready_counter[previous_front->stream_id]--;
+    }
+    if (current_front != nullptr) {
+        BaseStream::ready_counter[current_front->stream_id]++;
+    }
+}
+
+void Sys::insert_stream(StreamQueue* queue, BaseStream* baseStream) {
+    StreamQueue::iterator it = queue->begin();
     if (intra_dimension_scheduling == IntraDimensionScheduling::FIFO ||
         baseStream->current_queue_id < 0 ||
         baseStream->current_com_type == ComType::All_to_All ||
         baseStream->current_com_type == ComType::All_Reduce) {
-        while (it != queue->end()) {
-            if ((*it)->initialized == true) {
-                advance(it, 1);
-                continue;
-            } else if ((*it)->priority >= baseStream->priority) {
-                advance(it, 1);
-                continue;
-            } else {
-                break;
-            }
-        }
+        it = queue->find_fifo_position(baseStream->priority);
     } else if (intra_dimension_scheduling == IntraDimensionScheduling::RG) {
         ComType one_to_last = ComType::None;
         ComType last = ComType::None;
@@ -1368,25 +1495,30 @@ void Sys::insert_stream(list<BaseStream*>* queue, BaseStream* baseStream) {
             }
         }
     }
-    queue->insert(it, baseStream);
+    baseStream->queue_position = queue->insert(it, baseStream);
 }
 
 void Sys::ask_for_schedule(int max) {
-    if (ready_list.size() == 0 ||
-        ready_list.front()->synchronizer[ready_list.front()->stream_id] <
-            all_sys.size()) {
+    if (ready_list.size() == 0) {
         return;
     }
+    // every rank has to have created the stream and have it at the front of
+    // its ready list; only the last rank to get there passes this check
     int top = ready_list.front()->stream_id;
+    {
+        // ranks on other threads may be creating streams, which resizes
+        // the counters
+        lock_guard<mutex> lock(BaseStream::counters_mutex);
+        if (BaseStream::synchronizer[top] < all_sys.size() ||
+            BaseStream::ready_counter[top] < all_sys.size()) {
+            return;
+        }
+    }
     uint64_t min = ready_list.size();
     if (min > max) {
         min = static_cast<uint64_t>(max);
     }
     for (auto& sys : all_sys) {
-        if (sys->ready_list.size() == 0 ||
-            sys->ready_list.front()->stream_id != top) {
-            return;
-        }
         if (sys->ready_list.size() < min) {
             min = sys->ready_list.size();
         }
@@ -1408,19 +1540,25 @@ void Sys::schedule(int num) {
         proceed_to_next_vnet_baseline((StreamBaseline*)ready_list.front());
 
         if (ready_list.front()->current_queue_id == -1) {
+            int synchronized_ranks, ready_ranks;
+            {
+                lock_guard<mutex> lock(BaseStream::counters_mutex);
+                synchronized_ranks =
+                    BaseStream::synchronizer[ready_list.front()->stream_id];
+                ready_ranks =
+                    BaseStream::ready_counter[ready_list.front()->stream_id];
+            }
             Sys::sys_panic(
-                "should not happen! " +
-                to_string(
-                    BaseStream::synchronizer[ready_list.front()->stream_id]) +
-                " , " +
-                to_string(
-                    BaseStream::ready_counter[ready_list.front()->stream_id]) +
+                "should not happen! " + to_string(synchronized_ranks) +
+                " , " + to_string(ready_ranks) +
                 " , top queue id: " + to_string(top_vn) +
                 " , total phases: " + to_string(total_phases) +
                 " , waiting streams: " + to_string(total_waiting_streams));
         }
 
+        BaseStream* previous_front = ready_list.front();
         ready_list.pop_front();
+        ready_list_front_changed(previous_front);
         counter--;
         first_phase_streams++;
         total_running_streams++;
@@ -1443,15 +1581,9 @@ void Sys::proceed_to_next_vnet_baseline(StreamBaseline* stream) {
         stream->dataset->notify_stream_finished((StreamStat*)stream);
     }
     if (stream->current_queue_id >= 0 && stream->my_current_phase.enabled) {
-        list<BaseStream*>& target =
+        StreamQueue& target =
             active_Streams.at(stream->my_current_phase.queue_id);
-        for (list<BaseStream*>::iterator it = target.begin();
-             it != target.end(); ++it) {
-            if (((StreamBaseline*)(*it))->stream_id == stream->stream_id) {
-                target.erase(it);
-                break;
-            }
-        }
+        target.erase(stream->queue_position);
     }
     if (stream->phases_to_go.size() == 0) {
         total_running_streams--;
@@ -1506,17 +1638,7 @@ int Sys::front_end_sim_send(Tick delay,
                             Sys::FrontEndSendRecvType send_type,
                             void (*msg_handler)(void* fun_arg),
                             void* fun_arg) {
-    if (send_type == Sys::FrontEndSendRecvType::NATIVE) {
-        tag = tag % (Sys::FrontEndSendRecvType::COLLECTIVE -
-                     Sys::FrontEndSendRecvType::NATIVE) +
-              Sys::FrontEndSendRecvType::NATIVE;
-    } else if (send_type == Sys::FrontEndSendRecvType::COLLECTIVE) {
-        tag = tag % (Sys::FrontEndSendRecvType::RENDEZVOUS -
-                     Sys::FrontEndSendRecvType::COLLECTIVE) +
-              Sys::FrontEndSendRecvType::COLLECTIVE;
-    } else {
-        sys_panic("A type of RENDZVOUS should never issued in frontend");
-    }
+    tag = front_end_tag(tag, send_type);
     if (rendezvous_enabled) {
         return rendezvous_sim_send(delay, buffer, count, type, dst, tag,
                                    request, msg_handler, fun_arg);
@@ -1536,17 +1658,7 @@ int Sys::front_end_sim_recv(Tick delay,
                             Sys::FrontEndSendRecvType recv_type,
                             void (*msg_handler)(void* fun_arg),
                             void* fun_arg) {
-    if (recv_type == Sys::FrontEndSendRecvType::NATIVE) {
-        tag = tag % (Sys::FrontEndSendRecvType::COLLECTIVE -
-                     Sys::FrontEndSendRecvType::NATIVE) +
-              Sys::FrontEndSendRecvType::NATIVE;
-    } else if (recv_type == Sys::FrontEndSendRecvType::COLLECTIVE) {
-        tag = tag % (Sys::FrontEndSendRecvType::RENDEZVOUS -
-                     Sys::FrontEndSendRecvType::COLLECTIVE) +
-              Sys::FrontEndSendRecvType::COLLECTIVE;
-    } else {
-        sys_panic("A type of RENDZVOUS should never issued in frontend");
-    }
+    tag = front_end_tag(tag, recv_type);
     if (rendezvous_enabled) {
         return rendezvous_sim_recv(delay, buffer, count, type, src, tag,
                                    request, msg_handler, fun_arg);
@@ -1556,6 +1668,58 @@ int Sys::front_end_sim_recv(Tick delay,
     }
 }
 
+int Sys::front_end_tag(int tag, Sys::FrontEndSendRecvType type) {
+    if (type == Sys::FrontEndSendRecvType::NATIVE) {
+        return tag % (Sys::FrontEndSendRecvType::COLLECTIVE -
+                      Sys::FrontEndSendRecvType::NATIVE) +
+               Sys::FrontEndSendRecvType::NATIVE;
+    } else if (type == Sys::FrontEndSendRecvType::COLLECTIVE) {
+        return tag % (Sys::FrontEndSendRecvType::RENDEZVOUS -
+                      Sys::FrontEndSendRecvType::COLLECTIVE) +
+               Sys::FrontEndSendRecvType::COLLECTIVE;
+    }
+    sys_panic("A type of RENDZVOUS should never issued in frontend");
+    return tag;
+}
+
+int Sys::front_end_sim_send_batch(
+    vector<AstraNetworkAPI::BatchMessage>& messages,
+    Sys::FrontEndSendRecvType send_type) {
+    for (auto& message : messages) {
+        message.tag = front_end_tag(message.tag, send_type);
+    }
+    if (rendezvous_enabled) {
+        // every message needs its own handshake
+        for (auto& message : messages) {
+            rendezvous_sim_send(0, message.buffer, message.count, message.type,
+                                message.peer, message.tag, &message.request,
+                                message.msg_handler, message.fun_arg);
+        }
+        return 1;
+    }
+    comm_NI->sim_send_batch(messages);
+    return 1;
+}
+
+int Sys::front_end_sim_recv_batch(
+    vector<AstraNetworkAPI::BatchMessage>& messages,
+    Sys::FrontEndSendRecvType recv_type) {
+    for (auto& message : messages) {
+        message.tag = front_end_tag(message.tag, recv_type);
+    }
+    if (rendezvous_enabled) {
+        // every message needs its own handshake
+        for (auto& message : messages) {
+            rendezvous_sim_recv(0, message.buffer, message.count, message.type,
+                                message.peer, message.tag, &message.request,
+                                message.msg_handler, message.fun_arg);
+        }
+        return 1;
+    }
+    comm_NI->sim_recv_batch(messages);
+    return 1;
+}
+
 int Sys::rendezvous_sim_send(Tick delay,
                              void* buffer,
                              uint64_t count,
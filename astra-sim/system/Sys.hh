@@ -13,8 +13,10 @@ LICENSE file in the root directory of this source tree.
 #include "astra-sim/system/Callable.hh"
 #include "astra-sim/system/CollectivePhase.hh"
 #include "astra-sim/system/CommunicatorGroup.hh"
+#include "astra-sim/system/EventStore.hh"
 #include "astra-sim/system/MemBus.hh"
 #include "astra-sim/system/Roofline.hh"
+#include "astra-sim/system/StreamQueue.hh"
 #include "astra-sim/system/UsageTracker.hh"
 #include "astra-sim/system/astraccl/native_collectives/logical_topology/RingTopology.hh"
 #include "astra-sim/system/astraccl/native_collectives/logical_topology/Torus2DTopology.hh"
@@ -24,6 +26,8 @@ LICENSE file in the root directory of this source tree.
 namespace AstraSim {
 
 class BaseStream;
+class CheckpointWriter;
+class CheckpointReader;
 class StreamBaseline;
 class DataSet;
 class QueueLevels;
@@ -31,6 +35,7 @@ class Workload;
 class LogicalTopology;
 class BasicLogicalTopology;
 class OfflineGreedy;
+class RecordingNetworkApi;
 
 class Sys : public Callable {
   public:
@@ -53,7 +58,7 @@ class Sys : public Callable {
         int ready_list_threshold;
         int queue_threshold;
         std::map<int, int> running_streams;
-        std::map<int, std::list<BaseStream*>::iterator> stream_pointer;
+        std::map<int, StreamQueue::iterator> stream_pointer;
         std::vector<Tick> latency_per_dimension;
         std::vector<double> total_chunks_per_dimension;
         std::vector<uint64_t> total_active_chunks_per_dimension;
@@ -87,9 +92,38 @@ class Sys : public Callable {
         std::string collective_impl_str);
     //---------------------------------------------------------------------------
 
+    // Simulation Clock
+    // ---------------------------------------------------------
+    // While a backend callback is being dispatched, the current tick is
+    // fetched once and boostedTick() returns the cached value. Outside of
+    // dispatch (e.g. workload firing, teardown) the backend is queried.
+    // The cache is per thread, and a backend running ranks on several
+    // threads sets clock_source to an NI that reports the thread's clock.
+    class ClockScope {
+      public:
+        ClockScope() {
+            if (Sys::clock_depth++ == 0) {
+                Sys::cached_tick = Sys::query_tick();
+            }
+        }
+        ~ClockScope() {
+            Sys::clock_depth--;
+        }
+    };
+    static inline Tick boostedTick() {
+        if (clock_depth > 0) {
+            return cached_tick;
+        }
+        return query_tick();
+    }
+    static Tick query_tick();
+    static thread_local Tick cached_tick;
+    static thread_local int clock_depth;
+    static thread_local AstraNetworkAPI* clock_source;
+    //---------------------------------------------------------------------------
+
     // Helper Functions
     // ---------------------------------------------------------
-    static Tick boostedTick();
     static void sys_panic(std::string msg);
     //---------------------------------------------------------------------------
 
@@ -113,6 +147,15 @@ class Sys : public Callable {
     static void handleEvent(void* arg);
     //---------------------------------------------------------------------------
 
+    // Checkpointing
+    // --------------------------------------------------------------
+    // A rank can be saved when it has no stream and its only pending events
+    // are completions of running compute/replay nodes (see Checkpoint.hh).
+    bool is_checkpointable();
+    void checkpoint(CheckpointWriter& writer);
+    void restore(CheckpointReader& reader);
+    //---------------------------------------------------------------------------
+
     // Communicator Group Support
     // -----------------------------------------------
     LogicalTopology* get_logical_topology(ComType comm_type);
@@ -161,7 +204,8 @@ class Sys : public Callable {
     uint64_t determine_chunk_size(uint64_t& size, ComType type);
     int get_priority(int explicit_priority);
     void insert_into_ready_list(BaseStream* stream);
-    void insert_stream(std::list<BaseStream*>* queue, BaseStream* baseStream);
+    void ready_list_front_changed(BaseStream* previous_front);
+    void insert_stream(StreamQueue* queue, BaseStream* baseStream);
     void ask_for_schedule(int max);
     void schedule(int num);
     void proceed_to_next_vnet_baseline(StreamBaseline* stream);
@@ -204,6 +248,19 @@ class Sys : public Callable {
                            void (*msg_handler)(void* fun_arg),
                            void* fun_arg);
 
+    // Issue a fan-out of messages with a single call into the network
+    // backend. Tags are mapped in place as in front_end_sim_send/recv.
+    int front_end_sim_send_batch(
+        std::vector<AstraNetworkAPI::BatchMessage>& messages,
+        FrontEndSendRecvType send_type);
+
+    int front_end_sim_recv_batch(
+        std::vector<AstraNetworkAPI::BatchMessage>& messages,
+        FrontEndSendRecvType recv_type);
+
+    // tag of a front-end send/recv of the given type, see FrontEndSendRecvType
+    int front_end_tag(int tag, FrontEndSendRecvType type);
+
     int rendezvous_sim_send(Tick delay,
                             void* buffer,
                             uint64_t count,
@@ -264,6 +321,18 @@ class Sys : public Callable {
     double local_mem_bw;
     AstraRemoteMemoryAPI* remote_mem;
 
+    // network trace
+    // empty if sim_send calls are not recorded
+    std::string network_trace_filename;
+
+    // streaming execution
+    // finished nodes are evicted and their statistics folded into running
+    // aggregates, optionally spilled to a per-rank CSV file
+    bool streaming_execution;
+    std::string streaming_spill_filename;
+    // wraps the backend given to the constructor while recording
+    RecordingNetworkApi* recording_network;
+
     // memory bus
     MemBus* memBus;
     float inp_L;
@@ -296,15 +365,17 @@ class Sys : public Callable {
     int max_running;
 
     // for supporting LIFO
-    std::list<BaseStream*> ready_list;
+    StreamQueue ready_list;
     SchedulingPolicy scheduling_policy;
     int first_phase_streams;
     int total_running_streams;
-    std::map<int, std::list<BaseStream*>> active_Streams;
+    std::map<int, StreamQueue> active_Streams;
     std::map<int, std::list<int>> stream_priorities;
 
-    std::map<Tick, std::list<std::tuple<Callable*, EventType, CallData*>>>
-        event_queue;
+    EventStore* event_queue;
+    std::string event_queue_type;
+    uint64_t event_queue_buckets;
+    bool tick_multiplexing;
     int total_nodes;
     int dim_to_break;
     std::vector<int> logical_broken_dims;
@@ -321,12 +392,17 @@ class Sys : public Callable {
     std::vector<CollectiveImpl*> all_gather_implementation_per_dimension;
     std::vector<CollectiveImpl*> all_to_all_implementation_per_dimension;
     CollectiveOptimization collectiveOptimization;
+    CollectiveEngine collective_engine;
     Tick last_scheduled_collective;
     bool break_dimension_done;
     int dimension_to_break;
 
     // statistics
     bool trace_enabled;
+    // closed-form vs. message-level phase durations, in validation mode
+    uint64_t validated_phases;
+    double validation_error_sum;
+    double validation_max_error;
 
     // skip simulation for all nodes and use current duration
     bool replay_only;
@@ -0,0 +1,46 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "astra-sim/system/TickMultiplexer.hh"
+
+#include <algorithm>
+
+#include "astra-sim/system/Sys.hh"
+
+using namespace std;
+using namespace AstraSim;
+
+unordered_map<Tick, TickMultiplexer::TickRecord>
+    TickMultiplexer::pending_ticks;
+
+void TickMultiplexer::register_tick(Sys* sys, Tick tick, Tick delta_cycles) {
+    auto it = pending_ticks.find(tick);
+    if (it != pending_ticks.end()) {
+        it->second.ranks.push_back(sys->id);
+        return;
+    }
+    TickRecord& record = pending_ticks[tick];
+    record.tick = tick;
+    record.ranks.push_back(sys->id);
+
+    timespec_t tmp;
+    tmp.time_res = NS;
+    tmp.time_val = delta_cycles;
+    sys->comm_NI->sim_schedule(tmp, &TickMultiplexer::handle_tick, &record);
+}
+
+void TickMultiplexer::handle_tick(void* arg) {
+    Sys::ClockScope clock_scope;
+    TickRecord* record = (TickRecord*)arg;
+    sort(record->ranks.begin(), record->ranks.end());
+    // call_events() may enlist more ranks for this tick, so walk by index
+    for (size_t i = 0; i < record->ranks.size(); i++) {
+        Sys* sys = Sys::all_sys[record->ranks[i]];
+        if (sys != nullptr) {
+            sys->call_events();
+        }
+    }
+    pending_ticks.erase(record->tick);
+}
@@ -0,0 +1,39 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#ifndef __TICK_MULTIPLEXER_HH__
+#define __TICK_MULTIPLEXER_HH__
+
+#include <unordered_map>
+#include <vector>
+
+#include "astra-sim/system/Common.hh"
+
+namespace AstraSim {
+
+class Sys;
+
+// Shares one backend event per distinct tick among all Sys instances.
+// The first Sys that opens a tick schedules the backend event; every other
+// Sys opening the same tick only enlists its rank. When the event fires, the
+// enlisted ranks run their call_events() in ascending rank order. Ranks that
+// open the tick again while it is being dispatched run in the same pass.
+class TickMultiplexer {
+  public:
+    static void register_tick(Sys* sys, Tick tick, Tick delta_cycles);
+    static void handle_tick(void* arg);
+
+  private:
+    struct TickRecord {
+        Tick tick;
+        std::vector<int> ranks;
+    };
+
+    static std::unordered_map<Tick, TickRecord> pending_ticks;
+};
+
+}  // namespace AstraSim
+
+#endif /* __TICK_MULTIPLEXER_HH__ */
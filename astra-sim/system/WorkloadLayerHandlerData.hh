@@ -6,6 +6,7 @@ LICENSE file in the root directory of this source tree.
 #ifndef __WORKLOAD_LAYER_HANDLER_DATA_HH__
 #define __WORKLOAD_LAYER_HANDLER_DATA_HH__
 
+#include "astra-sim/common/ObjectPool.hh"
 #include "astra-sim/common/AstraNetworkAPI.hh"
 #include "astra-sim/system/BasicEventHandlerData.hh"
 
@@ -15,6 +16,13 @@ class Workload;
 
 class WorkloadLayerHandlerData : public BasicEventHandlerData, public MetaData {
   public:
+    static void* operator new(size_t size) {
+        return ObjectPool<WorkloadLayerHandlerData>::allocate(size);
+    }
+    static void operator delete(void* ptr, size_t size) {
+        ObjectPool<WorkloadLayerHandlerData>::deallocate(ptr, size);
+    }
+
     int sys_id;
     Workload* workload;
     uint64_t node_id;
@@ -34,9 +34,8 @@ void AllToAll::run(EventType event, CallData* data) {
             if (total_packets_received < middle_point) {
                 return;
             }
-            for (int i = 0; i < parallel_reduce; i++) {
-                ready();
-            }
+            // fan out to every peer of the window at once
+            ready_batch(parallel_reduce);
             iteratable();
         } else {
             ready();
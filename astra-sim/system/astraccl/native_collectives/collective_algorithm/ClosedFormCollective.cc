@@ -0,0 +1,495 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "astra-sim/system/astraccl/native_collectives/collective_algorithm/ClosedFormCollective.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <unordered_map>
+
+#include "astra-sim/common/Logging.hh"
+#include "astra-sim/system/MemBus.hh"
+#include "astra-sim/system/SharedBusStat.hh"
+#include "astra-sim/system/StreamBaseline.hh"
+#include "astra-sim/system/astraccl/native_collectives/collective_algorithm/DoubleBinaryTreeAllReduce.hh"
+#include "astra-sim/system/astraccl/native_collectives/collective_algorithm/HalvingDoubling.hh"
+#include "astra-sim/system/astraccl/native_collectives/collective_algorithm/Ring.hh"
+
+using namespace std;
+using namespace AstraSim;
+
+map<ClosedFormCollective::Key, ClosedFormCollective::Rendezvous>
+    ClosedFormCollective::pending;
+
+ClosedFormCollective::ClosedFormCollective(Algorithm* algorithm,
+                                           CollectiveEngine mode)
+    : Algorithm() {
+    this->algorithm = algorithm;
+    this->mode = mode;
+    this->name = algorithm->name;
+    this->id = algorithm->id;
+    this->logical_topo = algorithm->logical_topo;
+    this->data_size = algorithm->data_size;
+    this->final_data_size = algorithm->final_data_size;
+    this->comType = algorithm->comType;
+    this->enabled = algorithm->enabled;
+    this->sys = nullptr;
+    this->rank = -1;
+    this->mem_bus_delay = 0;
+    this->start_tick = 0;
+    this->finish_tick = 0;
+    this->net_message_latency = 0;
+    this->net_message_count = 0;
+    this->mem_bus_transfers = 0;
+    this->registered = false;
+    this->resolved = false;
+}
+
+ClosedFormCollective::~ClosedFormCollective() {
+    if (mode == CollectiveEngine::Validate && resolved) {
+        // the wrapped algorithm finished the phase, see Algorithm::exit()
+        Tick simulated = Sys::boostedTick() - start_tick;
+        Tick predicted = finish_tick - start_tick;
+        double error = fabs(static_cast<double>(predicted) -
+                            static_cast<double>(simulated)) /
+                       max<Tick>(simulated, 1);
+        sys->validated_phases++;
+        sys->validation_error_sum += error;
+        sys->validation_max_error = max(sys->validation_max_error, error);
+        LoggerFactory::get_logger("system::collective::ClosedFormCollective")
+            ->debug("sys[{}] stream {} phase {}: closed-form {} cycles, "
+                    "message-level {} cycles",
+                    rank, get<0>(key), get<1>(key), predicted, simulated);
+    } else if (registered && !resolved) {
+        // never leave a dangling participant behind
+        auto it = pending.find(key);
+        if (it != pending.end()) {
+            it->second.participants.erase(rank);
+            if (it->second.participants.empty()) {
+                pending.erase(it);
+            }
+        }
+    }
+    delete algorithm;
+}
+
+bool ClosedFormCollective::supports(Sys* sys, Algorithm* algorithm) {
+    // the shared bus and the rendezvous protocol add queueing and handshakes
+    // to every message
+    if (sys->model_shared_bus || sys->rendezvous_enabled) {
+        return false;
+    }
+
+    int peer;
+    if (algorithm->name == Algorithm::Name::Ring) {
+        Ring* ring = static_cast<Ring*>(algorithm);
+        if (ring->parallel_reduce != 1) {
+            return false;
+        }
+        peer = ring->curr_receiver;
+    } else if (algorithm->name == Algorithm::Name::HalvingDoubling) {
+        peer = static_cast<HalvingDoubling*>(algorithm)->curr_receiver;
+    } else if (algorithm->name == Algorithm::Name::DoubleBinaryTree) {
+        DoubleBinaryTreeAllReduce* tree =
+            static_cast<DoubleBinaryTreeAllReduce*>(algorithm);
+        peer = tree->parent >= 0 ? tree->parent : max(tree->left_child,
+                                                      tree->right_child);
+    } else {
+        return false;
+    }
+
+    if (sys->comm_NI->get_send_delay(sys->id, peer, 1) < 0) {
+        static atomic<bool> warned(false);
+        if (!warned.exchange(true)) {
+            LoggerFactory::get_logger("system")->warn(
+                "the network backend does not provide contention-free send "
+                "delays, using message-level collectives");
+        }
+        return false;
+    }
+    return true;
+}
+
+void ClosedFormCollective::init(BaseStream* stream) {
+    Algorithm::init(stream);
+    algorithm->init(stream);
+    sys = stream->owner;
+    rank = sys->id;
+
+    if (name == Algorithm::Name::Ring) {
+        build_ring_plan();
+    } else if (name == Algorithm::Name::HalvingDoubling) {
+        build_halving_doubling_plan();
+    } else {
+        build_tree_plan();
+    }
+}
+
+void ClosedFormCollective::run(EventType event, CallData* data) {
+    if (event == EventType::StreamInit) {
+        register_participant();
+    }
+    if (mode == CollectiveEngine::Validate) {
+        algorithm->run(event, data);
+        return;
+    }
+    if (stream->state == StreamState::Created ||
+        stream->state == StreamState::Ready) {
+        stream->changeState(StreamState::Executing);
+    }
+}
+
+void ClosedFormCollective::call(EventType event, CallData* data) {
+    if (mode == CollectiveEngine::Validate) {
+        algorithm->call(event, data);
+        return;
+    }
+    finish();
+}
+
+void ClosedFormCollective::build_ring_plan() {
+    Ring* ring = static_cast<Ring*>(algorithm);
+    RingTopology* topology = static_cast<RingTopology*>(ring->logical_topo);
+    mem_bus_delay = ring->transmition == MemBus::Transmition::Fast
+                        ? MemBus::fast_delay
+                        : sys->communication_delay;
+
+    int node = rank;
+    for (int i = 0; i < ring->nodes_in_ring; i++) {
+        members.push_back(node);
+        node = topology->get_receiver(node, RingTopology::Direction::Clockwise);
+    }
+
+    // replay Ring::insert_packet(): packet k is sent by step k, packet k + 1
+    // is inserted once the receive of step k completes
+    int zero_latency_packets = 0;
+    int non_zero_latency_packets = 0;
+    bool toggle = false;
+    for (int k = 0; k <= ring->stream_count; k++) {
+        if (zero_latency_packets == 0 && non_zero_latency_packets == 0) {
+            zero_latency_packets = ring->parallel_reduce;
+            non_zero_latency_packets = ring->get_non_zero_latency_packets();
+            toggle = !toggle;
+        }
+        bool processed = false;
+        if (zero_latency_packets > 0) {
+            zero_latency_packets--;
+        } else {
+            processed = comType == ComType::Reduce_Scatter ||
+                        (comType == ComType::All_Reduce && toggle);
+            non_zero_latency_packets--;
+        }
+        if (k > 0) {
+            steps[k - 1].reduced_size = processed ? ring->msg_size : 0;
+        }
+        if (k < ring->stream_count) {
+            steps.push_back(
+                {ring->curr_receiver, ring->curr_sender, ring->msg_size, 0});
+        }
+    }
+    mem_bus_transfers = ring->stream_count + 1;
+}
+
+void ClosedFormCollective::build_halving_doubling_plan() {
+    HalvingDoubling* hd = static_cast<HalvingDoubling*>(algorithm);
+    RingTopology* topology = static_cast<RingTopology*>(hd->logical_topo);
+    mem_bus_delay = hd->transmition == MemBus::Transmition::Fast
+                        ? MemBus::fast_delay
+                        : sys->communication_delay;
+
+    int node = rank;
+    for (int i = 0; i < hd->nodes_in_ring; i++) {
+        members.push_back(node);
+        node = topology->get_receiver(node, RingTopology::Direction::Clockwise);
+    }
+
+    // replay HalvingDoubling::insert_packet() and process_max_count()
+    int rank_offset = hd->rank_offset;
+    double offset_multiplier = hd->offset_multiplier;
+    uint64_t msg_size = hd->msg_size;
+    int curr_receiver = hd->curr_receiver;
+    int zero_latency_packets = 0;
+    int non_zero_latency_packets = 0;
+    bool toggle = false;
+    for (int k = 0; k <= hd->stream_count; k++) {
+        if (zero_latency_packets == 0 && non_zero_latency_packets == 0) {
+            zero_latency_packets = hd->parallel_reduce;
+            non_zero_latency_packets = hd->get_non_zero_latency_packets();
+            toggle = !toggle;
+        }
+        bool processed = false;
+        if (zero_latency_packets > 0) {
+            zero_latency_packets--;
+        } else {
+            processed = comType == ComType::Reduce_Scatter ||
+                        (comType == ComType::All_Reduce && toggle);
+            non_zero_latency_packets--;
+        }
+        if (k > 0) {
+            steps[k - 1].reduced_size = processed ? msg_size : 0;
+        }
+        if (k < hd->stream_count) {
+            steps.push_back({curr_receiver, curr_receiver, msg_size, 0});
+        }
+
+        rank_offset *= offset_multiplier;
+        msg_size /= offset_multiplier;
+        if (rank_offset == hd->nodes_in_ring &&
+            comType == ComType::All_Reduce) {
+            offset_multiplier = 0.5;
+            rank_offset *= offset_multiplier;
+            msg_size /= offset_multiplier;
+        }
+        RingTopology::Direction direction = RingTopology::Direction::Clockwise;
+        if (rank_offset != 0 &&
+            (topology->get_index_in_ring() / rank_offset) % 2 != 0) {
+            direction = RingTopology::Direction::Anticlockwise;
+        }
+        curr_receiver = rank;
+        for (int i = 0; i < rank_offset; i++) {
+            curr_receiver = topology->get_receiver(curr_receiver, direction);
+        }
+    }
+    mem_bus_transfers = hd->stream_count + 1;
+}
+
+void ClosedFormCollective::build_tree_plan() {
+    DoubleBinaryTreeAllReduce* dbt =
+        static_cast<DoubleBinaryTreeAllReduce*>(algorithm);
+    BinaryTree* tree = static_cast<BinaryTree*>(dbt->logical_topo);
+    mem_bus_delay = sys->communication_delay;
+    for (const auto& node : tree->node_list) {
+        members.push_back(node.first);
+    }
+    if (dbt->type == BinaryTree::Type::Leaf) {
+        mem_bus_transfers = 2;
+    } else if (dbt->type == BinaryTree::Type::Intermediate) {
+        mem_bus_transfers = 3;
+    } else {
+        mem_bus_transfers = 1;
+    }
+}
+
+void ClosedFormCollective::register_participant() {
+    start_tick = Sys::boostedTick();
+    key = Key(stream->stream_id, stream->steps_finished,
+              static_cast<int>(comType), data_size,
+              *min_element(members.begin(), members.end()));
+
+    Rendezvous& rendezvous = pending[key];
+    rendezvous.participants_count = members.size();
+    if (!rendezvous.participants.emplace(rank, this).second) {
+        Sys::sys_panic("closed-form collective: rank " + to_string(rank) +
+                       " joined the same phase twice");
+    }
+    registered = true;
+
+    if (rendezvous.participants.size() == rendezvous.participants_count) {
+        resolve(rendezvous);
+        pending.erase(key);
+    }
+}
+
+void ClosedFormCollective::resolve(Rendezvous& rendezvous) {
+    vector<ClosedFormCollective*> phase;
+    for (const auto& participant : rendezvous.participants) {
+        phase.push_back(participant.second);
+    }
+    if (phase.front()->name == Algorithm::Name::DoubleBinaryTree) {
+        resolve_tree(phase);
+    } else {
+        resolve_ring(phase);
+    }
+
+    Tick current_tick = Sys::boostedTick();
+    for (auto participant : phase) {
+        participant->resolved = true;
+        if (participant->mode == CollectiveEngine::ClosedForm) {
+            Tick finish_tick = max(participant->finish_tick, current_tick);
+            participant->sys->register_event(participant, EventType::General,
+                                             nullptr,
+                                             finish_tick - current_tick);
+        }
+    }
+}
+
+void ClosedFormCollective::resolve_ring(
+    vector<ClosedFormCollective*>& phase) {
+    unordered_map<int, int> index_of;
+    for (int i = 0; i < phase.size(); i++) {
+        index_of[phase[i]->rank] = i;
+    }
+
+    // send_tick[i] is the tick participant i issues its next send and posts
+    // its next receive
+    uint64_t steps_count = phase.front()->steps.size();
+    vector<Tick> send_tick(phase.size());
+    vector<Tick> arrival_tick(phase.size());
+    for (int i = 0; i < phase.size(); i++) {
+        if (phase[i]->steps.size() != steps_count) {
+            Sys::sys_panic("closed-form collective: participants of a phase "
+                           "disagree on its number of steps");
+        }
+        send_tick[i] = phase[i]->start_tick + phase[i]->mem_bus_delay;
+        phase[i]->net_message_latency = 0;
+        phase[i]->net_message_count = steps_count;
+    }
+
+    for (uint64_t k = 0; k < steps_count; k++) {
+        for (int i = 0; i < phase.size(); i++) {
+            auto it = index_of.find(phase[i]->steps[k].src);
+            if (it == index_of.end() ||
+                phase[it->second]->steps[k].dst != phase[i]->rank) {
+                Sys::sys_panic("closed-form collective: unmatched message to "
+                               "rank " +
+                               to_string(phase[i]->rank));
+            }
+            ClosedFormCollective* src = phase[it->second];
+            arrival_tick[i] = send_tick[it->second] +
+                              send_delay(src, phase[i]->rank,
+                                         src->steps[k].size);
+        }
+        for (int i = 0; i < phase.size(); i++) {
+            // a message arriving before its receive is posted waits for it
+            Tick received_tick = max(arrival_tick[i], send_tick[i]);
+            phase[i]->net_message_latency += received_tick - send_tick[i];
+            send_tick[i] =
+                received_tick + phase[i]->mem_bus_delay +
+                phase[i]->reduction_delay(phase[i]->steps[k].reduced_size);
+        }
+    }
+
+    for (int i = 0; i < phase.size(); i++) {
+        phase[i]->finish_tick = send_tick[i];
+    }
+}
+
+void ClosedFormCollective::resolve_tree(
+    vector<ClosedFormCollective*>& phase) {
+    unordered_map<int, ClosedFormCollective*> participant_of;
+    ClosedFormCollective* root = nullptr;
+    for (auto participant : phase) {
+        participant->net_message_latency = 0;
+        participant->net_message_count = 0;
+        participant_of[participant->rank] = participant;
+        DoubleBinaryTreeAllReduce* dbt =
+            static_cast<DoubleBinaryTreeAllReduce*>(participant->algorithm);
+        if (dbt->type == BinaryTree::Type::Root) {
+            root = participant;
+        }
+    }
+    if (root == nullptr) {
+        Sys::sys_panic("closed-form collective: binary tree without root");
+    }
+
+    // receive posted at post_tick, sent by src at send_tick
+    auto receive = [&](ClosedFormCollective* dst, ClosedFormCollective* src,
+                       Tick post_tick, Tick send_tick) {
+        Tick arrival_tick =
+            send_tick + send_delay(src, dst->rank, src->data_size);
+        Tick received_tick = max(arrival_tick, post_tick);
+        dst->net_message_latency += received_tick - post_tick;
+        dst->net_message_count++;
+        return received_tick;
+    };
+    auto children_of = [&](ClosedFormCollective* node) {
+        DoubleBinaryTreeAllReduce* dbt =
+            static_cast<DoubleBinaryTreeAllReduce*>(node->algorithm);
+        vector<ClosedFormCollective*> children;
+        if (dbt->type == BinaryTree::Type::Root) {
+            // the root only talks to one child
+            int only_child_id =
+                dbt->left_child >= 0 ? dbt->left_child : dbt->right_child;
+            children.push_back(participant_of.at(only_child_id));
+        } else {
+            for (int child_id : {dbt->left_child, dbt->right_child}) {
+                if (child_id >= 0) {
+                    children.push_back(participant_of.at(child_id));
+                }
+            }
+        }
+        return children;
+    };
+
+    // reduction towards the root: up_tick is when a node sends to its parent
+    // and posts the receive for the broadcast
+    unordered_map<int, Tick> up_tick;
+    function<void(ClosedFormCollective*)> reduce =
+        [&](ClosedFormCollective* node) {
+            DoubleBinaryTreeAllReduce* dbt =
+                static_cast<DoubleBinaryTreeAllReduce*>(node->algorithm);
+            if (dbt->type == BinaryTree::Type::Leaf) {
+                up_tick[node->rank] = node->start_tick + node->mem_bus_delay;
+                return;
+            }
+            Tick ready_tick = node->start_tick;
+            for (auto child : children_of(node)) {
+                reduce(child);
+                ready_tick =
+                    max(ready_tick, receive(node, child, node->start_tick,
+                                            up_tick[child->rank]));
+            }
+            up_tick[node->rank] = ready_tick + node->mem_bus_delay +
+                                  node->reduction_delay(node->data_size);
+        };
+
+    // broadcast from the root
+    function<void(ClosedFormCollective*, ClosedFormCollective*)> broadcast =
+        [&](ClosedFormCollective* node, ClosedFormCollective* parent) {
+            DoubleBinaryTreeAllReduce* dbt =
+                static_cast<DoubleBinaryTreeAllReduce*>(node->algorithm);
+            if (dbt->type == BinaryTree::Type::Root) {
+                node->finish_tick = up_tick[node->rank];
+            } else {
+                Tick received_tick = receive(node, parent, up_tick[node->rank],
+                                             parent->finish_tick);
+                node->finish_tick = received_tick + node->mem_bus_delay;
+                if (dbt->type == BinaryTree::Type::Intermediate) {
+                    node->finish_tick += node->reduction_delay(node->data_size);
+                }
+            }
+            if (dbt->type != BinaryTree::Type::Leaf) {
+                for (auto child : children_of(node)) {
+                    broadcast(child, node);
+                }
+            }
+        };
+
+    reduce(root);
+    broadcast(root, nullptr);
+}
+
+Tick ClosedFormCollective::send_delay(ClosedFormCollective* src,
+                                      int dst,
+                                      uint64_t count) {
+    double delay = src->sys->comm_NI->get_send_delay(src->rank, dst, count);
+    return static_cast<Tick>(delay) / CLOCK_PERIOD;
+}
+
+Tick ClosedFormCollective::reduction_delay(uint64_t size) const {
+    if (size == 0) {
+        return 0;
+    }
+    // write and two reads, as in PacketBundle::call()
+    return 3 * static_cast<uint64_t>(static_cast<double>(size) /
+                                     sys->local_mem_bw * 1e9);
+}
+
+void ClosedFormCollective::finish() {
+    StreamBaseline* stream_baseline = static_cast<StreamBaseline*>(stream);
+    stream_baseline->net_message_latency.back() += net_message_latency;
+    stream_baseline->net_message_counter += net_message_count;
+    SharedBusStat bus_stat(BusType::Shared, 0, mem_bus_delay, 0, 0);
+    for (int i = 0; i < mem_bus_transfers; i++) {
+        stream_baseline->update_bus_stats(BusType::Both, &bus_stat);
+    }
+
+    if (stream->state != StreamState::Dead) {
+        stream->changeState(StreamState::Zombie);
+    }
+    exit();
+}
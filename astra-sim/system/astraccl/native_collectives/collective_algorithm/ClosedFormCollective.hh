@@ -0,0 +1,102 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#ifndef __CLOSED_FORM_COLLECTIVE_HH__
+#define __CLOSED_FORM_COLLECTIVE_HH__
+
+#include <map>
+#include <tuple>
+#include <vector>
+
+#include "astra-sim/system/astraccl/Algorithm.hh"
+
+namespace AstraSim {
+
+class Sys;
+
+// Collective phase of a Ring, HalvingDoubling or DoubleBinaryTreeAllReduce
+// algorithm whose duration is computed in closed form instead of exchanging
+// messages. Every participant registers its start tick and the message
+// schedule of the wrapped algorithm. Once the last participant of the phase
+// started, the send/receive recurrence of the algorithm is evaluated for all
+// participants at once and only their completion events are scheduled. This
+// is exact as long as the network has no contention, see
+// AstraNetworkAPI::get_send_delay().
+//
+// In validation mode the wrapped algorithm runs as usual and the closed-form
+// duration is compared against it when the phase finishes.
+class ClosedFormCollective : public Algorithm {
+  public:
+    ClosedFormCollective(Algorithm* algorithm, CollectiveEngine mode);
+    ~ClosedFormCollective();
+
+    // Whether the phase of the given algorithm can be computed in closed form.
+    static bool supports(Sys* sys, Algorithm* algorithm);
+
+    void init(BaseStream* stream) override;
+    void run(EventType event, CallData* data) override;
+    void call(EventType event, CallData* data) override;
+
+  private:
+    // one send and one receive of a ring-like algorithm
+    struct Step {
+        int dst;
+        int src;
+        uint64_t size;
+        // bytes reduced once the receive completes, 0 if none
+        uint64_t reduced_size;
+    };
+
+    // (stream id, phase, collective type, data size, lowest participant)
+    using Key = std::tuple<int, int, int, uint64_t, int>;
+
+    struct Rendezvous {
+        int participants_count;
+        std::map<int, ClosedFormCollective*> participants;
+    };
+
+    void build_ring_plan();
+    void build_halving_doubling_plan();
+    void build_tree_plan();
+    void register_participant();
+    void finish();
+
+    static void resolve(Rendezvous& rendezvous);
+    static void resolve_ring(std::vector<ClosedFormCollective*>& phase);
+    static void resolve_tree(std::vector<ClosedFormCollective*>& phase);
+    static Tick send_delay(ClosedFormCollective* src,
+                           int dst,
+                           uint64_t count);
+    Tick reduction_delay(uint64_t size) const;
+
+    // phases waiting for some of their participants to start
+    static std::map<Key, Rendezvous> pending;
+
+    Algorithm* algorithm;
+    CollectiveEngine mode;
+    Sys* sys;
+    int rank;
+    Key key;
+
+    // all participants of the phase
+    std::vector<int> members;
+    // message schedule of Ring and HalvingDoubling
+    std::vector<Step> steps;
+    // delay of a PacketBundle on the memory bus
+    Tick mem_bus_delay;
+    // number of PacketBundles of the phase on this rank
+    int mem_bus_transfers;
+
+    Tick start_tick;
+    Tick finish_tick;
+    Tick net_message_latency;
+    int net_message_count;
+    bool registered;
+    bool resolved;
+};
+
+}  // namespace AstraSim
+
+#endif /* __CLOSED_FORM_COLLECTIVE_HH__ */
@@ -223,40 +223,86 @@ void Ring::insert_packet(Callable* sender) {
     Sys::sys_panic("should not inject nothing!");
 }
 
+bool Ring::build_messages(AstraNetworkAPI::BatchMessage& snd,
+                          AstraNetworkAPI::BatchMessage& rcv) {
+    if (packets.size() == 0 || stream_count == 0 || free_packets == 0) {
+        return false;
+    }
+    MyPacket packet = packets.front();
+    snd.buffer = Sys::dummy_data;
+    snd.count = msg_size;
+    snd.type = UINT8;
+    snd.peer = packet.preferred_dest;
+    snd.tag = stream->stream_id;
+    snd.request.srcRank = id;
+    snd.request.dstRank = packet.preferred_dest;
+    snd.request.tag = stream->stream_id;
+    snd.request.reqType = UINT8;
+    snd.request.vnet = this->stream->current_queue_id;
+    snd.msg_handler = &Sys::handleEvent;
+    snd.fun_arg = nullptr;
+
+    rcv.buffer = Sys::dummy_data;
+    rcv.count = msg_size;
+    rcv.type = UINT8;
+    rcv.peer = packet.preferred_src;
+    rcv.tag = stream->stream_id;
+    rcv.request.vnet = this->stream->current_queue_id;
+    rcv.msg_handler = &Sys::handleEvent;
+    rcv.fun_arg = new RecvPacketEventHandlerData(
+        stream, stream->owner->id, EventType::PacketReceived,
+        packet.preferred_vnet, packet.stream_id);
+    return true;
+}
+
 bool Ring::ready() {
     if (stream->state == StreamState::Created ||
         stream->state == StreamState::Ready) {
         stream->changeState(StreamState::Executing);
     }
-    if (packets.size() == 0 || stream_count == 0 || free_packets == 0) {
+    AstraNetworkAPI::BatchMessage snd;
+    AstraNetworkAPI::BatchMessage rcv;
+    if (!build_messages(snd, rcv)) {
         return false;
     }
-    MyPacket packet = packets.front();
-    sim_request snd_req;
-    snd_req.srcRank = id;
-    snd_req.dstRank = packet.preferred_dest;
-    snd_req.tag = stream->stream_id;
-    snd_req.reqType = UINT8;
-    snd_req.vnet = this->stream->current_queue_id;
     stream->owner->front_end_sim_send(
-        0, Sys::dummy_data, msg_size, UINT8, packet.preferred_dest,
-        stream->stream_id, &snd_req, Sys::FrontEndSendRecvType::COLLECTIVE,
-        &Sys::handleEvent,
-        nullptr);  // stream_id+(packet.preferred_dest*50)
-    sim_request rcv_req;
-    rcv_req.vnet = this->stream->current_queue_id;
-    RecvPacketEventHandlerData* ehd = new RecvPacketEventHandlerData(
-        stream, stream->owner->id, EventType::PacketReceived,
-        packet.preferred_vnet, packet.stream_id);
+        0, snd.buffer, snd.count, snd.type, snd.peer, snd.tag, &snd.request,
+        Sys::FrontEndSendRecvType::COLLECTIVE, snd.msg_handler,
+        snd.fun_arg);  // stream_id+(packet.preferred_dest*50)
     stream->owner->front_end_sim_recv(
-        0, Sys::dummy_data, msg_size, UINT8, packet.preferred_src,
-        stream->stream_id, &rcv_req, Sys::FrontEndSendRecvType::COLLECTIVE,
-        &Sys::handleEvent,
-        ehd);  // stream_id+(owner->id*50)
+        0, rcv.buffer, rcv.count, rcv.type, rcv.peer, rcv.tag, &rcv.request,
+        Sys::FrontEndSendRecvType::COLLECTIVE, rcv.msg_handler,
+        rcv.fun_arg);  // stream_id+(owner->id*50)
     reduce();
     return true;
 }
 
+int Ring::ready_batch(int max_messages) {
+    if (stream->state == StreamState::Created ||
+        stream->state == StreamState::Ready) {
+        stream->changeState(StreamState::Executing);
+    }
+    std::vector<AstraNetworkAPI::BatchMessage> sends;
+    std::vector<AstraNetworkAPI::BatchMessage> recvs;
+    while ((int)sends.size() < max_messages) {
+        AstraNetworkAPI::BatchMessage snd;
+        AstraNetworkAPI::BatchMessage rcv;
+        if (!build_messages(snd, rcv)) {
+            break;
+        }
+        sends.push_back(snd);
+        recvs.push_back(rcv);
+        reduce();
+    }
+    if (sends.size() != 0) {
+        stream->owner->front_end_sim_send_batch(
+            sends, Sys::FrontEndSendRecvType::COLLECTIVE);
+        stream->owner->front_end_sim_recv_batch(
+            recvs, Sys::FrontEndSendRecvType::COLLECTIVE);
+    }
+    return sends.size();
+}
+
 void Ring::exit() {
     if (packets.size() != 0) {
         packets.clear();
@@ -6,6 +6,7 @@ LICENSE file in the root directory of this source tree.
 #ifndef __RING_HH__
 #define __RING_HH__
 
+#include "astra-sim/common/AstraNetworkAPI.hh"
 #include "astra-sim/system/MemBus.hh"
 #include "astra-sim/system/MyPacket.hh"
 #include "astra-sim/system/astraccl/Algorithm.hh"
@@ -30,6 +31,12 @@ class Ring : public Algorithm {
     virtual int get_non_zero_latency_packets();
     void insert_packet(Callable* sender);
     bool ready();
+    // same as up to max_messages calls to ready(), issued as one batch
+    int ready_batch(int max_messages);
+    // fills the send and recv of the front packet, false if it cannot be
+    // issued yet
+    bool build_messages(AstraNetworkAPI::BatchMessage& snd,
+                        AstraNetworkAPI::BatchMessage& rcv);
     void exit();
 
     RingTopology::Direction dimension;
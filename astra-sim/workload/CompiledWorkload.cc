@@ -0,0 +1,409 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "astra-sim/workload/CompiledWorkload.hh"
+
+#include <algorithm>
+#include <cassert>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+
+#include "astra-sim/common/Logging.hh"
+#include "extern/graph_frontend/chakra/schema/protobuf/et_def.pb.h"
+#include "extern/graph_frontend/chakra/src/third_party/utils/protoio.hh"
+
+using namespace std;
+using namespace AstraSim;
+using namespace Chakra::FeederV3;
+
+typedef ChakraProtoMsg::NodeType ChakraNodeType;
+
+namespace {
+uint64_t align_up(uint64_t offset) {
+    return (offset + 7) & ~uint64_t(7);
+}
+
+void write_section(FILE* file,
+                   const void* data,
+                   uint64_t bytes,
+                   uint64_t& offset,
+                   const string& filename) {
+    static const char padding[8] = {};
+    uint64_t aligned = align_up(offset);
+    if (fwrite(padding, 1, aligned - offset, file) != aligned - offset ||
+        fwrite(data, 1, bytes, file) != bytes) {
+        LoggerFactory::get_logger("workload")
+            ->critical("unable to write compiled workload {}", filename);
+        exit(EXIT_FAILURE);
+    }
+    offset = aligned + bytes;
+}
+}  // namespace
+
+string CompiledWorkload::get_filename(const string& cache_dir,
+                                      uint64_t et_hash) {
+    char name[32];
+    snprintf(name, sizeof(name), "%016" PRIx64 ".cet", et_hash);
+    return cache_dir + "/" + name;
+}
+
+void CompiledWorkload::compile(const string& et_filename,
+                               uint64_t et_hash,
+                               uint64_t et_bytes,
+                               const string& filename) {
+    auto logger = LoggerFactory::get_logger("workload");
+
+    // node ids and dependencies come from the protobuf stream; attributes
+    // are decoded through the feeder, exactly as for a parsed ET
+    struct SourceNode {
+        uint64_t id;
+        string name;
+        vector<uint64_t> parents;
+    };
+    vector<SourceNode> source;
+    ProtoInputStream stream(et_filename);
+    ChakraProtoMsg::GlobalMetadata metadata;
+    if (!stream.read(metadata)) {
+        logger->critical("workload file: {} is not a Chakra ET", et_filename);
+        exit(EXIT_FAILURE);
+    }
+    ChakraProtoMsg::Node node;
+    while (stream.read(node)) {
+        SourceNode source_node;
+        source_node.id = node.id();
+        source_node.name = node.name();
+        source_node.parents.assign(node.data_deps().begin(),
+                                   node.data_deps().end());
+        source_node.parents.insert(source_node.parents.end(),
+                                   node.ctrl_deps().begin(),
+                                   node.ctrl_deps().end());
+        sort(source_node.parents.begin(), source_node.parents.end());
+        source_node.parents.erase(unique(source_node.parents.begin(),
+                                         source_node.parents.end()),
+                                  source_node.parents.end());
+        source.push_back(move(source_node));
+    }
+    sort(source.begin(), source.end(),
+         [](const auto& a, const auto& b) { return a.id < b.id; });
+
+    uint32_t nodes_count = static_cast<uint32_t>(source.size());
+    unordered_map<uint64_t, uint32_t> index_of;
+    index_of.reserve(nodes_count);
+    for (uint32_t i = 0; i < nodes_count; i++) {
+        if (!index_of.emplace(source[i].id, i).second) {
+            logger->critical("workload file: {} has node {} twice",
+                             et_filename, source[i].id);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // interned strings, offset 0 is the empty string
+    vector<char> strings(1, '\0');
+    unordered_map<string, uint32_t> string_offsets = {{"", 0}};
+    auto intern = [&](const string& value) {
+        auto [it, inserted] = string_offsets.emplace(
+            value, static_cast<uint32_t>(strings.size()));
+        if (inserted) {
+            strings.insert(strings.end(), value.begin(), value.end());
+            strings.push_back('\0');
+        }
+        return it->second;
+    };
+
+    ETFeeder feeder(et_filename);
+    vector<CompiledNode> nodes(nodes_count);
+    vector<uint32_t> child_offsets(nodes_count + 1, 0);
+    uint64_t missing_parents = 0;
+    for (uint32_t i = 0; i < nodes_count; i++) {
+        shared_ptr<ETFeederNode> feeder_node = feeder.lookupNode(source[i].id);
+        nodes[i].record = NodeTable::decode(feeder_node);
+        nodes[i].name = intern(source[i].name);
+        if (feeder_node->type() == ChakraNodeType::METADATA_NODE) {
+            nodes[i].inputs_values = intern(feeder_node->get_inputs_values());
+        }
+        for (auto parent_id : source[i].parents) {
+            auto it = index_of.find(parent_id);
+            if (it == index_of.end()) {
+                missing_parents++;
+                continue;
+            }
+            nodes[i].parents_count++;
+            child_offsets[it->second + 1]++;
+        }
+    }
+    if (missing_parents > 0) {
+        logger->warn("{} dependencies on nodes missing from {} are ignored",
+                     missing_parents, et_filename);
+    }
+
+    // children of each node, in node index order
+    for (uint32_t i = 0; i < nodes_count; i++) {
+        child_offsets[i + 1] += child_offsets[i];
+    }
+    vector<uint32_t> children(child_offsets[nodes_count]);
+    vector<uint32_t> next_child(child_offsets.begin(), child_offsets.end() - 1);
+    for (uint32_t i = 0; i < nodes_count; i++) {
+        for (auto parent_id : source[i].parents) {
+            auto it = index_of.find(parent_id);
+            if (it != index_of.end()) {
+                children[next_child[it->second]++] = i;
+            }
+        }
+    }
+
+    Header header = {};
+    header.magic = magic;
+    header.version = version;
+    header.header_bytes = sizeof(Header);
+    header.et_hash = et_hash;
+    header.et_bytes = et_bytes;
+    header.nodes_count = nodes_count;
+    header.edges_count = children.size();
+    header.strings_bytes = strings.size();
+    header.nodes_offset = align_up(sizeof(Header));
+    header.child_offsets_offset = align_up(
+        header.nodes_offset + nodes.size() * sizeof(CompiledNode));
+    header.children_offset = align_up(
+        header.child_offsets_offset + child_offsets.size() * sizeof(uint32_t));
+    header.strings_offset = align_up(header.children_offset +
+                                     children.size() * sizeof(uint32_t));
+
+    string tmp_filename = filename + ".tmp." + to_string(getpid());
+    FILE* file = fopen(tmp_filename.c_str(), "wb");
+    if (file == nullptr) {
+        logger->critical("unable to open compiled workload {}", tmp_filename);
+        exit(EXIT_FAILURE);
+    }
+    uint64_t offset = 0;
+    write_section(file, &header, sizeof(Header), offset, tmp_filename);
+    write_section(file, nodes.data(), nodes.size() * sizeof(CompiledNode),
+                  offset, tmp_filename);
+    write_section(file, child_offsets.data(),
+                  child_offsets.size() * sizeof(uint32_t), offset,
+                  tmp_filename);
+    write_section(file, children.data(), children.size() * sizeof(uint32_t),
+                  offset, tmp_filename);
+    write_section(file, strings.data(), strings.size(), offset, tmp_filename);
+    if (fclose(file) != 0 || rename(tmp_filename.c_str(), filename.c_str())) {
+        logger->critical("unable to write compiled workload {}", filename);
+        exit(EXIT_FAILURE);
+    }
+}
+
+bool CompiledWorkload::is_valid(const string& filename,
+                                uint64_t et_hash,
+                                uint64_t et_bytes) {
+    ifstream file(filename, ios::binary | ios::ate);
+    if (!file.is_open()) {
+        return false;
+    }
+    size_t bytes = static_cast<size_t>(file.tellg());
+    Header header;
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(Header))) {
+        return false;
+    }
+    return check_header(header, et_hash, et_bytes, bytes);
+}
+
+CompiledWorkload* CompiledWorkload::open(const string& filename,
+                                         uint64_t et_hash,
+                                         uint64_t et_bytes) {
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0 ||
+        static_cast<size_t>(file_stat.st_size) < sizeof(Header)) {
+        close(fd);
+        return nullptr;
+    }
+    size_t bytes = static_cast<size_t>(file_stat.st_size);
+    void* data = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        return nullptr;
+    }
+
+    const Header* header = static_cast<const Header*>(data);
+    const char* strings =
+        static_cast<const char*>(data) + header->strings_offset;
+    if (!check_header(*header, et_hash, et_bytes, bytes) ||
+        strings[header->strings_bytes - 1] != '\0') {
+        munmap(data, bytes);
+        return nullptr;
+    }
+    CompiledWorkload* workload = new CompiledWorkload(data, bytes);
+    if (!workload->check_children()) {
+        delete workload;
+        return nullptr;
+    }
+    return workload;
+}
+
+CompiledWorkload::CompiledWorkload(void* data, size_t bytes)
+    : data(data), bytes(bytes) {
+    const char* base = static_cast<const char*>(data);
+    header = reinterpret_cast<const Header*>(base);
+    nodes = reinterpret_cast<const CompiledNode*>(base + header->nodes_offset);
+    child_offsets = reinterpret_cast<const uint32_t*>(
+        base + header->child_offsets_offset);
+    children =
+        reinterpret_cast<const uint32_t*>(base + header->children_offset);
+    strings = base + header->strings_offset;
+}
+
+CompiledWorkload::~CompiledWorkload() {
+    munmap(data, bytes);
+}
+
+bool CompiledWorkload::check_header(const Header& header,
+                                    uint64_t et_hash,
+                                    uint64_t et_bytes,
+                                    size_t bytes) {
+    if (header.magic != magic || header.version != version ||
+        header.header_bytes != sizeof(Header) || header.et_hash != et_hash ||
+        header.et_bytes != et_bytes ||
+        header.nodes_count > UINT32_MAX || header.edges_count > UINT32_MAX ||
+        header.strings_bytes == 0) {
+        return false;
+    }
+    return header.nodes_offset >= sizeof(Header) &&
+           header.nodes_offset + header.nodes_count * sizeof(CompiledNode) <=
+               header.child_offsets_offset &&
+           header.child_offsets_offset +
+                   (header.nodes_count + 1) * sizeof(uint32_t) <=
+               header.children_offset &&
+           header.children_offset + header.edges_count * sizeof(uint32_t) <=
+               header.strings_offset &&
+           header.strings_offset + header.strings_bytes <= bytes;
+}
+
+bool CompiledWorkload::check_children() const {
+    if (child_offsets[0] != 0 ||
+        child_offsets[header->nodes_count] != header->edges_count) {
+        return false;
+    }
+    for (uint64_t i = 0; i < header->nodes_count; i++) {
+        if (child_offsets[i] > child_offsets[i + 1]) {
+            return false;
+        }
+    }
+    for (uint64_t i = 0; i < header->edges_count; i++) {
+        if (children[i] >= header->nodes_count) {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint32_t CompiledWorkload::get_nodes_count() const {
+    return static_cast<uint32_t>(header->nodes_count);
+}
+
+const CompiledNode& CompiledWorkload::get_node(uint32_t index) const {
+    assert(index < header->nodes_count);
+    return nodes[index];
+}
+
+uint32_t CompiledWorkload::find(uint64_t node_id) const {
+    // ETs usually number their nodes densely from 0
+    if (node_id < header->nodes_count &&
+        nodes[node_id].record.node_id == node_id) {
+        return static_cast<uint32_t>(node_id);
+    }
+    const CompiledNode* end = nodes + header->nodes_count;
+    const CompiledNode* it =
+        lower_bound(nodes, end, node_id, [](const auto& node, uint64_t id) {
+            return node.record.node_id < id;
+        });
+    if (it == end || it->record.node_id != node_id) {
+        LoggerFactory::get_logger("workload")
+            ->critical("node {} not found in compiled workload", node_id);
+        exit(EXIT_FAILURE);
+    }
+    return static_cast<uint32_t>(it - nodes);
+}
+
+const uint32_t* CompiledWorkload::children_begin(uint32_t index) const {
+    return children + child_offsets[index];
+}
+
+const uint32_t* CompiledWorkload::children_end(uint32_t index) const {
+    return children + child_offsets[index + 1];
+}
+
+const char* CompiledWorkload::get_string(uint32_t offset) const {
+    assert(offset < header->strings_bytes);
+    return strings + offset;
+}
+
+// CompiledDependencyResolver -------------------------------------------------
+CompiledDependencyResolver::CompiledDependencyResolver(
+    const CompiledWorkload* workload,
+    bool streaming)
+    : workload(workload), streaming(streaming) {
+    uint32_t nodes_count = workload->get_nodes_count();
+    if (!streaming) {
+        parents_left.resize(nodes_count);
+    }
+    for (uint32_t i = 0; i < nodes_count; i++) {
+        const CompiledNode& node = workload->get_node(i);
+        if (!streaming) {
+            parents_left[i] = node.parents_count;
+        }
+        if (node.parents_count == 0) {
+            dependancy_free_nodes.insert(node.record.node_id);
+        }
+    }
+}
+
+const unordered_set<uint64_t>&
+CompiledDependencyResolver::get_dependancy_free_nodes() const {
+    return dependancy_free_nodes;
+}
+
+const unordered_set<uint64_t>& CompiledDependencyResolver::get_ongoing_nodes()
+    const {
+    return ongoing_nodes;
+}
+
+void CompiledDependencyResolver::take_node(uint64_t node_id) {
+    dependancy_free_nodes.erase(node_id);
+    ongoing_nodes.insert(node_id);
+}
+
+void CompiledDependencyResolver::finish_node(uint64_t node_id) {
+    ongoing_nodes.erase(node_id);
+    uint32_t index = workload->find(node_id);
+    for (const uint32_t* child = workload->children_begin(index);
+         child != workload->children_end(index); child++) {
+        const CompiledNode& node = workload->get_node(*child);
+        if (!streaming) {
+            if (--parents_left[*child] == 0) {
+                dependancy_free_nodes.insert(node.record.node_id);
+            }
+            continue;
+        }
+        auto it = frontier_parents_left.find(*child);
+        if (it == frontier_parents_left.end()) {
+            it = frontier_parents_left.emplace(*child, node.parents_count)
+                     .first;
+        }
+        if (--it->second == 0) {
+            frontier_parents_left.erase(it);
+            dependancy_free_nodes.insert(node.record.node_id);
+        }
+    }
+}
+//-----------------------------------------------------------------------------
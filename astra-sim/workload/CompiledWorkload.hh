@@ -0,0 +1,147 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#ifndef __COMPILED_WORKLOAD_HH__
+#define __COMPILED_WORKLOAD_HH__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "astra-sim/workload/NodeTable.hh"
+
+namespace AstraSim {
+
+// A node of a compiled workload: its decoded attributes, the strings the
+// workload looks up by node, and its number of parents.
+struct CompiledNode {
+    NodeRecord record;
+    // offsets into the string table
+    uint32_t name;
+    uint32_t inputs_values;
+    uint32_t parents_count;
+    uint32_t reserved;
+};
+static_assert(sizeof(CompiledNode) == 96, "CompiledNode is stored on disk");
+
+// An ET compiled into a binary file that is mapped instead of parsed.
+// Files are keyed by the content hash of their ET, so ranks and processes
+// simulating the same trace share one file and its pages. Layout, native
+// little-endian with 8-byte aligned sections:
+//   header
+//   CompiledNode nodes[nodes_count], sorted by node id
+//   uint32_t child_offsets[nodes_count + 1]
+//   uint32_t children[edges_count], node indices, CSR by parent
+//   char strings[strings_bytes], NUL-terminated, deduplicated
+// A file whose magic, version, ET hash or ET size does not match, or whose
+// dependency graph is malformed, is not valid and gets compiled again.
+class CompiledWorkload {
+  public:
+    static constexpr uint64_t magic = 0x4c4b574d53525441ULL;  // "ATRSMWKL"
+    // Must be bumped whenever the layout, NodeRecord or the way
+    // NodeTable::decode fills it changes, so stale caches get recompiled.
+    static constexpr uint32_t version = 4;
+
+    // Returns the file of an ET hash in a cache directory.
+    static std::string get_filename(const std::string& cache_dir,
+                                    uint64_t et_hash);
+
+    // Compiles an ET file. The file is written next to its final name and
+    // renamed, so concurrent simulations never map a partial file.
+    static void compile(const std::string& et_filename,
+                        uint64_t et_hash,
+                        uint64_t et_bytes,
+                        const std::string& filename);
+
+    // Returns true if the file holds a compiled workload of the ET hash and
+    // size.
+    static bool is_valid(const std::string& filename,
+                         uint64_t et_hash,
+                         uint64_t et_bytes);
+
+    // Maps a compiled workload, nullptr if the file is not valid.
+    static CompiledWorkload* open(const std::string& filename,
+                                  uint64_t et_hash,
+                                  uint64_t et_bytes);
+
+    ~CompiledWorkload();
+
+    uint32_t get_nodes_count() const;
+    const CompiledNode& get_node(uint32_t index) const;
+    // Returns the index of a node id.
+    uint32_t find(uint64_t node_id) const;
+    const uint32_t* children_begin(uint32_t index) const;
+    const uint32_t* children_end(uint32_t index) const;
+    const char* get_string(uint32_t offset) const;
+
+  private:
+    struct Header {
+        uint64_t magic;
+        uint32_t version;
+        uint32_t header_bytes;
+        uint64_t et_hash;
+        uint64_t et_bytes;
+        uint64_t nodes_count;
+        uint64_t edges_count;
+        uint64_t strings_bytes;
+        uint64_t nodes_offset;
+        uint64_t child_offsets_offset;
+        uint64_t children_offset;
+        uint64_t strings_offset;
+    };
+
+    CompiledWorkload(void* data, size_t bytes);
+
+    // Returns true if the header describes a valid file of the given size.
+    static bool check_header(const Header& header,
+                             uint64_t et_hash,
+                             uint64_t et_bytes,
+                             size_t bytes);
+
+    // Returns true if the children lists are well-formed: offsets never
+    // decrease and end at edges_count, and every child is a node index.
+    bool check_children() const;
+
+    void* data;
+    size_t bytes;
+    const Header* header;
+    const CompiledNode* nodes;
+    const uint32_t* child_offsets;
+    const uint32_t* children;
+    const char* strings;
+};
+
+// Dependency resolution over a compiled workload, with the interface of the
+// feeder's DependancyResolver. The mapped file stays read-only; the parents
+// left per node are the only per-rank copy. When streaming, they are only
+// kept for the nodes on the dependency frontier, whose parents have started
+// finishing.
+class CompiledDependencyResolver {
+  public:
+    CompiledDependencyResolver(const CompiledWorkload* workload,
+                               bool streaming);
+
+    const std::unordered_set<uint64_t>& get_dependancy_free_nodes() const;
+    const std::unordered_set<uint64_t>& get_ongoing_nodes() const;
+    void take_node(uint64_t node_id);
+    void finish_node(uint64_t node_id);
+
+  private:
+    const CompiledWorkload* workload;
+    const bool streaming;
+    // parents left per node index
+    std::vector<uint32_t> parents_left;
+    // parents left per frontier node index, while streaming
+    std::unordered_map<uint32_t, uint32_t> frontier_parents_left;
+    std::unordered_set<uint64_t> dependancy_free_nodes;
+    std::unordered_set<uint64_t> ongoing_nodes;
+};
+
+}  // namespace AstraSim
+
+#endif /* __COMPILED_WORKLOAD_HH__ */
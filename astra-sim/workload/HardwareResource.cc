@@ -33,84 +33,68 @@ HardwareResource::HardwareResource(uint32_t num_npus, int sys_id)
     // gpu_comms_node = NULL;
 }
 
-void HardwareResource::occupy(
-    const shared_ptr<Chakra::FeederV3::ETFeederNode> node) {
-    if (node->is_cpu_op()) {
+void HardwareResource::occupy(ResourceClass resource_class, uint64_t node_id) {
+    if (resource_class == ResourceClass::CPU) {
         assert(num_in_flight_cpu_ops == 0);
         ++num_in_flight_cpu_ops;
         ++num_cpu_ops;
-        cpu_ops_node.emplace(node->id());
-    } else {
-        if (node->type() == ChakraNodeType::COMP_NODE) {
-            assert(num_in_flight_gpu_comp_ops == 0);
-            ++num_in_flight_gpu_comp_ops;
-            ++num_gpu_ops;
-            // gpu_ops_node = node;
-            gpu_ops_node.emplace(node->id());
-        } else {
-            if (node->type() == ChakraNodeType::COMM_RECV_NODE) {
-                return;
-            }
-            assert(num_in_flight_gpu_comm_ops == 0);
-            ++num_in_flight_gpu_comm_ops;
-            ++num_gpu_comms;
-            // gpu_comms_node = node;
-            gpu_comms_node.emplace(node->id());
-        }
+        cpu_ops_node.emplace(node_id);
+    } else if (resource_class == ResourceClass::GPU_COMP) {
+        assert(num_in_flight_gpu_comp_ops == 0);
+        ++num_in_flight_gpu_comp_ops;
+        ++num_gpu_ops;
+        gpu_ops_node.emplace(node_id);
+    } else if (resource_class == ResourceClass::GPU_COMM) {
+        assert(num_in_flight_gpu_comm_ops == 0);
+        ++num_in_flight_gpu_comm_ops;
+        ++num_gpu_comms;
+        gpu_comms_node.emplace(node_id);
     }
 }
 
-void HardwareResource::release(
-    const shared_ptr<Chakra::FeederV3::ETFeederNode> node) {
-    if (node->is_cpu_op()) {
+void HardwareResource::release(ResourceClass resource_class,
+                               uint64_t node_id) {
+    if (resource_class == ResourceClass::CPU) {
         --num_in_flight_cpu_ops;
         assert(num_in_flight_cpu_ops == 0);
-        this->cpu_ops_node.erase(node->id());
-    } else {
-        if (node->type() == ChakraNodeType::COMP_NODE) {
-            --num_in_flight_gpu_comp_ops;
-            assert(num_in_flight_gpu_comp_ops == 0);
-            this->gpu_ops_node.erase(node->id());
-        } else {
-            if (node->type() == ChakraNodeType::COMM_RECV_NODE) {
-                return;
-            }
-            --num_in_flight_gpu_comm_ops;
-            assert(num_in_flight_gpu_comm_ops == 0);
-            this->gpu_comms_node.erase(node->id());
-        }
+        this->cpu_ops_node.erase(node_id);
+    } else if (resource_class == ResourceClass::GPU_COMP) {
+        --num_in_flight_gpu_comp_ops;
+        assert(num_in_flight_gpu_comp_ops == 0);
+        this->gpu_ops_node.erase(node_id);
+    } else if (resource_class == ResourceClass::GPU_COMM) {
+        --num_in_flight_gpu_comm_ops;
+        assert(num_in_flight_gpu_comm_ops == 0);
+        this->gpu_comms_node.erase(node_id);
+    }
+}
+
+bool HardwareResource::is_available(ResourceClass resource_class) const {
+    if (resource_class == ResourceClass::CPU) {
+        return num_in_flight_cpu_ops == 0;
+    }
+    if (resource_class == ResourceClass::GPU_COMP) {
+        return num_in_flight_gpu_comp_ops == 0;
+    }
+    if (resource_class == ResourceClass::GPU_COMM) {
+        return num_in_flight_gpu_comm_ops == 0;
     }
+    // receives never occupy the comm resource
+    return true;
 }
 
-bool HardwareResource::is_available(
-    const shared_ptr<Chakra::FeederV3::ETFeederNode> node) const {
+HardwareResource::ResourceClass HardwareResource::get_resource_class(
+    const shared_ptr<Chakra::FeederV3::ETFeederNode> node) {
     if (node->is_cpu_op()) {
-        if (num_in_flight_cpu_ops == 0) {
-            return true;
-        } else {
-            return false;
-        }
-    } else {
-        if (node->type() == ChakraNodeType::COMP_NODE) {
-            if (num_in_flight_gpu_comp_ops == 0) {
-                return true;
-            } else {
-                return false;
-            }
-        } else {
-            if (num_in_flight_gpu_comm_ops == 0) {
-                return true;
-            } else {
-                if (node->type() == ChakraNodeType::COMM_RECV_NODE) {
-                    return true;
-                }
-                if (num_in_flight_gpu_comm_ops == 0) {
-                    return true;
-                }
-                return false;
-            }
-        }
+        return ResourceClass::CPU;
+    }
+    if (node->type() == ChakraNodeType::COMP_NODE) {
+        return ResourceClass::GPU_COMP;
+    }
+    if (node->type() == ChakraNodeType::COMM_RECV_NODE) {
+        return ResourceClass::GPU_RECV;
     }
+    return ResourceClass::GPU_COMM;
 }
 
 void HardwareResource::report() {
@@ -17,6 +17,11 @@ namespace AstraSim {
 
 class HardwareResource {
   public:
+    // Resource a node runs on. Every non-compute GPU node shares the comm
+    // resource, except receives, which never occupy it.
+    enum class ResourceClass { CPU = 0, GPU_COMP, GPU_COMM, GPU_RECV };
+    static constexpr int num_resource_classes = 4;
+
     HardwareResource(uint32_t num_npus, int sys_id = -1);
     ~HardwareResource() {
         auto logger = LoggerFactory::get_logger("HardwareResource");
@@ -37,10 +42,11 @@ class HardwareResource {
             logger->critical("GPU comm node id: {}", node_id);
         }
     }
-    void occupy(const std::shared_ptr<Chakra::FeederV3::ETFeederNode> node);
-    void release(const std::shared_ptr<Chakra::FeederV3::ETFeederNode> node);
-    bool is_available(
-        const std::shared_ptr<Chakra::FeederV3::ETFeederNode> node) const;
+    void occupy(ResourceClass resource_class, uint64_t node_id);
+    void release(ResourceClass resource_class, uint64_t node_id);
+    bool is_available(ResourceClass resource_class) const;
+    static ResourceClass get_resource_class(
+        const std::shared_ptr<Chakra::FeederV3::ETFeederNode> node);
     void report();
 
     std::unordered_set<uint64_t> cpu_ops_node;
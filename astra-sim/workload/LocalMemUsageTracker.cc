@@ -43,7 +43,7 @@ void LocalMemUsageTracker::recordReads(
   const std::shared_ptr<Chakra::ETFeederNode> node,
   Tick start,
   Tick end) {
-  static std::vector<std::tuple<TensorId, uint64_t>> IOinfos;
+  static thread_local std::vector<std::tuple<TensorId, uint64_t>> IOinfos;
   IOinfos.clear();
   uint64_t nodeId = node->id();
 
@@ -102,7 +102,7 @@ void LocalMemUsageTracker::recordWrites(
   const std::shared_ptr<Chakra::ETFeederNode> node,
   Tick start,
   Tick end) {
-  static std::vector<std::tuple<TensorId, uint64_t>> IOinfos;
+  static thread_local std::vector<std::tuple<TensorId, uint64_t>> IOinfos;
   IOinfos.clear();
   uint64_t nodeId = node->id();
 
@@ -0,0 +1,222 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "astra-sim/workload/NodeTable.hh"
+
+#include <cassert>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+using namespace AstraSim;
+using namespace Chakra::FeederV3;
+
+typedef ChakraProtoMsg::NodeType ChakraNodeType;
+
+NodeTable::NodeTable(int sys_id, bool roofline_enabled)
+    : sys_id(sys_id),
+      roofline_enabled(roofline_enabled) {}
+
+NodeRecord NodeTable::decode(const shared_ptr<ETFeederNode>& node) {
+    NodeRecord record{};
+    const auto node_type = node->type();
+    record.node_id = node->id();
+    record.type = static_cast<uint8_t>(node_type);
+    record.resource_class =
+        static_cast<uint8_t>(HardwareResource::get_resource_class(node));
+    if (node->is_cpu_op()) {
+        record.flags |= NodeRecord::FLAG_IS_CPU_OP;
+    }
+    if (node->is_cpu_op<bool>(false)) {
+        record.flags |= NodeRecord::FLAG_IS_CPU_OP_ATTR;
+    }
+    record.runtime = node->runtime();
+    record.pg_id = -1;
+
+    // only read the attributes the node type has; num_ops and tensor_size
+    // are only required in roofline mode, which add() checks, so the record
+    // does not depend on it
+    if (node_type == ChakraNodeType::COMP_NODE ||
+        node_type == ChakraNodeType::MEM_LOAD_NODE ||
+        node_type == ChakraNodeType::MEM_STORE_NODE) {
+        if (node->has_attr("num_ops")) {
+            record.num_ops = node->num_ops<uint64_t>();
+        } else {
+            record.flags |= NodeRecord::FLAG_NO_NUM_OPS;
+        }
+        if (node->has_attr("tensor_size")) {
+            record.tensor_size = node->tensor_size<uint64_t>();
+        } else {
+            record.flags |= NodeRecord::FLAG_NO_TENSOR_SIZE;
+        }
+    }
+
+    if (node_type == ChakraNodeType::COMM_COLL_NODE) {
+        record.comm_type = node->comm_type<uint64_t>();
+        record.comm_size = node->comm_size<uint64_t>();
+        record.comm_priority = node->comm_priority<uint32_t>();
+        string pg_name = node->pg_name<string>("");
+        if (pg_name != "") {
+            record.pg_id = stoi(pg_name);
+        }
+        decode_involved_dims(node, record.involved_dims,
+                             record.involved_dims_count);
+    } else if (node_type == ChakraNodeType::COMM_SEND_NODE) {
+        if (node->has_attr("comm_src")) {
+            record.comm_src = node->comm_src<uint32_t>();
+        } else {
+            record.flags |= NodeRecord::FLAG_COMM_SRC_IS_RANK;
+        }
+        record.comm_dst = node->comm_dst<uint32_t>();
+        record.comm_size = node->comm_size<uint64_t>();
+        record.comm_tag = node->comm_tag<uint32_t>();
+    } else if (node_type == ChakraNodeType::COMM_RECV_NODE) {
+        record.comm_src = node->comm_src<uint32_t>();
+        if (node->has_attr("comm_dst")) {
+            record.comm_dst = node->comm_dst<uint32_t>();
+        } else {
+            record.flags |= NodeRecord::FLAG_COMM_DST_IS_RANK;
+        }
+        record.comm_size = node->comm_size<uint64_t>();
+        record.comm_tag = node->comm_tag<uint32_t>();
+    }
+    return record;
+}
+
+LocalNodeId NodeTable::add(const shared_ptr<ETFeederNode>& node) {
+    auto it = local_ids.find(node->id());
+    if (it != local_ids.end()) {
+        return it->second;
+    }
+    return add(decode(node));
+}
+
+LocalNodeId NodeTable::add(const NodeRecord& record) {
+    auto it = local_ids.find(record.node_id);
+    if (it != local_ids.end()) {
+        return it->second;
+    }
+    // GPU compute nodes are issued through the roofline model
+    if (roofline_enabled &&
+        record.type == static_cast<uint8_t>(ChakraNodeType::COMP_NODE) &&
+        (record.flags & NodeRecord::FLAG_IS_CPU_OP_ATTR) == 0) {
+        if (record.flags & NodeRecord::FLAG_NO_NUM_OPS) {
+            throw runtime_error("node " + to_string(record.node_id) +
+                                " has no num_ops, which roofline requires");
+        }
+        if (record.flags & NodeRecord::FLAG_NO_TENSOR_SIZE) {
+            throw runtime_error("node " + to_string(record.node_id) +
+                                " has no tensor_size, which roofline "
+                                "requires");
+        }
+    }
+    LocalNodeId local_id;
+    if (free_local_ids.empty()) {
+        local_id = size();
+        resize(local_id + 1);
+    } else {
+        // reuse the slot of an evicted node
+        local_id = free_local_ids.back();
+        free_local_ids.pop_back();
+    }
+    local_ids.emplace(record.node_id, local_id);
+
+    node_id[local_id] = record.node_id;
+    type[local_id] = static_cast<ChakraNodeType>(record.type);
+    resource_class[local_id] =
+        static_cast<HardwareResource::ResourceClass>(record.resource_class);
+    is_cpu_op[local_id] = (record.flags & NodeRecord::FLAG_IS_CPU_OP) != 0;
+    is_cpu_op_attr[local_id] =
+        (record.flags & NodeRecord::FLAG_IS_CPU_OP_ATTR) != 0;
+    runtime[local_id] = record.runtime;
+    num_ops[local_id] = record.num_ops;
+    tensor_size[local_id] = record.tensor_size;
+    comm_type[local_id] = record.comm_type;
+    comm_size[local_id] = record.comm_size;
+    comm_src[local_id] = (record.flags & NodeRecord::FLAG_COMM_SRC_IS_RANK)
+                             ? static_cast<uint32_t>(sys_id)
+                             : record.comm_src;
+    comm_dst[local_id] = (record.flags & NodeRecord::FLAG_COMM_DST_IS_RANK)
+                             ? static_cast<uint32_t>(sys_id)
+                             : record.comm_dst;
+    comm_tag[local_id] = record.comm_tag;
+    comm_priority[local_id] = record.comm_priority;
+    pg_id[local_id] = record.pg_id;
+    involved_dims[local_id] = record.involved_dims;
+    involved_dims_count[local_id] = record.involved_dims_count;
+
+    return local_id;
+}
+
+LocalNodeId NodeTable::get_local_id(uint64_t node_id) const {
+    auto it = local_ids.find(node_id);
+    assert(it != local_ids.end());
+    return it->second;
+}
+
+void NodeTable::remove(LocalNodeId local_id) {
+    local_ids.erase(node_id[local_id]);
+    free_local_ids.push_back(local_id);
+}
+
+uint32_t NodeTable::size() const {
+    return static_cast<uint32_t>(node_id.size());
+}
+
+void NodeTable::resize(uint32_t size) {
+    node_id.resize(size);
+    type.resize(size);
+    resource_class.resize(size);
+    is_cpu_op.resize(size);
+    is_cpu_op_attr.resize(size);
+    runtime.resize(size);
+    num_ops.resize(size);
+    tensor_size.resize(size);
+    comm_type.resize(size);
+    comm_size.resize(size);
+    comm_src.resize(size);
+    comm_dst.resize(size);
+    comm_tag.resize(size);
+    comm_priority.resize(size);
+    pg_id.resize(size);
+    involved_dims.resize(size);
+    involved_dims_count.resize(size);
+}
+
+void NodeTable::decode_involved_dims(const shared_ptr<ETFeederNode>& node,
+                                     uint32_t& mask,
+                                     uint8_t& count) {
+    mask = 0;
+    if (!node->has_attr("involved_dim")) {
+        // involved_dims does not exist in ETFeeder.
+        // Assume involved_dims = [1,1,1,1] which we could simulate
+        // 4-Dimension. Could use Process Group to build involved_dims later.
+        count = 4;
+        mask = (1u << count) - 1;
+        return;
+    }
+
+    const ChakraProtoMsg::AttributeProto& attr =
+        node->get_attr_msg("involved_dim");
+    // Ensure the attribute is of type bool_list before accessing
+    if (!attr.has_bool_list()) {
+        cerr << "Expected bool_list in involved_dim but found another type."
+             << endl;
+        exit(EXIT_FAILURE);
+    }
+    const ChakraProtoMsg::BoolList& bool_list = attr.bool_list();
+    if (bool_list.values_size() > 32) {
+        cerr << "involved_dim of node " << node->id()
+             << " has more than 32 dimensions." << endl;
+        exit(EXIT_FAILURE);
+    }
+    count = static_cast<uint8_t>(bool_list.values_size());
+    for (int i = 0; i < bool_list.values_size(); ++i) {
+        if (bool_list.values(i)) {
+            mask |= 1u << i;
+        }
+    }
+}
@@ -0,0 +1,132 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#ifndef __NODE_TABLE_HH__
+#define __NODE_TABLE_HH__
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "astra-sim/workload/HardwareResource.hh"
+#include "extern/graph_frontend/chakra/src/feeder_v3/et_feeder.h"
+
+namespace AstraSim {
+
+// Index of a node in the NodeTable of its workload.
+typedef uint32_t LocalNodeId;
+
+// Decoded attributes of one ET node, in a fixed-width layout that compiled
+// workloads store as is. A record does not depend on the rank it is loaded
+// for: the comm src of sends and the comm dst of receives that fall back to
+// the rank are flagged instead of resolved.
+struct NodeRecord {
+    static constexpr uint8_t FLAG_IS_CPU_OP = 1 << 0;
+    static constexpr uint8_t FLAG_IS_CPU_OP_ATTR = 1 << 1;
+    static constexpr uint8_t FLAG_COMM_SRC_IS_RANK = 1 << 2;
+    static constexpr uint8_t FLAG_COMM_DST_IS_RANK = 1 << 3;
+    // num_ops and tensor_size are read as 0 if the node does not have them
+    static constexpr uint8_t FLAG_NO_NUM_OPS = 1 << 4;
+    static constexpr uint8_t FLAG_NO_TENSOR_SIZE = 1 << 5;
+
+    uint64_t node_id;
+    uint64_t runtime;
+    uint64_t num_ops;
+    uint64_t tensor_size;
+    uint64_t comm_type;
+    uint64_t comm_size;
+    uint32_t comm_src;
+    uint32_t comm_dst;
+    uint32_t comm_tag;
+    uint32_t comm_priority;
+    int32_t pg_id;
+    uint32_t involved_dims;
+    uint8_t type;
+    uint8_t resource_class;
+    uint8_t flags;
+    uint8_t involved_dims_count;
+    uint32_t reserved;
+};
+static_assert(sizeof(NodeRecord) == 80, "NodeRecord is stored on disk");
+
+// Attributes of the ET nodes a workload issues, decoded once from the
+// protobuf-backed ETFeederNode accessors into one column per attribute.
+// Nodes are added when they become dependency-free; the issue and
+// completion paths then read the columns by local id instead of going
+// through shared ETFeederNode pointers. Streaming workloads remove finished
+// nodes, so the table only grows with the nodes in flight.
+class NodeTable {
+  public:
+    // With roofline enabled, GPU compute nodes must have num_ops and
+    // tensor_size.
+    NodeTable(int sys_id, bool roofline_enabled);
+
+    // Decodes the attributes of a node.
+    static NodeRecord decode(
+        const std::shared_ptr<Chakra::FeederV3::ETFeederNode>& node);
+
+    // Decodes a node, returning its local id. A node is decoded only once.
+    LocalNodeId add(
+        const std::shared_ptr<Chakra::FeederV3::ETFeederNode>& node);
+
+    // Adds a decoded node, returning its local id. Throws if the node lacks
+    // an attribute the workload requires.
+    LocalNodeId add(const NodeRecord& record);
+
+    // Returns the local id of a node that was added before.
+    LocalNodeId get_local_id(uint64_t node_id) const;
+
+    // Evicts a finished node. Its local id is reused by the next node added.
+    void remove(LocalNodeId local_id);
+
+    uint32_t size() const;
+
+    // all nodes
+    std::vector<uint64_t> node_id;
+    std::vector<ChakraProtoMsg::NodeType> type;
+    std::vector<HardwareResource::ResourceClass> resource_class;
+    // is_cpu_op() with the feeder's default
+    std::vector<bool> is_cpu_op;
+    // is_cpu_op attribute, false if the node does not have it
+    std::vector<bool> is_cpu_op_attr;
+    // in microseconds
+    std::vector<uint64_t> runtime;
+
+    // compute and remote memory nodes
+    std::vector<uint64_t> num_ops;
+    std::vector<uint64_t> tensor_size;
+
+    // communication nodes; src of sends and dst of receives default to the
+    // rank of the workload
+    std::vector<uint64_t> comm_type;
+    std::vector<uint64_t> comm_size;
+    std::vector<uint32_t> comm_src;
+    std::vector<uint32_t> comm_dst;
+    std::vector<uint32_t> comm_tag;
+    std::vector<uint32_t> comm_priority;
+    // communicator group, -1 if none
+    std::vector<int32_t> pg_id;
+    // bit i is set if dimension i is involved
+    std::vector<uint32_t> involved_dims;
+    std::vector<uint8_t> involved_dims_count;
+
+  private:
+    void resize(uint32_t size);
+
+    static void decode_involved_dims(
+        const std::shared_ptr<Chakra::FeederV3::ETFeederNode>& node,
+        uint32_t& mask,
+        uint8_t& count);
+
+    const int sys_id;
+    const bool roofline_enabled;
+    std::unordered_map<uint64_t, LocalNodeId> local_ids;
+    std::vector<LocalNodeId> free_local_ids;
+};
+
+}  // namespace AstraSim
+
+#endif /* __NODE_TABLE_HH__ */
@@ -0,0 +1,52 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "astra-sim/workload/ReadyNodeQueue.hh"
+
+using namespace std;
+using namespace AstraSim;
+
+void ReadyNodeQueue::sync(const unordered_set<uint64_t>& free_nodes,
+                          const function<LocalNodeId(uint64_t)>& add_node,
+                          const NodeTable& node_table) {
+    if (free_nodes.size() == queued_node_ids.size()) {
+        return;
+    }
+
+    for (const auto node_id : free_nodes) {
+        if (!queued_node_ids.insert(node_id).second) {
+            continue;
+        }
+        LocalNodeId local_id = add_node(node_id);
+        int resource_class =
+            static_cast<int>(node_table.resource_class[local_id]);
+        queues[resource_class].emplace(node_id, local_id);
+    }
+}
+
+optional<LocalNodeId> ReadyNodeQueue::pop(
+    const HardwareResource& hw_resource) {
+    int best_class = -1;
+    for (int i = 0; i < HardwareResource::num_resource_classes; i++) {
+        if (queues[i].empty() ||
+            !hw_resource.is_available(
+                static_cast<HardwareResource::ResourceClass>(i))) {
+            continue;
+        }
+        if (best_class == -1 ||
+            queues[i].begin()->first < queues[best_class].begin()->first) {
+            best_class = i;
+        }
+    }
+    if (best_class == -1) {
+        return nullopt;
+    }
+
+    auto head = queues[best_class].begin();
+    LocalNodeId local_id = head->second;
+    queued_node_ids.erase(head->first);
+    queues[best_class].erase(head);
+    return local_id;
+}
@@ -0,0 +1,49 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#ifndef __READY_NODE_QUEUE_HH__
+#define __READY_NODE_QUEUE_HH__
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <optional>
+#include <unordered_set>
+
+#include "astra-sim/workload/HardwareResource.hh"
+#include "astra-sim/workload/NodeTable.hh"
+
+namespace AstraSim {
+
+// Dependency-free nodes of a workload, queued per resource class in node id
+// order. A node is looked up and decoded into the node table once, when it
+// becomes dependency-free, and stays queued until its resource is
+// available, so nodes blocked on a busy resource are not revisited on every
+// event.
+class ReadyNodeQueue {
+  public:
+    // Queues the nodes that became dependency-free since the last call,
+    // adding them to the node table with add_node.
+    // Every node leaves the resolver's free set through pop() and take_node,
+    // so the free set only has new nodes when it outgrows the queue.
+    void sync(const std::unordered_set<uint64_t>& free_nodes,
+              const std::function<LocalNodeId(uint64_t)>& add_node,
+              const NodeTable& node_table);
+
+    // Returns the lowest-id node whose resource is available, if any.
+    // Walking the queues this way issues nodes in the same order as scanning
+    // the sorted free set and skipping the nodes of busy resources.
+    std::optional<LocalNodeId> pop(const HardwareResource& hw_resource);
+
+  private:
+    // node id -> local id, per resource class
+    std::map<uint64_t, LocalNodeId>
+        queues[HardwareResource::num_resource_classes];
+    std::unordered_set<uint64_t> queued_node_ids;
+};
+
+}  // namespace AstraSim
+
+#endif /* __READY_NODE_QUEUE_HH__ */
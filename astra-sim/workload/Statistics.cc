@@ -1,15 +1,69 @@
 #include "astra-sim/workload/Statistics.hh"
+#include "astra-sim/system/Checkpoint.hh"
 #include "astra-sim/system/Sys.hh"
 #include "astra-sim/workload/Workload.hh"
 #include <algorithm>
 #include <cassert>
+#include <iterator>
 #include <map>
 #include <unordered_map>
 #include <vector>
 
 using namespace AstraSim;
 
-Statistics::Statistics(Workload* workload) : workload(workload) {}
+namespace {
+const char* operator_type_name(
+    Statistics::OperatorStatistics::OperatorType type) {
+    using OperatorType = Statistics::OperatorStatistics::OperatorType;
+    if (type == OperatorType::CPU) {
+        return "CPU";
+    } else if (type == OperatorType::GPU) {
+        return "GPU";
+    } else if (type == OperatorType::COMM) {
+        return "COMM";
+    } else if (type == OperatorType::REMOTE_MEM) {
+        return "REMOTE_MEM";
+    } else if (type == OperatorType::REPLAY) {
+        return "REPLAY";
+    }
+    return "INVALID";
+}
+
+template <typename T>
+void write_optional(std::ofstream& file, const std::optional<T>& value) {
+    file << ',';
+    if (value.has_value()) {
+        file << value.value();
+    }
+}
+}  // namespace
+
+Statistics::Statistics(Workload* workload)
+    : workload(workload),
+      streaming(false),
+      folded_count(0),
+      folded_wall_time(0),
+      total_compute_bound_time(0),
+      total_compute_time(1ul),  // To avoid division by zero
+      total_compute_utilization(0),
+      total_memory_utilization(0),
+      total_operation_intensity(0) {}
+
+void Statistics::enable_streaming(const std::string& spill_filename) {
+    streaming = true;
+    if (spill_filename.empty()) {
+        return;
+    }
+    spill_file.open(spill_filename);
+    if (!spill_file.is_open()) {
+        LoggerFactory::get_logger("statistics")
+            ->critical("Unable to open spill file {}", spill_filename);
+        exit(EXIT_FAILURE);
+    }
+    spill_file << "node_id,type,start_time,end_time,comm_size,"
+                  "network_bandwidth,compute_utilization,"
+                  "memory_utilization,operation_intensity,is_memory_bound\n";
+}
 
 Statistics::OperatorStatistics& Statistics::get_operator_statistics(
     NodeId node_id) {
@@ -26,24 +80,133 @@ const std::unordered_map<NodeId, Statistics::OperatorStatistics>& Statistics::
     return operator_statistics;
 }
 
-void Statistics::record_start(std::shared_ptr<Chakra::ETFeederNode> node,
+void Statistics::record_start(NodeId node_id,
+                              OperatorStatistics::OperatorType type,
                               Tick start_time) {
-    const NodeId& node_id = node->id();
-    const auto type = OperatorStatistics::get_operator_type(node);
     operator_statistics[node_id] =
         OperatorStatistics(node_id, start_time, type);
     start_times.insert({start_time, node_id});
 }
 
-void Statistics::record_end(std::shared_ptr<Chakra::ETFeederNode> node,
-                            Tick end_time) {
-    const NodeId& node_id = node->id();
-    this->get_operator_statistics(node_id).end_time = end_time;
+void Statistics::checkpoint(CheckpointWriter& writer) const {
+    // sorted, so that the file does not depend on hash order
+    std::map<NodeId, const OperatorStatistics*> sorted;
+    for (const auto& [node_id, op_stat] : operator_statistics) {
+        sorted[node_id] = &op_stat;
+    }
+    writer.write_u64(sorted.size());
+    for (const auto& [node_id, op_stat] : sorted) {
+        writer.write_u64(node_id);
+        writer.write_u64(op_stat->start_time);
+        writer.write_u64(op_stat->end_time);
+        writer.write_u64(static_cast<uint64_t>(op_stat->type));
+        writer.write_optional(op_stat->memory_utilization);
+        writer.write_optional(op_stat->compute_utilization);
+        writer.write_optional(op_stat->operation_intensity);
+        writer.write_optional(op_stat->is_memory_bound);
+        writer.write_optional(op_stat->comm_size);
+        writer.write_optional(op_stat->network_bandwidth);
+    }
+}
+
+void Statistics::restore(CheckpointReader& reader) {
+    operator_statistics.clear();
+    start_times.clear();
+    uint64_t count = reader.read_u64();
+    for (uint64_t i = 0; i < count; i++) {
+        NodeId node_id = reader.read_u64();
+        Tick start_time = reader.read_u64();
+        Tick end_time = reader.read_u64();
+        auto type = static_cast<OperatorStatistics::OperatorType>(
+            reader.read_u64());
+        OperatorStatistics op_stat(node_id, start_time, end_time, type);
+        op_stat.memory_utilization = reader.read_optional<double>();
+        op_stat.compute_utilization = reader.read_optional<double>();
+        op_stat.operation_intensity = reader.read_optional<double>();
+        op_stat.is_memory_bound = reader.read_optional<bool>();
+        op_stat.comm_size = reader.read_optional<uint64_t>();
+        op_stat.network_bandwidth = reader.read_optional<double>();
+        operator_statistics[node_id] = op_stat;
+        start_times.insert({start_time, node_id});
+    }
+}
+
+void Statistics::record_end(NodeId node_id, Tick end_time) {
+    auto& stat = this->get_operator_statistics(node_id);
+    stat.end_time = end_time;
+    if (!streaming) {
+        return;
+    }
+
+    fold(stat);
+    auto range = start_times.equal_range(stat.start_time);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == node_id) {
+            start_times.erase(it);
+            break;
+        }
+    }
+    operator_statistics.erase(node_id);
+
+    // nodes start at the current tick at the earliest, so busy intervals
+    // that end before every running node started are final
+    Tick frontier = end_time;
+    if (!start_times.empty()) {
+        frontier = std::min(frontier, start_times.begin()->first);
+    }
+    for (auto& [type, aggregate] : folded_type_time) {
+        auto& intervals = aggregate.open_intervals;
+        while (!intervals.empty() && intervals.begin()->second <= frontier) {
+            aggregate.folded_time +=
+                intervals.begin()->second - intervals.begin()->first;
+            intervals.erase(intervals.begin());
+        }
+    }
+}
+
+void Statistics::fold(const OperatorStatistics& stat) {
+    folded_count++;
+    folded_wall_time = std::max(folded_wall_time, stat.end_time);
+
+    // merge the busy interval of the node with the open ones it overlaps
+    auto& intervals = folded_type_time[stat.type].open_intervals;
+    Tick start = stat.start_time;
+    Tick end = stat.end_time;
+    auto it = intervals.upper_bound(start);
+    if (it != intervals.begin() && std::prev(it)->second >= start) {
+        --it;
+        start = it->first;
+        end = std::max(end, it->second);
+        it = intervals.erase(it);
+    }
+    while (it != intervals.end() && it->first <= end) {
+        end = std::max(end, it->second);
+        it = intervals.erase(it);
+    }
+    intervals.emplace(start, end);
+
+    add_utilizations(stat);
+    if (spill_file.is_open()) {
+        spill(stat);
+    }
+}
+
+void Statistics::spill(const OperatorStatistics& stat) {
+    spill_file << stat.node_id << ',' << operator_type_name(stat.type) << ','
+               << stat.start_time << ',' << stat.end_time;
+    write_optional(spill_file, stat.comm_size);
+    write_optional(spill_file, stat.network_bandwidth);
+    write_optional(spill_file, stat.compute_utilization);
+    write_optional(spill_file, stat.memory_utilization);
+    write_optional(spill_file, stat.operation_intensity);
+    write_optional(spill_file, stat.is_memory_bound);
+    spill_file << '\n';
 }
 
 Statistics::OperatorStatistics::OperatorType Statistics::OperatorStatistics::
-    get_operator_type(const std::shared_ptr<Chakra::ETFeederNode> node) {
-    const auto& node_type = node->type();
+    get_operator_type(NodeId node_id,
+                      ChakraNodeType node_type,
+                      bool is_cpu_op) {
     Statistics::OperatorStatistics::OperatorType stat_node_type;
     switch (node_type) {
     case ChakraNodeType::MEM_LOAD_NODE:
@@ -53,9 +216,8 @@ Statistics::OperatorStatistics::OperatorType Statistics::OperatorStatistics::
         break;
     case ChakraNodeType::COMP_NODE:
         stat_node_type =
-            node->is_cpu_op()
-                ? Statistics::OperatorStatistics::OperatorType::CPU
-                : Statistics::OperatorStatistics::OperatorType::GPU;
+            is_cpu_op ? Statistics::OperatorStatistics::OperatorType::CPU
+                      : Statistics::OperatorStatistics::OperatorType::GPU;
         break;
     case ChakraNodeType::COMM_COLL_NODE:
     case ChakraNodeType::COMM_SEND_NODE:
@@ -68,7 +230,7 @@ Statistics::OperatorStatistics::OperatorType Statistics::OperatorStatistics::
     default:
         LoggerFactory::get_logger("statistics")
             ->critical("Invalid node_type, node.id={}, node.type={}",
-                       node->id(), static_cast<uint64_t>(node->type()));
+                       node_id, static_cast<uint64_t>(node_type));
         assert(false);
     }
     return stat_node_type;
@@ -219,42 +381,35 @@ void Statistics::report() const {
     report(LoggerFactory::get_logger("statistics"));
 }
 
-void Statistics::extract_utilizations() {
-    Tick total_compute_bound_time = 0;
-    double total_compute_utilization = 0;
-    double total_memory_utilization = 0;
-    double total_operation_intensity = 0;
-    Tick total_compute_time = 1ul;  // To avoid division by zero
+void Statistics::add_utilizations(const OperatorStatistics& stat) {
+    if (stat.type != OperatorStatistics::OperatorType::CPU &&
+        stat.type != OperatorStatistics::OperatorType::GPU) {
+        return;
+    }
+    Tick duration = stat.end_time - stat.start_time;
 
-    for (const auto& [node_id, stat] : operator_statistics) {
-        if (stat.type == OperatorStatistics::OperatorType::CPU ||
-            stat.type == OperatorStatistics::OperatorType::GPU) {
-            Tick duration = stat.end_time - stat.start_time;
-
-            if (stat.is_memory_bound.has_value() &&
-                !stat.is_memory_bound.value()) {
-                total_compute_bound_time += duration;
-            }
-
-            if (stat.compute_utilization.has_value()) {
-                total_compute_utilization +=
-                    stat.compute_utilization.value() * duration;
-            }
-
-            if (stat.memory_utilization.has_value()) {
-                total_memory_utilization +=
-                    stat.memory_utilization.value() * duration;
-            }
-
-            if (stat.operation_intensity.has_value()) {
-                total_operation_intensity +=
-                    stat.operation_intensity.value() * duration;
-            }
-
-            total_compute_time += duration;
-        }
+    if (stat.is_memory_bound.has_value() && !stat.is_memory_bound.value()) {
+        total_compute_bound_time += duration;
+    }
+
+    if (stat.compute_utilization.has_value()) {
+        total_compute_utilization +=
+            stat.compute_utilization.value() * duration;
     }
 
+    if (stat.memory_utilization.has_value()) {
+        total_memory_utilization += stat.memory_utilization.value() * duration;
+    }
+
+    if (stat.operation_intensity.has_value()) {
+        total_operation_intensity +=
+            stat.operation_intensity.value() * duration;
+    }
+
+    total_compute_time += duration;
+}
+
+void Statistics::average_utilizations() {
     this->compute_bound_percentage_ =
         static_cast<double>(total_compute_bound_time) / total_compute_time;
     this->average_compute_utilization_ =
@@ -265,6 +420,40 @@ void Statistics::extract_utilizations() {
         total_operation_intensity / total_compute_time;
 }
 
+void Statistics::extract_utilizations() {
+    total_compute_bound_time = 0;
+    total_compute_utilization = 0;
+    total_memory_utilization = 0;
+    total_operation_intensity = 0;
+    total_compute_time = 1ul;  // To avoid division by zero
+
+    for (const auto& [node_id, stat] : operator_statistics) {
+        add_utilizations(stat);
+    }
+    average_utilizations();
+}
+
+void Statistics::extract_streamed() {
+    this->wall_time = std::max(this->wall_time, folded_wall_time);
+
+    this->type_time.clear();
+    for (const auto& [type, aggregate] : folded_type_time) {
+        Tick time = aggregate.folded_time;
+        for (const auto& [start, end] : aggregate.open_intervals) {
+            time += end - start;
+        }
+        this->type_time[type] = time;
+    }
+
+    if (workload->sys->roofline_enabled) {
+        average_utilizations();
+    }
+
+    LoggerFactory::get_logger("statistics")
+        ->info("sys[{}]. {} nodes folded into streaming statistics.",
+               this->workload->sys->id, folded_count);
+}
+
 void Statistics::post_processing() {
     const auto& logger = LoggerFactory::get_logger("statistics");
     logger->info("sys[{}]. Post statistics processing start.",
@@ -280,9 +469,13 @@ void Statistics::post_processing() {
             this->wall_time = std::max(this->wall_time, stat.end_time);
         }
     }
-    extract_type_time();
-    if (workload->sys->roofline_enabled) {
-        extract_utilizations();
+    if (streaming) {
+        extract_streamed();
+    } else {
+        extract_type_time();
+        if (workload->sys->roofline_enabled) {
+            extract_utilizations();
+        }
     }
     extract_comp_comm_overlap();
 
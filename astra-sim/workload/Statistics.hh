@@ -3,9 +3,11 @@
 
 #include "astra-sim/common/Common.hh"
 #include "astra-sim/common/Logging.hh"
+#include <fstream>
 #include <map>
 #include <memory>
 #include <optional>
+#include <string>
 #include <unordered_map>
 
 #include "extern/graph_frontend/chakra/src/feeder_v3/et_feeder.h"
@@ -16,6 +18,8 @@ typedef uint64_t NodeId;
 
 namespace AstraSim {
 class Workload;
+class CheckpointWriter;
+class CheckpointReader;
 class LocalMemoryTracker;
 class Statistics {
   public:
@@ -23,8 +27,9 @@ class Statistics {
       public:
         static const Tick INVALID_TICK = UINT64_MAX;
         enum class OperatorType { CPU, GPU, COMM, REMOTE_MEM, REPLAY, INVALID };
-        static OperatorType get_operator_type(
-            const std::shared_ptr<Chakra::ETFeederNode> node);
+        static OperatorType get_operator_type(NodeId node_id,
+                                              ChakraNodeType node_type,
+                                              bool is_cpu_op);
         OperatorStatistics(NodeId node_id,
                            Tick start_time,
                            Tick end_time,
@@ -75,10 +80,16 @@ class Statistics {
     const std::unordered_map<NodeId, OperatorStatistics>&
     get_operator_statistics() const;
 
-    void record_start(std::shared_ptr<Chakra::ETFeederNode> node,
+    void record_start(NodeId node_id,
+                      OperatorStatistics::OperatorType type,
                       Tick start_time);
 
-    void record_end(std::shared_ptr<Chakra::ETFeederNode> node, Tick end_time);
+    void record_end(NodeId node_id, Tick end_time);
+
+    // Folds the statistics of every finished node into running aggregates
+    // and drops them, so only the running nodes are kept. Each folded node
+    // is appended to the spill file if one is given.
+    void enable_streaming(const std::string& spill_filename);
 
     ~Statistics() {
         operator_statistics.clear();
@@ -90,8 +101,26 @@ class Statistics {
 
     void report() const;
 
+    void checkpoint(CheckpointWriter& writer) const;
+
+    void restore(CheckpointReader& reader);
+
   private:
+    // busy time of an operator type while streaming
+    struct TypeTimeAggregate {
+        // length of the busy intervals that no running or future node can
+        // overlap anymore
+        Tick folded_time = 0;
+        // merged busy intervals that still can, start -> end
+        std::map<Tick, Tick> open_intervals;
+    };
+
+    void fold(const OperatorStatistics& stat);
+    void spill(const OperatorStatistics& stat);
+    void extract_streamed();
     void extract_type_time();
+    void add_utilizations(const OperatorStatistics& stat);
+    void average_utilizations();
     Tick _calculateTotalRuntimeFromIntervals(
         const std::vector<std::pair<Tick, Tick>>& intervals) const;
     void extract_utilizations();
@@ -106,7 +135,23 @@ class Statistics {
     double average_operation_intensity_;
     Workload* workload;
     std::unordered_map<NodeId, OperatorStatistics> operator_statistics;
+    // start times of the running nodes only, while streaming
     std::multimap<Tick, NodeId> start_times;
+
+    // streaming execution
+    bool streaming;
+    std::ofstream spill_file;
+    uint64_t folded_count;
+    Tick folded_wall_time;
+    std::unordered_map<OperatorStatistics::OperatorType, TypeTimeAggregate>
+        folded_type_time;
+
+    // duration-weighted sums of the compute nodes
+    Tick total_compute_bound_time;
+    Tick total_compute_time;
+    double total_compute_utilization;
+    double total_memory_utilization;
+    double total_operation_intensity;
 };
 
 }  // namespace AstraSim
@@ -6,13 +6,16 @@ LICENSE file in the root directory of this source tree.
 #include "astra-sim/workload/Workload.hh"
 
 #include "astra-sim/common/Logging.hh"
+#include "astra-sim/system/Checkpoint.hh"
 #include "astra-sim/system/IntData.hh"
 #include "astra-sim/system/MemEventHandlerData.hh"
 #include "astra-sim/system/RecvPacketEventHandlerData.hh"
 #include "astra-sim/system/SendPacketEventHandlerData.hh"
 #include "astra-sim/system/WorkloadLayerHandlerData.hh"
+#include "astra-sim/workload/WorkloadLoader.hh"
 #include <json/json.hpp>
 
+#include <algorithm>
 #include <iostream>
 #include <stdlib.h>
 #include <unistd.h>
@@ -25,7 +28,8 @@ using json = nlohmann::json;
 typedef ChakraProtoMsg::NodeType ChakraNodeType;
 typedef ChakraProtoMsg::CollectiveCommType ChakraCollectiveCommType;
 
-Workload::Workload(Sys* sys, string et_filename, string comm_group_filename) {
+Workload::Workload(Sys* sys, string et_filename, string comm_group_filename)
+    : node_table(sys->id, sys->roofline_enabled) {
     string workload_filename = et_filename + "." + to_string(sys->id) + ".et";
     // Check if workload filename exists
     if (access(workload_filename.c_str(), R_OK) < 0) {
@@ -43,7 +47,22 @@ Workload::Workload(Sys* sys, string et_filename, string comm_group_filename) {
         LoggerFactory::get_logger("workload")->critical(error_msg);
         exit(EXIT_FAILURE);
     }
-    this->et_feeder = new ETFeeder(workload_filename);
+    // the local memory tracker reads tensors the workload cache does not
+    // keep, so it always runs on the feeder
+    this->et_feeder = nullptr;
+    if (!sys->track_local_mem) {
+        compiled_workload.reset(
+            WorkloadLoader::take_compiled(workload_filename));
+    }
+    if (compiled_workload != nullptr) {
+        compiled_resolver = std::make_unique<CompiledDependencyResolver>(
+            compiled_workload.get(), sys->streaming_execution);
+    } else {
+        this->et_feeder = WorkloadLoader::take(workload_filename);
+        if (this->et_feeder == nullptr) {
+            this->et_feeder = new ETFeeder(workload_filename);
+        }
+    }
     this->comm_groups.clear();
     // TODO: parametrize the number of available hardware resources
     this->hw_resource = new HardwareResource(1, sys->id);
@@ -52,7 +71,18 @@ Workload::Workload(Sys* sys, string et_filename, string comm_group_filename) {
     this->sys = sys;
     initialize_comm_groups(comm_group_filename);
     this->stats = new Statistics(this);
+    if (sys->streaming_execution) {
+        // finished nodes are folded into the statistics and evicted
+        string spill_filename;
+        if (!sys->streaming_spill_filename.empty()) {
+            spill_filename = sys->streaming_spill_filename + "." +
+                             to_string(sys->id) + ".csv";
+        }
+        this->stats->enable_streaming(spill_filename);
+    }
     this->is_finished = false;
+    this->checkpoints_enabled = false;
+    this->finish_tick = 0;
 }
 
 Workload::~Workload() {
@@ -98,10 +128,8 @@ void Workload::initialize_comm_groups(string comm_group_filename) {
     }
 }
 
-void Workload::issue_pytorch_pg_metadata(
-    std::shared_ptr<Chakra::FeederV3::ETFeederNode> node) {
+void Workload::issue_pytorch_pg_metadata(std::string pg_info) {
     // For read comm groups from torch, might overwrite previous.
-    std::string pg_info = node->get_inputs_values();
     if (pg_info.empty()) {
         return;
     }
@@ -134,105 +162,94 @@ void Workload::issue_pytorch_pg_metadata(
 }
 
 void Workload::issue_dep_free_nodes() {
-    auto& dependancy_resolver = this->et_feeder->getDependancyResolver();
-    auto dependancy_free_nodes =
-        dependancy_resolver.get_dependancy_free_nodes();
-    std::set<uint64_t> dependancy_free_nodes_set;
-    for (const auto node_id : dependancy_free_nodes) {
-        dependancy_free_nodes_set.insert(node_id);
-    }
-    for (const auto node_id : dependancy_free_nodes_set) {
-        std::shared_ptr<ETFeederNode> node = et_feeder->lookupNode(node_id);
-        if (hw_resource->is_available(node)) {
-            issue(node);
-        }
+    // nodes freed while issuing (e.g., skipped invalid nodes) are picked up
+    // by the next call
+    ready_nodes.sync(
+        get_dependancy_free_nodes(),
+        [this](uint64_t node_id) { return add_node(node_id); }, node_table);
+    while (const auto local_id = ready_nodes.pop(*hw_resource)) {
+        issue(*local_id);
     }
 }
 
-void Workload::issue(shared_ptr<Chakra::FeederV3::ETFeederNode> node) {
-    auto logger = LoggerFactory::get_logger("workload");
+void Workload::issue(LocalNodeId local_id) {
+    const auto node_id = node_table.node_id[local_id];
+    const auto node_type = node_table.type[local_id];
     if (sys->trace_enabled) {
-        logger->debug("issue,sys->id={}, tick={}, node->id={}, "
-                      "node->name={}, node->type={}",
-                      sys->id, Sys::boostedTick(), node->id(), node->name(),
-                      static_cast<uint64_t>(node->type()));
+        trace_node("issue", node_id);
     }
 
-    this->et_feeder->getDependancyResolver().take_node(node->id());
-    this->hw_resource->occupy(node);
+    take_node(node_id);
+    this->hw_resource->occupy(node_table.resource_class[local_id], node_id);
     // stats->record_end will be called in Workload::call
-    stats->record_start(node, Sys::boostedTick());
+    stats->record_start(node_id,
+                        Statistics::OperatorStatistics::get_operator_type(
+                            node_id, node_type, node_table.is_cpu_op[local_id]),
+                        Sys::boostedTick());
     if (this->sys->track_local_mem) {
-        this->local_mem_usage_tracker->recordStart(node, Sys::boostedTick());
+        this->local_mem_usage_tracker->recordStart(
+            et_feeder->lookupNode(node_id), Sys::boostedTick());
     }
     if (sys->replay_only) {
-        issue_replay(node);
+        issue_replay(local_id);
     } else {
-        if ((node->type() == ChakraNodeType::MEM_LOAD_NODE) ||
-            (node->type() == ChakraNodeType::MEM_STORE_NODE)) {
-            issue_remote_mem(node);
-        } else if (node->type() == ChakraNodeType::COMP_NODE) {
+        if ((node_type == ChakraNodeType::MEM_LOAD_NODE) ||
+            (node_type == ChakraNodeType::MEM_STORE_NODE)) {
+            issue_remote_mem(local_id);
+        } else if (node_type == ChakraNodeType::COMP_NODE) {
             if (!this->sys->roofline_enabled) {
-                issue_replay(node);
+                issue_replay(local_id);
             } else {
-                if (node->is_cpu_op<bool>(false)) {
+                if (node_table.is_cpu_op_attr[local_id]) {
                     // comp node on cpu
                     // should only appears in real system trace and should run
                     // with replay.
-                    issue_replay(node);
+                    issue_replay(local_id);
                 } else {
                     // comp node on gpu
                     if (sys->trace_enabled) {
-                        logger->debug("issue,sys->id={}, tick={}, node->id={}, "
-                                      "node->name={}, node->type={}",
-                                      sys->id, Sys::boostedTick(), node->id(),
-                                      node->name(),
-                                      static_cast<uint64_t>(node->type()));
+                        trace_node("issue", node_id);
                     }
-                    issue_comp(node);
-                    // if (sys->id == 0) {
-                        // logger->info("comp: tick={}, node_id={}", Sys::boostedTick(), node->id());
-                    // }
+                    issue_comp(local_id);
                 }
             }
-        } else if (node->type() == ChakraNodeType::COMM_COLL_NODE ||
-                   node->type() == ChakraNodeType::COMM_SEND_NODE ||
-                   node->type() == ChakraNodeType::COMM_RECV_NODE) {
-            issue_comm(node);
-            // if (sys->id == 0) {
-                // logger->info("comm: tick={}, node_id={}", Sys::boostedTick(), node->id());
-            // }
-        } else if (node->type() == ChakraNodeType::INVALID_NODE) {
-            skip_invalid(node);
-        } else if (node->type() == ChakraNodeType::METADATA_NODE) {
-            issue_metadata(node);
+        } else if (node_type == ChakraNodeType::COMM_COLL_NODE ||
+                   node_type == ChakraNodeType::COMM_SEND_NODE ||
+                   node_type == ChakraNodeType::COMM_RECV_NODE) {
+            issue_comm(local_id);
+        } else if (node_type == ChakraNodeType::INVALID_NODE) {
+            skip_invalid(local_id);
+        } else if (node_type == ChakraNodeType::METADATA_NODE) {
+            issue_metadata(local_id);
         } else {
-            logger->critical("Unknown node type");
+            LoggerFactory::get_logger("workload")->critical(
+                "Unknown node type");
             exit(EXIT_FAILURE);
         }
     }
 }
 
-void Workload::issue_metadata(shared_ptr<Chakra::FeederV3::ETFeederNode> node) {
+void Workload::issue_metadata(LocalNodeId local_id) {
     // TODO: someway to identify this metadata node is a pytorch pg node
     if (true) {
-        issue_pytorch_pg_metadata(node);
+        issue_pytorch_pg_metadata(
+            get_inputs_values(node_table.node_id[local_id]));
     } else {
         throw std::runtime_error("Unknown metadata node type");
     }
-    this->skip_invalid(node);  // for proper dependancy resolving
+    this->skip_invalid(local_id);  // for proper dependancy resolving
 }
 
-void Workload::issue_replay(shared_ptr<Chakra::FeederV3::ETFeederNode> node) {
+void Workload::issue_replay(LocalNodeId local_id) {
     WorkloadLayerHandlerData* wlhd = new WorkloadLayerHandlerData;
-    wlhd->node_id = node->id();
+    wlhd->node_id = node_table.node_id[local_id];
     uint64_t runtime = 1ul;
-    if (node->runtime() != 0ul) {
+    if (node_table.runtime[local_id] != 0ul) {
         // chakra runtimes are in microseconds and we should convert it into
         // nanoseconds
-        runtime = node->runtime() * 1000;
+        runtime = node_table.runtime[local_id] * 1000;
     }
-    if (node->is_cpu_op()) {
+    if (node_table.is_cpu_op[local_id]) {
         hw_resource->tics_cpu_ops += runtime;
     } else {
         hw_resource->tics_gpu_ops += runtime;
@@ -240,50 +257,50 @@ void Workload::issue_replay(shared_ptr<Chakra::FeederV3::ETFeederNode> node) {
     sys->register_event(this, EventType::General, wlhd, runtime);
 }
 
-void Workload::issue_remote_mem(
-    shared_ptr<Chakra::FeederV3::ETFeederNode> node) {
+void Workload::issue_remote_mem(LocalNodeId local_id) {
     WorkloadLayerHandlerData* wlhd = new WorkloadLayerHandlerData;
     wlhd->sys_id = sys->id;
     wlhd->workload = this;
-    wlhd->node_id = node->id();
-    sys->remote_mem->issue(node->tensor_size(), wlhd);
+    wlhd->node_id = node_table.node_id[local_id];
+    sys->remote_mem->issue(node_table.tensor_size[local_id], wlhd);
 }
 
-void Workload::issue_comp(shared_ptr<Chakra::FeederV3::ETFeederNode> node) {
+void Workload::issue_comp(LocalNodeId local_id) {
     if (!this->sys->roofline_enabled) {
         throw std::runtime_error(
             "Roofline model is not enabled for non-replay comp");
     }
 
-    if (node->is_cpu_op()) {
+    if (node_table.is_cpu_op[local_id]) {
         throw std::runtime_error("Roofline is only available for GPU nodes");
         return;
     }
 
-    WorkloadLayerHandlerData* wlhd = new WorkloadLayerHandlerData;
-    wlhd->node_id = node->id();
-
-    double num_ops = static_cast<double>(node->num_ops<uint64_t>());
-    double tensor_size = static_cast<double>(node->tensor_size<uint64_t>());
+    const auto node_id = node_table.node_id[local_id];
+    double num_ops = static_cast<double>(node_table.num_ops[local_id]);
+    double tensor_size = static_cast<double>(node_table.tensor_size[local_id]);
 
     // if tensor_size is 0 during roofline mode, this is an invalid node
     if (tensor_size == 0) {
-        skip_invalid(node);
+        skip_invalid(local_id);
         return;
     }
 
+    WorkloadLayerHandlerData* wlhd = new WorkloadLayerHandlerData;
+    wlhd->node_id = node_id;
+
     double operational_intensity = num_ops / tensor_size;
     double perf = sys->roofline->get_perf(operational_intensity);
-    double elapsed_time = static_cast<double>(node->num_ops()) / perf;  // sec
+    double elapsed_time = num_ops / perf;  // sec
     uint64_t runtime = static_cast<uint64_t>(elapsed_time * 1e9);  // sec -> ns
-    if (node->is_cpu_op()) {
+    if (node_table.is_cpu_op[local_id]) {
         hw_resource->tics_cpu_ops += runtime;
     } else {
         hw_resource->tics_gpu_ops += runtime;
     }
     sys->register_event(this, EventType::General, wlhd, runtime);
 
-    auto& op_stat = this->stats->get_operator_statistics(node->id());
+    auto& op_stat = this->stats->get_operator_statistics(node_id);
     op_stat.operation_intensity = operational_intensity;
     op_stat.compute_utilization = perf / sys->peak_perf;
     op_stat.memory_utilization =
@@ -298,100 +315,75 @@ void Workload::issue_comp(shared_ptr<Chakra::FeederV3::ETFeederNode> node) {
                 op_stat.memory_utilization.value(), tensor_size, num_ops);
 }
 
-void Workload::issue_comm(shared_ptr<Chakra::FeederV3::ETFeederNode> node) {
-    if (node->is_cpu_op<bool>(false)) {
+void Workload::issue_comm(LocalNodeId local_id) {
+    if (node_table.is_cpu_op_attr[local_id]) {
         throw std::runtime_error("Comm node should not be on CPU");
     }
-    const auto node_type = node->type();
+    const auto node_type = node_table.type[local_id];
     if (node_type == ChakraNodeType::COMM_COLL_NODE) {
-        this->issue_coll_comm(node);
+        this->issue_coll_comm(local_id);
     } else if (node_type == ChakraNodeType::COMM_SEND_NODE) {
-        this->issue_send_comm(node);
+        this->issue_send_comm(local_id);
     } else if (node_type == ChakraNodeType::COMM_RECV_NODE) {
-        this->issue_recv_comm(node);
+        this->issue_recv_comm(local_id);
     } else {
         throw std::runtime_error("Unknown comm node type");
     }
 }
 
-void Workload::issue_coll_comm(
-    shared_ptr<Chakra::FeederV3::ETFeederNode> node) {
-    const bool has_involve_dims = node->has_attr("involve_dims");
+void Workload::issue_coll_comm(LocalNodeId local_id) {
+    const auto node_id = node_table.node_id[local_id];
     std::vector<bool> involved_dims;
-    if (node->has_attr("involved_dim")) {
-        const ChakraProtoMsg::AttributeProto& attr =
-            node->get_attr_msg("involved_dim");
-
-        // Ensure the attribute is of type bool_list before accessing
-        if (attr.has_bool_list()) {
-            const ChakraProtoMsg::BoolList& bool_list = attr.bool_list();
-
-            // Traverse bool_list and add values to involved_dim
-            for (int i = 0; i < bool_list.values_size(); ++i) {
-                involved_dims.push_back(bool_list.values(i));
-            }
-        } else {
-            cerr << "Expected bool_list in involved_dim but found another type."
-                 << endl;
-            exit(EXIT_FAILURE);
-        }
-    } else {
-        // involved_dims does not exist in ETFeeder.
-        // Assume involved_dims = [1,1,1,1,1] which we could simulate
-        // 5-Dimension. Could use Process Group to build involved_dims later.
-        // Once process group is implemented, you should get
-        // that with node->pg_name()
-
-        for (int i = 0; i < 4; i++) {
-            involved_dims.push_back(true);
-        }
+    const auto involved_dims_mask = node_table.involved_dims[local_id];
+    for (int i = 0; i < node_table.involved_dims_count[local_id]; i++) {
+        involved_dims.push_back((involved_dims_mask >> i) & 1u);
     }
 
-    CommunicatorGroup* comm_group = extract_comm_group(node);
+    CommunicatorGroup* comm_group = extract_comm_group(local_id);
     const auto comm_type =
-        static_cast<ChakraCollectiveCommType>(node->comm_type<uint64_t>());
-    const auto comm_size = node->comm_size<uint64_t>();
+        static_cast<ChakraCollectiveCommType>(node_table.comm_type[local_id]);
+    const auto comm_size = node_table.comm_size[local_id];
     // Record communication size for bandwidth calculation
-    stats->get_operator_statistics(node->id()).comm_size = comm_size;
+    stats->get_operator_statistics(node_id).comm_size = comm_size;
     // TODO: comm_tag? which is used to distinguish two different collective in
     // same pg
-    const auto comm_priority = node->comm_priority<uint32_t>();  // default 0u
+    const auto comm_priority = node_table.comm_priority[local_id];
 
     if (comm_type == ChakraCollectiveCommType::ALL_REDUCE) {
         DataSet* fp = sys->generate_all_reduce(comm_size, involved_dims,
                                                comm_group, comm_priority);
-        collective_comm_node_id_map[fp->my_id] = node->id();
+        collective_comm_node_id_map[fp->my_id] = node_id;
         collective_comm_wrapper_map[fp->my_id] = fp;
         fp->set_notifier(this, EventType::CollectiveCommunicationFinished);
     } else if (comm_type == ChakraCollectiveCommType::ALL_TO_ALL) {
         DataSet* fp = sys->generate_all_to_all(comm_size, involved_dims,
                                                comm_group, comm_priority);
-        collective_comm_node_id_map[fp->my_id] = node->id();
+        collective_comm_node_id_map[fp->my_id] = node_id;
         collective_comm_wrapper_map[fp->my_id] = fp;
         fp->set_notifier(this, EventType::CollectiveCommunicationFinished);
     } else if (comm_type == ChakraCollectiveCommType::ALL_GATHER) {
         DataSet* fp = sys->generate_all_gather(comm_size, involved_dims,
                                                comm_group, comm_priority);
-        collective_comm_node_id_map[fp->my_id] = node->id();
+        collective_comm_node_id_map[fp->my_id] = node_id;
         collective_comm_wrapper_map[fp->my_id] = fp;
         fp->set_notifier(this, EventType::CollectiveCommunicationFinished);
     } else if (comm_type == ChakraCollectiveCommType::REDUCE_SCATTER) {
         DataSet* fp = sys->generate_reduce_scatter(comm_size, involved_dims,
                                                    comm_group, comm_priority);
-        collective_comm_node_id_map[fp->my_id] = node->id();
+        collective_comm_node_id_map[fp->my_id] = node_id;
         collective_comm_wrapper_map[fp->my_id] = fp;
         fp->set_notifier(this, EventType::CollectiveCommunicationFinished);
     } else if (comm_type == ChakraCollectiveCommType::BROADCAST) {
         // TODO: implement broadcast, for now just replay
         uint64_t runtime = 1ul;
-        if (node->runtime() != 0ul) {
+        if (node_table.runtime[local_id] != 0ul) {
             // chakra runtimes are in microseconds and we should convert it into
             // nanoseconds
-            runtime = node->runtime() * 1000;
+            runtime = node_table.runtime[local_id] * 1000;
         }
         DataSet* fp = new DataSet(1);
         fp->set_notifier(this, EventType::CollectiveCommunicationFinished);
-        collective_comm_node_id_map[fp->my_id] = node->id();
+        collective_comm_node_id_map[fp->my_id] = node_id;
         collective_comm_wrapper_map[fp->my_id] = fp;
         sys->register_event(fp, EventType::General, nullptr,
                             // chakra runtimes are in microseconds and we
@@ -403,17 +395,17 @@ void Workload::issue_coll_comm(
     }
 }
 
-void Workload::issue_send_comm(
-    shared_ptr<Chakra::FeederV3::ETFeederNode> node) {
-    const auto src = node->comm_src<uint32_t>(this->sys->id);
+void Workload::issue_send_comm(LocalNodeId local_id) {
+    const auto node_id = node_table.node_id[local_id];
+    const auto src = node_table.comm_src[local_id];
     if (src != this->sys->id) {
         throw std::runtime_error("Send node should be issued by the sender");
     }
-    const auto dst = node->comm_dst<uint32_t>();
-    const auto size = node->comm_size<uint64_t>();
+    const auto dst = node_table.comm_dst[local_id];
+    const auto size = node_table.comm_size[local_id];
     // Record communication size for bandwidth calculation
-    stats->get_operator_statistics(node->id()).comm_size = size;
-    const auto tag = node->comm_tag<uint32_t>();
+    stats->get_operator_statistics(node_id).comm_size = size;
+    const auto tag = node_table.comm_tag[local_id];
 
     sim_request snd_req;
     snd_req.srcRank = src;
@@ -422,29 +414,29 @@ void Workload::issue_send_comm(
     SendPacketEventHandlerData* sehd = new SendPacketEventHandlerData;
     sehd->callable = this;
     sehd->wlhd = new WorkloadLayerHandlerData;
-    sehd->wlhd->node_id = node->id();
+    sehd->wlhd->node_id = node_id;
     sehd->event = EventType::PacketSent;
     sys->front_end_sim_send(0, Sys::dummy_data, size, UINT8, dst, tag, &snd_req,
                             Sys::FrontEndSendRecvType::NATIVE,
                             &Sys::handleEvent, sehd);
 }
 
-void Workload::issue_recv_comm(
-    shared_ptr<Chakra::FeederV3::ETFeederNode> node) {
-    const auto src = node->comm_src<uint32_t>();
-    const auto dst = node->comm_dst<uint32_t>(this->sys->id);
+void Workload::issue_recv_comm(LocalNodeId local_id) {
+    const auto node_id = node_table.node_id[local_id];
+    const auto src = node_table.comm_src[local_id];
+    const auto dst = node_table.comm_dst[local_id];
     if (dst != this->sys->id) {
         throw std::runtime_error("Recv node should be issued by the receiver");
     }
-    const auto size = node->comm_size<uint64_t>();
+    const auto size = node_table.comm_size[local_id];
     // Record communication size for bandwidth calculation
-    stats->get_operator_statistics(node->id()).comm_size = size;
-    const auto tag = node->comm_tag<uint32_t>();
+    stats->get_operator_statistics(node_id).comm_size = size;
+    const auto tag = node_table.comm_tag[local_id];
 
     sim_request rcv_req;
     RecvPacketEventHandlerData* rcehd = new RecvPacketEventHandlerData;
     rcehd->wlhd = new WorkloadLayerHandlerData;
-    rcehd->wlhd->node_id = node->id();
+    rcehd->wlhd->node_id = node_id;
     rcehd->workload = this;
     rcehd->event = EventType::PacketReceived;
     sys->front_end_sim_recv(0, Sys::dummy_data, size, UINT8, src, tag, &rcv_req,
@@ -452,20 +444,107 @@ void Workload::issue_recv_comm(
                             &Sys::handleEvent, rcehd);
 }
 
-void Workload::skip_invalid(shared_ptr<Chakra::FeederV3::ETFeederNode> node) {
-    const auto node_id = node->id();
-    auto& dependancy_resolver = this->et_feeder->getDependancyResolver();
-    dependancy_resolver.finish_node(node_id);
+void Workload::skip_invalid(LocalNodeId local_id) {
+    trace_node("callback", node_table.node_id[local_id]);
+    complete_node(local_id);
+}
+
+void Workload::complete_node(LocalNodeId local_id) {
+    const auto node_id = node_table.node_id[local_id];
+    hw_resource->release(node_table.resource_class[local_id], node_id);
+    stats->record_end(node_id, Sys::boostedTick());
+    if (this->sys->track_local_mem) {
+        this->local_mem_usage_tracker->recordEnd(et_feeder->lookupNode(node_id),
+                                                 Sys::boostedTick());
+    }
+
+    finish_node(node_id);
+    if (checkpoints_enabled) {
+        finished_nodes.push_back(node_id);
+    }
+    if (sys->streaming_execution) {
+        node_table.remove(local_id);
+    }
+}
+
+const unordered_set<uint64_t>& Workload::get_dependancy_free_nodes() const {
+    if (compiled_resolver != nullptr) {
+        return compiled_resolver->get_dependancy_free_nodes();
+    }
+    return et_feeder->getDependancyResolver().get_dependancy_free_nodes();
+}
+
+const unordered_set<uint64_t>& Workload::get_ongoing_nodes() const {
+    if (compiled_resolver != nullptr) {
+        return compiled_resolver->get_ongoing_nodes();
+    }
+    return et_feeder->getDependancyResolver().get_ongoing_nodes();
+}
+
+void Workload::take_node(uint64_t node_id) {
+    if (compiled_resolver != nullptr) {
+        compiled_resolver->take_node(node_id);
+    } else {
+        et_feeder->getDependancyResolver().take_node(node_id);
+    }
+}
+
+void Workload::finish_node(uint64_t node_id) {
+    if (compiled_resolver != nullptr) {
+        compiled_resolver->finish_node(node_id);
+    } else {
+        et_feeder->getDependancyResolver().finish_node(node_id);
+    }
+}
+
+LocalNodeId Workload::add_node(uint64_t node_id) {
+    if (compiled_workload != nullptr) {
+        const CompiledNode& node =
+            compiled_workload->get_node(compiled_workload->find(node_id));
+        return node_table.add(node.record);
+    }
+    return node_table.add(et_feeder->lookupNode(node_id));
+}
+
+bool Workload::is_metadata_node(uint64_t node_id) {
+    if (compiled_workload != nullptr) {
+        const CompiledNode& node =
+            compiled_workload->get_node(compiled_workload->find(node_id));
+        return node.record.type == ChakraNodeType::METADATA_NODE;
+    }
+    return et_feeder->lookupNode(node_id)->type() ==
+           ChakraNodeType::METADATA_NODE;
+}
+
+string Workload::get_inputs_values(uint64_t node_id) {
+    if (compiled_workload != nullptr) {
+        const CompiledNode& node =
+            compiled_workload->get_node(compiled_workload->find(node_id));
+        return compiled_workload->get_string(node.inputs_values);
+    }
+    return et_feeder->lookupNode(node_id)->get_inputs_values();
+}
+
+void Workload::trace_node(const char* event, uint64_t node_id) {
     auto logger = LoggerFactory::get_logger("workload");
-    logger->debug("callback,sys->id={}, tick={}, node->id={}, "
+    if (!logger->should_log(spdlog::level::debug)) {
+        return;
+    }
+    if (compiled_workload != nullptr) {
+        const CompiledNode& node =
+            compiled_workload->get_node(compiled_workload->find(node_id));
+        logger->debug("{},sys->id={}, tick={}, node->id={}, "
+                      "node->name={}, node->type={}",
+                      event, sys->id, Sys::boostedTick(), node_id,
+                      compiled_workload->get_string(node.name),
+                      static_cast<uint64_t>(node.record.type));
+        return;
+    }
+    shared_ptr<ETFeederNode> node = et_feeder->lookupNode(node_id);
+    logger->debug("{},sys->id={}, tick={}, node->id={}, "
                   "node->name={}, node->type={}",
-                  sys->id, Sys::boostedTick(), node->id(), node->name(),
+                  event, sys->id, Sys::boostedTick(), node->id(), node->name(),
                   static_cast<uint64_t>(node->type()));
-    hw_resource->release(node);
-    stats->record_end(node, Sys::boostedTick());
-    if (this->sys->track_local_mem) {
-        this->local_mem_usage_tracker->recordEnd(node, Sys::boostedTick());
-    }
 }
 
 void Workload::call(EventType event, CallData* data) {
@@ -479,25 +558,13 @@ void Workload::call(EventType event, CallData* data) {
 
         hw_resource->tics_gpu_comms += int_data->execution_time;
         uint64_t node_id = collective_comm_node_id_map[coll_comm_id];
-        shared_ptr<Chakra::FeederV3::ETFeederNode> node =
-            et_feeder->lookupNode(node_id);
-
+        collective_comm_node_id_map.erase(coll_comm_id);
         if (sys->trace_enabled) {
-            LoggerFactory::get_logger("workload")
-                ->debug("callback,sys->id={}, tick={}, node->id={}, "
-                        "node->name={}, node->type={}",
-                        sys->id, Sys::boostedTick(), node->id(), node->name(),
-                        static_cast<uint64_t>(node->type()));
+            trace_node("callback", node_id);
         }
 
-        // if (sys->id == 0) {
-            // LoggerFactory::get_logger("workload")->info("comm finished: tick={}, node_id={}", Sys::boostedTick(), node->id());
-        // }
-
-        hw_resource->release(node);
-        stats->record_end(node, Sys::boostedTick());
-
-        // Calculate network bandwidth
+        // Calculate network bandwidth, before the statistics of the node are
+        // folded when streaming
         auto& op_stat = stats->get_operator_statistics(node_id);
         Tick execution_time = int_data->execution_time;
         if (execution_time > 0 && op_stat.comm_size.has_value()) {
@@ -505,12 +572,7 @@ void Workload::call(EventType event, CallData* data) {
                 static_cast<double>(op_stat.comm_size.value()) / execution_time;
             op_stat.network_bandwidth = bandwidth;
         }
-
-        if (this->sys->track_local_mem) {
-            this->local_mem_usage_tracker->recordEnd(node, Sys::boostedTick());
-        }
-
-        this->et_feeder->getDependancyResolver().finish_node(node_id);
+        complete_node(node_table.get_local_id(node_id));
 
         issue_dep_free_nodes();
 
@@ -524,31 +586,15 @@ void Workload::call(EventType event, CallData* data) {
             issue_dep_free_nodes();
         } else {
             WorkloadLayerHandlerData* wlhd = (WorkloadLayerHandlerData*)data;
-            shared_ptr<Chakra::FeederV3::ETFeederNode> node =
-                et_feeder->lookupNode(wlhd->node_id);
-
             if (sys->trace_enabled) {
-                LoggerFactory::get_logger("workload")
-                    ->debug("callback,sys->id={}, tick={}, node->id={}, "
-                            "node->name={}, node->type={}",
-                            sys->id, Sys::boostedTick(), node->id(),
-                            node->name(), static_cast<uint64_t>(node->type()));
+                trace_node("callback", wlhd->node_id);
             }
 
-            // if (sys->id == 0) {
-                // LoggerFactory::get_logger("workload")->info("Computation node finished at tick={}, node_id={}", Sys::boostedTick(), wlhd->node_id);
-            // }
-
-            hw_resource->release(node);
-            stats->record_end(node, Sys::boostedTick());
-
             // Calculate network bandwidth for point-to-point communications
             if (event == EventType::PacketSent ||
                 event == EventType::PacketReceived) {
                 auto& op_stat = stats->get_operator_statistics(wlhd->node_id);
-                Tick execution_time =
-                    stats->get_operator_statistics(wlhd->node_id).end_time -
-                    stats->get_operator_statistics(wlhd->node_id).start_time;
+                Tick execution_time = Sys::boostedTick() - op_stat.start_time;
                 if (execution_time > 0 && op_stat.comm_size.has_value()) {
                     double bandwidth =
                         static_cast<double>(op_stat.comm_size.value()) /
@@ -556,13 +602,7 @@ void Workload::call(EventType event, CallData* data) {
                     op_stat.network_bandwidth = bandwidth;
                 }
             }
-
-            if (this->sys->track_local_mem) {
-                this->local_mem_usage_tracker->recordEnd(node,
-                                                         Sys::boostedTick());
-            }
-
-            this->et_feeder->getDependancyResolver().finish_node(wlhd->node_id);
+            complete_node(node_table.get_local_id(wlhd->node_id));
 
             issue_dep_free_nodes();
 
@@ -570,12 +610,12 @@ void Workload::call(EventType event, CallData* data) {
         }
     }
 
-    const auto& dep_resolver = this->et_feeder->getDependancyResolver();
-    if ((dep_resolver.get_dependancy_free_nodes().empty()) &&
-        (dep_resolver.get_ongoing_nodes().empty()) &&
+    if ((get_dependancy_free_nodes().empty()) &&
+        (get_ongoing_nodes().empty()) &&
         (hw_resource->num_in_flight_cpu_ops == 0) &&
         (hw_resource->num_in_flight_gpu_comp_ops == 0) &&
         (hw_resource->num_in_flight_gpu_comm_ops == 0)) {
+        finish_tick = Sys::boostedTick();
         report();
         sys->comm_NI->sim_notify_finished();
         is_finished = true;
@@ -587,12 +627,21 @@ void Workload::fire() {
 }
 
 void Workload::report() {
-    Tick curr_tick = Sys::boostedTick();
+    Tick curr_tick = finish_tick;
     LoggerFactory::get_logger("workload")
         ->info("sys[{}] finished, {} cycles, exposed communication {} cycles.",
                sys->id, curr_tick, curr_tick - hw_resource->tics_gpu_ops);
     stats->post_processing();
     stats->report();
+    if (sys->collective_engine == CollectiveEngine::Validate &&
+        sys->validated_phases > 0) {
+        LoggerFactory::get_logger("workload")
+            ->info("sys[{}] closed-form collectives: {} phases validated, "
+                   "mean error {:.2f}%, max error {:.2f}%",
+                   sys->id, sys->validated_phases,
+                   100 * sys->validation_error_sum / sys->validated_phases,
+                   100 * sys->validation_max_error);
+    }
     if (this->sys->track_local_mem) {
         this->local_mem_usage_tracker->buildMemoryTrace();
         this->local_mem_usage_tracker->buildMemoryTimeline();
@@ -607,20 +656,158 @@ void Workload::report() {
     }
 }
 
-CommunicatorGroup* Workload::extract_comm_group(
-    std::shared_ptr<Chakra::ETFeederNode> node) {
-    std::string comm_group_name = node->pg_name<std::string>("");
-    if (comm_group_name == "") {
+void Workload::enable_checkpoints() {
+    checkpoints_enabled = true;
+}
+
+bool Workload::is_checkpointable() {
+    if (sys->streaming_execution) {
+        // restore replays the finished nodes, which streaming does not keep;
+        // Checkpoint::enable warns about it
+        return false;
+    }
+    if (is_finished) {
+        return true;
+    }
+    if (hw_resource->num_in_flight_gpu_comm_ops != 0 ||
+        !collective_comm_wrapper_map.empty()) {
+        return false;
+    }
+
+    // every running node must be a compute/replay node waiting for its
+    // completion event
+    vector<pair<Tick, PendingEvent>> pending;
+    sys->event_queue->collect(pending);
+    for (const auto& [tick, event] : pending) {
+        if (event.callable != this || event.event != EventType::General ||
+            dynamic_cast<WorkloadLayerHandlerData*>(event.data) == nullptr) {
+            return false;
+        }
+    }
+    return get_ongoing_nodes().size() == pending.size();
+}
+
+void Workload::checkpoint(CheckpointWriter& writer) {
+    if (!checkpoints_enabled) {
+        sys->sys_panic("Checkpoints have to be enabled before the simulation "
+                       "starts");
+    }
+    writer.write_u64(is_finished);
+    writer.write_u64(finish_tick);
+
+    writer.write_u64(finished_nodes.size());
+    for (auto node_id : finished_nodes) {
+        writer.write_u64(node_id);
+    }
+
+    // running nodes, by completion tick
+    vector<pair<Tick, PendingEvent>> pending;
+    sys->event_queue->collect(pending);
+    stable_sort(pending.begin(), pending.end(),
+                [](const auto& a, const auto& b) { return a.first < b.first; });
+    writer.write_u64(pending.size());
+    for (const auto& [tick, event] : pending) {
+        auto wlhd = static_cast<WorkloadLayerHandlerData*>(event.data);
+        writer.write_u64(tick);
+        writer.write_u64(wlhd->node_id);
+    }
+
+    writer.write_u64(hw_resource->num_cpu_ops);
+    writer.write_u64(hw_resource->num_gpu_ops);
+    writer.write_u64(hw_resource->num_gpu_comms);
+    writer.write_u64(hw_resource->tics_cpu_ops);
+    writer.write_u64(hw_resource->tics_gpu_ops);
+    writer.write_u64(hw_resource->tics_gpu_comms);
+
+    writer.write_u64(comm_groups.size());
+    for (const auto& comm_group : comm_groups) {
+        writer.write_i64(comm_group.first);
+        writer.write_i64(comm_group.second->num_streams);
+    }
+
+    stats->checkpoint(writer);
+}
+
+void Workload::restore(CheckpointReader& reader) {
+    if (sys->streaming_execution) {
+        sys->sys_panic("Checkpoints cannot be restored with "
+                       "streaming-execution");
+    }
+    is_finished = reader.read_u64() != 0;
+    finish_tick = reader.read_u64();
+
+    // replay the dependency resolution in completion order; parents always
+    // finish before their children
+    uint64_t finished_count = reader.read_u64();
+    finished_nodes.reserve(finished_count);
+    for (uint64_t i = 0; i < finished_count; i++) {
+        uint64_t node_id = reader.read_u64();
+        take_node(node_id);
+        if (is_metadata_node(node_id)) {
+            // communicator groups created by the metadata node
+            issue_pytorch_pg_metadata(get_inputs_values(node_id));
+        }
+        finish_node(node_id);
+        if (checkpoints_enabled) {
+            finished_nodes.push_back(node_id);
+        }
+    }
+
+    // resume running nodes; their statistics are restored below
+    Tick current_tick = Sys::boostedTick();
+    uint64_t running_count = reader.read_u64();
+    for (uint64_t i = 0; i < running_count; i++) {
+        Tick tick = reader.read_u64();
+        uint64_t node_id = reader.read_u64();
+        LocalNodeId local_id = add_node(node_id);
+        take_node(node_id);
+        hw_resource->occupy(node_table.resource_class[local_id], node_id);
+        WorkloadLayerHandlerData* wlhd = new WorkloadLayerHandlerData;
+        wlhd->node_id = node_id;
+        sys->register_event(this, EventType::General, wlhd,
+                            tick - current_tick);
+    }
+
+    hw_resource->num_cpu_ops = reader.read_u64();
+    hw_resource->num_gpu_ops = reader.read_u64();
+    hw_resource->num_gpu_comms = reader.read_u64();
+    hw_resource->tics_cpu_ops = reader.read_u64();
+    hw_resource->tics_gpu_ops = reader.read_u64();
+    hw_resource->tics_gpu_comms = reader.read_u64();
+
+    uint64_t comm_groups_count = reader.read_u64();
+    for (uint64_t i = 0; i < comm_groups_count; i++) {
+        int comm_group_id = reader.read_i64();
+        int num_streams = reader.read_i64();
+        auto it = comm_groups.find(comm_group_id);
+        if (it == comm_groups.end()) {
+            sys->sys_panic("Checkpoint refers to unknown communicator group " +
+                           to_string(comm_group_id));
+        }
+        it->second->num_streams = num_streams;
+    }
+
+    stats->restore(reader);
+
+    if (is_finished) {
+        // the rank finished before the checkpoint, report it again
+        report();
+        sys->comm_NI->sim_notify_finished();
+    }
+}
+
+CommunicatorGroup* Workload::extract_comm_group(LocalNodeId local_id) {
+    int comm_group_id = node_table.pg_id[local_id];
+    if (comm_group_id == -1) {
         // No communicator group is specified for this communication ET node.
         return nullptr;
     }
 
-    int comm_group_id = std::stoi(comm_group_name);
     if (comm_groups.find(comm_group_id) == comm_groups.end()) {
         LoggerFactory::get_logger("workload")
             ->critical(
                 "For rank {} ET node {}, communicator group {} not found",
-                sys->id, node->id(), comm_group_id);
+                sys->id, node_table.node_id[local_id], comm_group_id);
         exit(EXIT_FAILURE);
     }
     return comm_groups[comm_group_id];
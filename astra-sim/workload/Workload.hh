@@ -9,10 +9,15 @@ LICENSE file in the root directory of this source tree.
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "astra-sim/system/Callable.hh"
 #include "astra-sim/system/CommunicatorGroup.hh"
+#include "astra-sim/workload/CompiledWorkload.hh"
 #include "astra-sim/workload/HardwareResource.hh"
+#include "astra-sim/workload/NodeTable.hh"
+#include "astra-sim/workload/ReadyNodeQueue.hh"
 #include "astra-sim/workload/Statistics.hh"
 #include "astra-sim/workload/LocalMemUsageTracker.hh"
 #include "extern/graph_frontend/chakra/src/feeder_v3/et_feeder.h"
@@ -21,6 +26,8 @@ namespace AstraSim {
 
 class Sys;
 class DataSet;
+class CheckpointWriter;
+class CheckpointReader;
 
 class Workload : public Callable {
   public:
@@ -33,27 +40,33 @@ class Workload : public Callable {
     // Parse the user provided 'comm_group_filename' and extract the list of
     // communicator groups. Refer to the wiki for the format.
     void initialize_comm_groups(std::string comm_group_filename);
-    void issue_pytorch_pg_metadata(
-        std::shared_ptr<Chakra::FeederV3::ETFeederNode> node);
+    void issue_pytorch_pg_metadata(std::string pg_info);
 
     // event-based simulation
     void issue_dep_free_nodes();
-    void issue(std::shared_ptr<Chakra::FeederV3::ETFeederNode> node);
-    void issue_metadata(std::shared_ptr<Chakra::FeederV3::ETFeederNode> node);
-    void issue_replay(std::shared_ptr<Chakra::FeederV3::ETFeederNode> node);
-    void issue_remote_mem(std::shared_ptr<Chakra::FeederV3::ETFeederNode> node);
-    void issue_comp(std::shared_ptr<Chakra::FeederV3::ETFeederNode> node);
-    void issue_comm(std::shared_ptr<Chakra::FeederV3::ETFeederNode> node);
-    void issue_coll_comm(std::shared_ptr<Chakra::FeederV3::ETFeederNode> node);
-    void issue_send_comm(std::shared_ptr<Chakra::FeederV3::ETFeederNode> node);
-    void issue_recv_comm(std::shared_ptr<Chakra::FeederV3::ETFeederNode> node);
-    void skip_invalid(std::shared_ptr<Chakra::FeederV3::ETFeederNode> node);
+    void issue(LocalNodeId local_id);
+    void issue_metadata(LocalNodeId local_id);
+    void issue_replay(LocalNodeId local_id);
+    void issue_remote_mem(LocalNodeId local_id);
+    void issue_comp(LocalNodeId local_id);
+    void issue_comm(LocalNodeId local_id);
+    void issue_coll_comm(LocalNodeId local_id);
+    void issue_send_comm(LocalNodeId local_id);
+    void issue_recv_comm(LocalNodeId local_id);
+    void skip_invalid(LocalNodeId local_id);
     void call(EventType event, CallData* data);
     void fire();
 
     // stats
     void report();
 
+    // checkpointing
+    void enable_checkpoints();
+    bool is_checkpointable();
+    void checkpoint(CheckpointWriter& writer);
+    void restore(CheckpointReader& reader);
+
+    // nullptr when the ET is loaded from a compiled workload
     Chakra::ETFeeder* et_feeder;
     std::unordered_map<int, CommunicatorGroup*> comm_groups;
     HardwareResource* hw_resource;
@@ -63,13 +76,44 @@ class Workload : public Callable {
     std::unordered_map<int, uint64_t> collective_comm_node_id_map;
     std::unordered_map<int, DataSet*> collective_comm_wrapper_map;
     bool is_finished;
+    Tick finish_tick;
+    // ids of finished nodes in completion order, replayed on restore; only
+    // kept when checkpoints are saved
+    bool checkpoints_enabled;
+    std::vector<uint64_t> finished_nodes;
 
   private:
+    // ET mapped from the workload cache, used instead of the feeder
+    std::unique_ptr<CompiledWorkload> compiled_workload;
+    std::unique_ptr<CompiledDependencyResolver> compiled_resolver;
+
+    // decoded attributes of the issued nodes
+    NodeTable node_table;
+
+    // dependency-free nodes waiting for their resource
+    ReadyNodeQueue ready_nodes;
+
+    // Releases the resource of a finished node, records its end and resolves
+    // its children.
+    void complete_node(LocalNodeId local_id);
+
+    // Dependency resolution and node lookups, served by the compiled
+    // workload if there is one and by the feeder otherwise.
+    const std::unordered_set<uint64_t>& get_dependancy_free_nodes() const;
+    const std::unordered_set<uint64_t>& get_ongoing_nodes() const;
+    void take_node(uint64_t node_id);
+    void finish_node(uint64_t node_id);
+    LocalNodeId add_node(uint64_t node_id);
+    bool is_metadata_node(uint64_t node_id);
+    std::string get_inputs_values(uint64_t node_id);
+
+    // Logs a node event when tracing is enabled.
+    void trace_node(const char* event, uint64_t node_id);
+
     // From the ET node, find out the corresponding communicator group, and
     // return the pointer. If no communicator group is specified for this ET
     // node, return nullptr.
-    CommunicatorGroup* extract_comm_group(
-        std::shared_ptr<Chakra::ETFeederNode> node);
+    CommunicatorGroup* extract_comm_group(LocalNodeId local_id);
 };
 
 }  // namespace AstraSim
@@ -0,0 +1,331 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "astra-sim/workload/WorkloadLoader.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <unordered_set>
+
+#include "astra-sim/common/Logging.hh"
+#include "astra-sim/system/Sys.hh"
+
+using namespace std;
+using namespace AstraSim;
+using namespace Chakra::FeederV3;
+
+string WorkloadLoader::cache_dir;
+mutex WorkloadLoader::feeders_mutex;
+unordered_map<string, ETFeeder*> WorkloadLoader::feeders;
+unordered_map<string, CompiledWorkload*> WorkloadLoader::compiled;
+
+namespace {
+constexpr uint64_t fnv_offset_basis = 14695981039346656037ULL;
+constexpr uint64_t fnv_prime = 1099511628211ULL;
+
+double elapsed_ms(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() -
+                                           start)
+        .count();
+}
+
+// 64-bit FNV-1a over a buffer, continuing from the given hash
+uint64_t fnv1a(uint64_t hash, const char* data, size_t bytes) {
+    for (size_t i = 0; i < bytes; i++) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= fnv_prime;
+    }
+    return hash;
+}
+}  // namespace
+
+void WorkloadLoader::set_cache_dir(const string& cache_dir) {
+    WorkloadLoader::cache_dir = cache_dir;
+}
+
+string WorkloadLoader::get_filename(const string& et_prefix, int rank) {
+    return et_prefix + "." + to_string(rank) + ".et";
+}
+
+vector<uint64_t> WorkloadLoader::hash_files(const string& et_prefix,
+                                            int npus_count) {
+    auto start = chrono::steady_clock::now();
+    vector<uint64_t> hashes(npus_count);
+    int threads = parallel_for(npus_count, [&](size_t rank) {
+        uint64_t bytes;
+        hashes[rank] = get_hash(get_filename(et_prefix, rank), bytes);
+    });
+
+    unordered_set<uint64_t> unique_hashes(hashes.begin(), hashes.end());
+    LoggerFactory::get_logger("workload")
+        ->debug("hashed {} ETs ({} unique) in {:.1f} ms on {} threads",
+                npus_count, unique_hashes.size(), elapsed_ms(start), threads);
+    return hashes;
+}
+
+void WorkloadLoader::preload(const string& et_prefix,
+                             const vector<int>& ranks) {
+    if (!cache_dir.empty()) {
+        vector<string> filenames;
+        for (auto rank : ranks) {
+            string filename = get_filename(et_prefix, rank);
+            if (access(filename.c_str(), R_OK) == 0) {
+                filenames.push_back(filename);
+            }
+        }
+        vector<uint64_t> hashes, sizes;
+        compile_files(filenames, hashes, sizes);
+
+        auto start = chrono::steady_clock::now();
+        vector<CompiledWorkload*> mapped(filenames.size(), nullptr);
+        int threads = parallel_for(filenames.size(), [&](size_t i) {
+            mapped[i] = CompiledWorkload::open(
+                CompiledWorkload::get_filename(cache_dir, hashes[i]),
+                hashes[i], sizes[i]);
+        });
+
+        lock_guard<mutex> lock(feeders_mutex);
+        for (size_t i = 0; i < filenames.size(); i++) {
+            if (mapped[i] == nullptr) {
+                continue;
+            }
+            auto& workload = compiled[filenames[i]];
+            delete workload;
+            workload = mapped[i];
+        }
+        LoggerFactory::get_logger("workload")
+            ->debug("mapped {} compiled ETs in {:.1f} ms on {} threads",
+                    filenames.size(), elapsed_ms(start), threads);
+        return;
+    }
+
+    auto start = chrono::steady_clock::now();
+    vector<ETFeeder*> loaded(ranks.size(), nullptr);
+    int threads = parallel_for(ranks.size(), [&](size_t i) {
+        string filename = get_filename(et_prefix, ranks[i]);
+        if (access(filename.c_str(), R_OK) == 0) {
+            loaded[i] = new ETFeeder(filename);
+        }
+    });
+
+    lock_guard<mutex> lock(feeders_mutex);
+    for (size_t i = 0; i < ranks.size(); i++) {
+        if (loaded[i] == nullptr) {
+            continue;
+        }
+        auto& feeder = feeders[get_filename(et_prefix, ranks[i])];
+        delete feeder;
+        feeder = loaded[i];
+    }
+    LoggerFactory::get_logger("workload")
+        ->debug("parsed {} ETs in {:.1f} ms on {} threads", ranks.size(),
+                elapsed_ms(start), threads);
+}
+
+int WorkloadLoader::compile(const string& et_prefix, int npus_count) {
+    vector<string> filenames;
+    for (int rank = 0; rank < npus_count; rank++) {
+        filenames.push_back(get_filename(et_prefix, rank));
+    }
+    vector<uint64_t> hashes, sizes;
+    return compile_files(filenames, hashes, sizes);
+}
+
+int WorkloadLoader::compile_files(const vector<string>& filenames,
+                                  vector<uint64_t>& hashes,
+                                  vector<uint64_t>& sizes) {
+    if (cache_dir.empty()) {
+        LoggerFactory::get_logger("workload")
+            ->critical("no workload cache directory to compile ETs into");
+        exit(EXIT_FAILURE);
+    }
+
+    hashes.assign(filenames.size(), 0);
+    sizes.assign(filenames.size(), 0);
+    parallel_for(filenames.size(), [&](size_t i) {
+        hashes[i] = get_hash(filenames[i], sizes[i]);
+    });
+
+    auto start = chrono::steady_clock::now();
+    vector<size_t> missing;
+    unordered_set<uint64_t> seen_hashes;
+    for (size_t i = 0; i < filenames.size(); i++) {
+        if (seen_hashes.insert(hashes[i]).second &&
+            !CompiledWorkload::is_valid(
+                CompiledWorkload::get_filename(cache_dir, hashes[i]),
+                hashes[i], sizes[i])) {
+            missing.push_back(i);
+        }
+    }
+    int threads = parallel_for(missing.size(), [&](size_t i) {
+        size_t file = missing[i];
+        CompiledWorkload::compile(
+            filenames[file], hashes[file], sizes[file],
+            CompiledWorkload::get_filename(cache_dir, hashes[file]));
+    });
+    LoggerFactory::get_logger("workload")
+        ->debug("compiled {} of {} unique ETs into {} in {:.1f} ms on {} "
+                "threads",
+                missing.size(), seen_hashes.size(), cache_dir,
+                elapsed_ms(start), threads);
+    return static_cast<int>(missing.size());
+}
+
+void WorkloadLoader::check_streaming(const vector<Sys*>& systems) {
+    for (auto sys : systems) {
+        // the local memory tracker always runs on the feeder
+        if (sys->streaming_execution &&
+            (cache_dir.empty() || sys->track_local_mem)) {
+            LoggerFactory::get_logger("workload")
+                ->warn("streaming-execution keeps the whole ET graph in "
+                       "memory without workload-cache or with local memory "
+                       "tracking");
+            return;
+        }
+    }
+}
+
+ETFeeder* WorkloadLoader::take(const string& filename) {
+    lock_guard<mutex> lock(feeders_mutex);
+    auto it = feeders.find(filename);
+    if (it == feeders.end()) {
+        return nullptr;
+    }
+    ETFeeder* feeder = it->second;
+    feeders.erase(it);
+    return feeder;
+}
+
+CompiledWorkload* WorkloadLoader::take_compiled(const string& filename) {
+    {
+        lock_guard<mutex> lock(feeders_mutex);
+        auto it = compiled.find(filename);
+        if (it != compiled.end()) {
+            CompiledWorkload* workload = it->second;
+            compiled.erase(it);
+            return workload;
+        }
+    }
+    if (cache_dir.empty()) {
+        return nullptr;
+    }
+
+    uint64_t bytes;
+    uint64_t hash = get_hash(filename, bytes);
+    string cache_filename = CompiledWorkload::get_filename(cache_dir, hash);
+    CompiledWorkload* workload =
+        CompiledWorkload::open(cache_filename, hash, bytes);
+    if (workload == nullptr) {
+        CompiledWorkload::compile(filename, hash, bytes, cache_filename);
+        workload = CompiledWorkload::open(cache_filename, hash, bytes);
+    }
+    return workload;
+}
+
+uint64_t WorkloadLoader::hash_file(const string& filename, uint64_t& bytes) {
+    ifstream file(filename, ios::binary);
+    if (!file.is_open()) {
+        LoggerFactory::get_logger("workload")
+            ->critical("workload file: {} does not exist", filename);
+        exit(EXIT_FAILURE);
+    }
+
+    uint64_t hash = fnv_offset_basis;
+    bytes = 0;
+    char buffer[1 << 16];
+    while (file.read(buffer, sizeof(buffer)) || file.gcount() > 0) {
+        size_t read_bytes = static_cast<size_t>(file.gcount());
+        hash = fnv1a(hash, buffer, read_bytes);
+        bytes += read_bytes;
+    }
+    return hash;
+}
+
+uint64_t WorkloadLoader::get_hash(const string& filename, uint64_t& bytes) {
+    struct stat file_stat;
+    if (cache_dir.empty() || stat(filename.c_str(), &file_stat) != 0) {
+        return hash_file(filename, bytes);
+    }
+
+    // hash files are named after the hash of the absolute path of the ET
+    char resolved[PATH_MAX];
+    string path = realpath(filename.c_str(), resolved) != nullptr
+                      ? string(resolved)
+                      : filename;
+    char name[32];
+    snprintf(name, sizeof(name), "%016" PRIx64 ".hash",
+             fnv1a(fnv_offset_basis, path.data(), path.size()));
+    string hash_filename = cache_dir + "/" + name;
+
+    uint64_t size = static_cast<uint64_t>(file_stat.st_size);
+    int64_t mtime_sec = static_cast<int64_t>(file_stat.st_mtim.tv_sec);
+    int64_t mtime_nsec = static_cast<int64_t>(file_stat.st_mtim.tv_nsec);
+    {
+        // size, mtime seconds, mtime nanoseconds, hash, then the path
+        ifstream in(hash_filename);
+        uint64_t cached_size, cached_hash;
+        int64_t cached_sec, cached_nsec;
+        string cached_path;
+        if (in >> cached_size >> cached_sec >> cached_nsec >> hex >>
+                cached_hash >> ws &&
+            getline(in, cached_path) && cached_path == path &&
+            cached_size == size && cached_sec == mtime_sec &&
+            cached_nsec == mtime_nsec) {
+            bytes = size;
+            return cached_hash;
+        }
+    }
+
+    uint64_t hash = hash_file(filename, bytes);
+    // an ET rewritten within the same modification time tick would keep its
+    // key, so ETs modified in the last seconds are not recorded yet
+    if (bytes != size || time(nullptr) - mtime_sec < 2) {
+        return hash;
+    }
+    string tmp_filename = hash_filename + ".tmp." + to_string(getpid());
+    {
+        ofstream out(tmp_filename);
+        out << size << " " << mtime_sec << " " << mtime_nsec << " " << hex
+            << hash << "\n"
+            << path << "\n";
+    }
+    if (rename(tmp_filename.c_str(), hash_filename.c_str()) != 0) {
+        remove(tmp_filename.c_str());
+    }
+    return hash;
+}
+
+int WorkloadLoader::parallel_for(size_t count,
+                                 const function<void(size_t)>& body) {
+    size_t cores = max(1u, thread::hardware_concurrency());
+    int threads = static_cast<int>(min(cores, max<size_t>(count, 1)));
+
+    atomic<size_t> next(0);
+    auto worker = [&]() {
+        for (size_t i = next++; i < count; i = next++) {
+            body(i);
+        }
+    };
+    vector<thread> pool;
+    for (int i = 1; i < threads; i++) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& t : pool) {
+        t.join();
+    }
+    return threads;
+}
@@ -0,0 +1,100 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#ifndef __WORKLOAD_LOADER_HH__
+#define __WORKLOAD_LOADER_HH__
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "astra-sim/workload/CompiledWorkload.hh"
+#include "extern/graph_frontend/chakra/src/feeder_v3/et_feeder.h"
+
+namespace AstraSim {
+
+class Sys;
+
+// Loads the execution traces of all ranks on a thread pool before the Sys
+// objects are created, instead of one after the other in each Workload
+// constructor. Workload picks up the preloaded feeder of its file, and
+// falls back to parsing it itself if there is none.
+//
+// Byte-identical traces are still parsed once per rank, since each feeder
+// holds the dependency state of its rank. They are only deduplicated with a
+// cache directory, where they compile into one file that all their ranks map.
+//
+// With a cache directory, ETs are compiled once into CompiledWorkload files
+// keyed by their content hash, and later runs map those instead of parsing
+// the ETs. The hash of each ET is also kept in the cache directory, keyed by
+// the path, size and modification time of the ET, so unchanged ETs are not
+// read again to find their compiled workload.
+class WorkloadLoader {
+  public:
+    // Sets the directory of compiled workloads, empty to parse the ETs.
+    static void set_cache_dir(const std::string& cache_dir);
+    // Returns the name of the ET file of a rank.
+    static std::string get_filename(const std::string& et_prefix, int rank);
+
+    // Hashes the ET files of ranks [0, npus_count) in parallel. Ranks with
+    // byte-identical traces get the same hash.
+    static std::vector<uint64_t> hash_files(const std::string& et_prefix,
+                                            int npus_count);
+
+    // Parses the ET files of the given ranks in parallel. Each rank gets its
+    // own feeder, as the feeder holds the dependency state of the rank.
+    // With a cache directory, the compiled workloads of the files are
+    // mapped instead, compiling the ones missing from the cache.
+    // Unreadable files are left to the Workload constructor to report.
+    static void preload(const std::string& et_prefix,
+                        const std::vector<int>& ranks);
+
+    // Compiles the ET files of ranks [0, npus_count) that are missing from
+    // the cache directory, returning how many were compiled.
+    static int compile(const std::string& et_prefix, int npus_count);
+
+    // Warns if some of the given systems stream their workload from the ET
+    // feeder, which keeps the whole graph, so memory is not bounded.
+    static void check_streaming(const std::vector<Sys*>& systems);
+
+    // Hands over the preloaded feeder of a file, nullptr if there is none.
+    static Chakra::ETFeeder* take(const std::string& filename);
+
+    // Hands over the compiled workload of a file: the preloaded one, else
+    // the one in the cache directory, compiling it if needed. Returns
+    // nullptr without a cache directory.
+    static CompiledWorkload* take_compiled(const std::string& filename);
+
+    // 64-bit FNV-1a hash of the content of a file, also returning its size.
+    static uint64_t hash_file(const std::string& filename, uint64_t& bytes);
+
+  private:
+    // Runs body(0) ... body(count - 1) on up to one thread per core.
+    static int parallel_for(size_t count,
+                            const std::function<void(size_t)>& body);
+
+    // Returns the content hash and size of a file. With a cache directory,
+    // they are read from the hash file of the ET if its size and
+    // modification time did not change, and recorded there otherwise.
+    static uint64_t get_hash(const std::string& filename, uint64_t& bytes);
+
+    // Hashes the given files in parallel and compiles the distinct ones
+    // missing from the cache, returning how many were compiled.
+    static int compile_files(const std::vector<std::string>& filenames,
+                             std::vector<uint64_t>& hashes,
+                             std::vector<uint64_t>& sizes);
+
+    static std::string cache_dir;
+    static std::mutex feeders_mutex;
+    static std::unordered_map<std::string, Chakra::ETFeeder*> feeders;
+    static std::unordered_map<std::string, CompiledWorkload*> compiled;
+};
+
+}  // namespace AstraSim
+
+#endif /* __WORKLOAD_LOADER_HH__ */
@@ -0,0 +1,65 @@
+#!/bin/bash
+set -e
+
+## ******************************************************************************
+## This source code is licensed under the MIT license found in the
+## LICENSE file in the root directory of this source tree.
+## ******************************************************************************
+
+# Compares the per-Sys event stores selected by the "event-queue" system key:
+# the ordered map and the calendar queue. The same workload runs with both
+# stores, and the wall time and peak memory of each run are reported. The
+# simulated cycles of both runs must match.
+#
+# usage: event_queue_benchmark.sh [repetitions] (default: 5)
+# WORKLOAD and NETWORK can be overridden from the environment.
+
+# find the absolute path to this script
+SCRIPT_DIR=$(dirname "$(realpath "$0")")
+PROJECT_DIR="${SCRIPT_DIR:?}/../../../.."
+EXAMPLE_DIR="${PROJECT_DIR:?}/examples"
+
+# paths
+ASTRA_SIM="${PROJECT_DIR:?}/build/astra_analytical/build/bin/AstraSim_Analytical_Congestion_Unaware"
+WORKLOAD="${WORKLOAD:-${EXAMPLE_DIR:?}/workload/microbenchmarks/all_to_all/16npus_1MB/all_to_all}"
+NETWORK="${NETWORK:-${EXAMPLE_DIR:?}/network/analytical/Ring_16npus.yml}"
+SYSTEM="${EXAMPLE_DIR:?}/system/native_collectives/Ring_4chunks.json"
+REMOTE_MEMORY="${EXAMPLE_DIR:?}/remote_memory/analytical/no_memory_expansion.json"
+REPETITIONS="${1:-5}"
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "${WORK_DIR:?}"' EXIT
+
+echo "event_queue,repetition,wall_seconds,max_rss_kb"
+for EVENT_QUEUE in map calendar; do
+  # system configuration with the event store selected
+  python3 - "${SYSTEM:?}" "${EVENT_QUEUE}" "${WORK_DIR:?}/${EVENT_QUEUE}.json" <<'PYEOF'
+import json
+import sys
+
+with open(sys.argv[1]) as f:
+    system = json.load(f)
+system["event-queue"] = sys.argv[2]
+with open(sys.argv[3], "w") as f:
+    json.dump(system, f, indent=4)
+PYEOF
+
+  for ((i = 0; i < REPETITIONS; i++)); do
+    /usr/bin/time -f "%e %M" -o "${WORK_DIR:?}/time.txt" \
+      "${ASTRA_SIM:?}" \
+        --workload-configuration="${WORKLOAD:?}" \
+        --system-configuration="${WORK_DIR:?}/${EVENT_QUEUE}.json" \
+        --remote-memory-configuration="${REMOTE_MEMORY:?}" \
+        --network-configuration="${NETWORK:?}" \
+        > "${WORK_DIR:?}/${EVENT_QUEUE}.txt"
+    read -r WALL RSS < "${WORK_DIR:?}/time.txt"
+    echo "${EVENT_QUEUE},${i},${WALL},${RSS}"
+  done
+  grep -o "sys\[[0-9]*\] finished, [0-9]* cycles" "${WORK_DIR:?}/${EVENT_QUEUE}.txt" \
+    > "${WORK_DIR:?}/${EVENT_QUEUE}.cycles"
+done
+
+# both stores must simulate the same schedule
+if ! diff -q "${WORK_DIR:?}/map.cycles" "${WORK_DIR:?}/calendar.cycles" > /dev/null; then
+  echo "[ASTRA-sim] map and calendar event stores disagree on simulated cycles." >&2
+  exit 1
+fi
@@ -0,0 +1,53 @@
+#!/bin/bash
+set -e
+
+## ******************************************************************************
+## This source code is licensed under the MIT license found in the
+## LICENSE file in the root directory of this source tree.
+## ******************************************************************************
+
+# Records the network trace of a congestion_unaware run, then replays it with
+# the network trace replay backend. Compute-side parameters of the system
+# configuration can be changed between the two runs.
+
+# find the absolute path to this script
+SCRIPT_DIR=$(dirname "$(realpath "$0")")
+PROJECT_DIR="${SCRIPT_DIR:?}/../../../.."
+EXAMPLE_DIR="${PROJECT_DIR:?}/examples"
+
+# paths
+BIN_DIR="${PROJECT_DIR:?}/build/astra_analytical/build/bin"
+WORKLOAD="${EXAMPLE_DIR:?}/workload/microbenchmarks/reduce_scatter/4npus_1MB/reduce_scatter"
+SYSTEM="${EXAMPLE_DIR:?}/system/native_collectives/Ring_4chunks.json"
+NETWORK="${EXAMPLE_DIR:?}/network/analytical/Ring_4npus.yml"
+REMOTE_MEMORY="${EXAMPLE_DIR:?}/remote_memory/analytical/no_memory_expansion.json"
+RUN_DIR="${SCRIPT_DIR:?}/run"
+TRACE="${RUN_DIR:?}/network_trace.bin"
+
+# system configuration that records every message
+mkdir -p "${RUN_DIR:?}"
+RECORD_SYSTEM="${RUN_DIR:?}/system_record.json"
+python3 - "${SYSTEM:?}" "${RECORD_SYSTEM:?}" "${TRACE:?}" <<'PY'
+import json, sys
+config = json.load(open(sys.argv[1]))
+config["network-trace-record"] = sys.argv[3]
+json.dump(config, open(sys.argv[2], "w"), indent=4)
+PY
+
+# Compile
+"${PROJECT_DIR:?}"/build/astra_analytical/build.sh -t congestion_unaware
+
+echo "[ASTRA-sim] Recording the network trace..."
+"${BIN_DIR:?}"/AstraSim_Analytical_Congestion_Unaware \
+    --workload-configuration="${WORKLOAD}" \
+    --system-configuration="${RECORD_SYSTEM:?}" \
+    --remote-memory-configuration="${REMOTE_MEMORY:?}" \
+    --network-configuration="${NETWORK:?}"
+
+echo "[ASTRA-sim] Replaying the network trace..."
+"${BIN_DIR:?}"/AstraSim_Analytical_Replay \
+    --workload-configuration="${WORKLOAD}" \
+    --system-configuration="${SYSTEM:?}" \
+    --remote-memory-configuration="${REMOTE_MEMORY:?}" \
+    --network-configuration="${NETWORK:?}" \
+    --network-trace="${TRACE:?}"
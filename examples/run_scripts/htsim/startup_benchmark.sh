@@ -0,0 +1,83 @@
+#!/bin/bash
+set -e
+
+## ******************************************************************************
+## This source code is licensed under the MIT license found in the
+## LICENSE file in the root directory of this source tree.
+## ******************************************************************************
+
+# Measures the wall time and peak memory of ASTRA-sim + HTSim on fat-trees of
+# 1K, 4K and 8K hosts, running a single small All-Reduce so that the run is
+# dominated by startup (topology construction, path setup, trace loading).
+#
+# usage: startup_benchmark.sh [hosts...] (default: 1024 4096 8192)
+
+# find the absolute path to this script
+SCRIPT_DIR=$(dirname "$(realpath "$0")")
+PROJECT_DIR="${SCRIPT_DIR:?}/../../.."
+EXAMPLE_DIR="${PROJECT_DIR:?}/examples"
+
+# paths
+ASTRA_SIM="${PROJECT_DIR:?}/build/astra_htsim/build/bin/AstraSim_HTSim"
+SYSTEM="${EXAMPLE_DIR:?}/system/native_collectives/Ring_4chunks.json"
+REMOTE_MEMORY="${EXAMPLE_DIR:?}/remote_memory/analytical/no_memory_expansion.json"
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "${WORK_DIR:?}"' EXIT
+
+HOSTS=("$@")
+if [ ${#HOSTS[@]} -eq 0 ]; then
+  HOSTS=(1024 4096 8192)
+fi
+
+echo "hosts,wall_seconds,max_rss_kb"
+for NPUS in "${HOSTS[@]}"; do
+  CASE_DIR="${WORK_DIR:?}/${NPUS}"
+  mkdir -p "${CASE_DIR:?}"
+
+  # one 64KB All-Reduce per host
+  python3 - "${NPUS}" "${CASE_DIR:?}/all_reduce" <<'PYEOF'
+import sys
+
+from chakra.src.third_party.utils.protolib import encodeMessage as encode_message
+from chakra.schema.protobuf.et_def_pb2 import (
+    Node as ChakraNode,
+    GlobalMetadata,
+    AttributeProto as ChakraAttr,
+    COMM_COLL_NODE,
+    ALL_REDUCE,
+)
+
+npus_count = int(sys.argv[1])
+prefix = sys.argv[2]
+for npu_id in range(npus_count):
+    with open(f"{prefix}.{npu_id}.et", "wb") as et:
+        encode_message(et, GlobalMetadata(version="0.0.4"))
+        node = ChakraNode()
+        node.id = 1
+        node.name = "All-Reduce"
+        node.type = COMM_COLL_NODE
+        node.attr.append(ChakraAttr(name="is_cpu_op", bool_val=False))
+        node.attr.append(ChakraAttr(name="comm_type", int64_val=ALL_REDUCE))
+        node.attr.append(ChakraAttr(name="comm_size", int64_val=65536))
+        encode_message(et, node)
+PYEOF
+
+  cat > "${CASE_DIR:?}/network.yml" <<YMLEOF
+topology: [ Switch ]
+npus_count: [ ${NPUS} ]
+bandwidth: [ 50.0 ]  # GB/s
+latency: [ 500.0 ]  # ns
+YMLEOF
+
+  # run ASTRA-sim on an HTSim fat-tree with as many hosts
+  (cd "${CASE_DIR:?}" && /usr/bin/time -f "%e %M" -o "${CASE_DIR:?}/time.txt" \
+    "${ASTRA_SIM:?}" \
+      --workload-configuration="${CASE_DIR:?}/all_reduce" \
+      --system-configuration="${SYSTEM:?}" \
+      --remote-memory-configuration="${REMOTE_MEMORY:?}" \
+      --network-configuration="${CASE_DIR:?}/network.yml" \
+      --htsim_opts -nodes "${NPUS}" > "${CASE_DIR:?}/stdout.txt")
+
+  read -r WALL RSS < "${CASE_DIR:?}/time.txt"
+  echo "${NPUS},${WALL},${RSS}"
+done
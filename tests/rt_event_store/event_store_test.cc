@@ -0,0 +1,179 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+// Randomized event order test of CalendarEventStore against MapEventStore.
+//
+// Both stores are driven the way Sys drives them: a backend event is
+// scheduled whenever insert() reports a new tick, ticks are drained in
+// order, and the events of a drained tick register more events, at the same
+// tick, at nearby ticks, at ticks a whole number of rings away (which spill
+// into the overflow table of a small calendar ring) and at far-future ticks.
+// Both stores must report the same new ticks, fire the same events in the
+// same order, and hold the same pending events whenever they are collected.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "astra-sim/system/EventStore.hh"
+
+using namespace std;
+using namespace AstraSim;
+
+namespace {
+
+// ring size of the calendar store, small so that ticks collide
+constexpr uint64_t buckets = 8;
+
+// what happened while driving a store
+struct Trace {
+    // (tick, event id) in firing order
+    vector<pair<Tick, uint64_t>> fired;
+    // return value of every insert()
+    vector<bool> new_ticks;
+    // sorted pending (tick, event id) at every collect()
+    vector<vector<pair<Tick, uint64_t>>> collected;
+};
+
+uint64_t event_id(const PendingEvent& event) {
+    return reinterpret_cast<uintptr_t>(event.data);
+}
+
+CallData* event_data(const uint64_t id) {
+    return reinterpret_cast<CallData*>(static_cast<uintptr_t>(id));
+}
+
+// Returns the delay of an event registered by another one.
+Tick next_delay(mt19937_64& rng) {
+    const auto choice = uniform_int_distribution<int>(0, 9)(rng);
+    if (choice < 3) {
+        // same tick, appended to the bucket being drained
+        return 0;
+    } else if (choice < 6) {
+        return uniform_int_distribution<Tick>(1, 2 * buckets)(rng);
+    } else if (choice < 9) {
+        // lands on the slot of a pending tick
+        return buckets * uniform_int_distribution<Tick>(1, 4)(rng);
+    }
+    // far-future tick
+    return 1000000000000ULL + uniform_int_distribution<Tick>(0, 3)(rng);
+}
+
+Trace drive(EventStore& store, const uint32_t seed, const int events_count) {
+    mt19937_64 rng(seed);
+    Trace trace;
+    uint64_t next_id = 1;
+    int registered = 0;
+    priority_queue<Tick, vector<Tick>, greater<Tick>> scheduled;
+
+    auto insert = [&](const Tick tick) {
+        const auto new_tick =
+            store.insert(tick, nullptr, EventType::General,
+                         event_data(next_id++));
+        trace.new_ticks.push_back(new_tick);
+        if (new_tick) {
+            scheduled.push(tick);
+        }
+        registered++;
+    };
+
+    // initial events
+    for (int i = 0; i < 16; i++) {
+        insert(uniform_int_distribution<Tick>(0, 4 * buckets)(rng));
+    }
+
+    while (!scheduled.empty()) {
+        const auto tick = scheduled.top();
+        scheduled.pop();
+
+        auto events = store.find(tick);
+        if (events == nullptr) {
+            cerr << "[Error] (tests/rt_event_store) seed " << seed
+                 << ": scheduled tick " << tick << " has no events" << endl;
+            exit(1);
+        }
+        // walked by index, as events of this tick may be appended
+        for (size_t i = 0; i < events->size(); i++) {
+            trace.fired.emplace_back(tick, event_id((*events)[i]));
+            const auto children =
+                registered < events_count
+                    ? uniform_int_distribution<int>(0, 2)(rng)
+                    : 0;
+            for (int child = 0; child < children; child++) {
+                insert(tick + next_delay(rng));
+            }
+        }
+        store.release(tick);
+
+        if (uniform_int_distribution<int>(0, 15)(rng) == 0) {
+            vector<pair<Tick, PendingEvent>> pending;
+            store.collect(pending);
+            vector<pair<Tick, uint64_t>> sorted;
+            for (const auto& [pending_tick, event] : pending) {
+                sorted.emplace_back(pending_tick, event_id(event));
+            }
+            sort(sorted.begin(), sorted.end());
+            trace.collected.push_back(sorted);
+        }
+    }
+    return trace;
+}
+
+bool fail(const uint32_t seed, const string& message) {
+    cerr << "[Error] (tests/rt_event_store) seed " << seed << ": " << message
+         << endl;
+    return false;
+}
+
+bool run_trial(const uint32_t seed, const int events_count) {
+    MapEventStore map_store;
+    CalendarEventStore calendar_store(buckets);
+    const auto expected = drive(map_store, seed, events_count);
+    const auto actual = drive(calendar_store, seed, events_count);
+
+    // the reference fires ticks in order, each in registration order
+    for (size_t i = 1; i < expected.fired.size(); i++) {
+        const auto& previous = expected.fired[i - 1];
+        const auto& current = expected.fired[i];
+        if (current.first < previous.first ||
+            (current.first == previous.first &&
+             current.second < previous.second)) {
+            return fail(seed, "map store fired events out of order");
+        }
+    }
+    if (actual.new_ticks != expected.new_ticks) {
+        return fail(seed, "stores disagree on which inserts are new ticks");
+    }
+    if (actual.fired != expected.fired) {
+        return fail(seed, "stores fired events in a different order");
+    }
+    if (actual.collected != expected.collected) {
+        return fail(seed, "stores collected different pending events");
+    }
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const auto trials = argc > 1 ? atoi(argv[1]) : 2000;
+
+    for (int trial = 0; trial < trials; trial++) {
+        if (!run_trial(static_cast<uint32_t>(trial), 2000)) {
+            return 1;
+        }
+    }
+
+    cout << "event store: " << trials << " randomized schedules passed"
+         << endl;
+    return 0;
+}
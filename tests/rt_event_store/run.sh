@@ -0,0 +1,14 @@
+#!/bin/bash
+set -e
+
+# Path
+SCRIPT_DIR=$(dirname "$(realpath $0)")
+BIN_DIR=${SCRIPT_DIR}/../../build/astra_analytical/build/bin
+
+# Run randomized schedules
+(
+echo "[$0] Running randomized event schedules..."
+${BIN_DIR}/AstraSim_EventStore_Test
+)
+
+echo "[$0] Ok."
@@ -0,0 +1,88 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#ifndef __LEGACY_MATCHER_HH__
+#define __LEGACY_MATCHER_HH__
+
+#include <cstdint>
+#include <map>
+#include <tuple>
+
+// Receive-side rendezvous of the htsim and ns-3 frontends before
+// MessageMatcher, kept as the baseline of the ordering test and the
+// benchmark. At most one receive waits per key: a second sim_recv on a key
+// is merged into the first, so only its handler is ever called.
+class LegacyMatcher {
+  public:
+    using Handler = void (*)(void*);
+    using Key = std::tuple<int, int, int>;
+
+    void post_recv(const Key& key,
+                   const uint64_t bytes,
+                   const Handler handler,
+                   void* const arg) {
+        auto standby = msg_standby.find(key);
+        if (standby != msg_standby.end()) {
+            // bytes arrived before sim_recv was called
+            const auto received_bytes = standby->second;
+            if (received_bytes == bytes) {
+                msg_standby.erase(standby);
+                handler(arg);
+            } else if (received_bytes > bytes) {
+                standby->second -= bytes;
+                handler(arg);
+            } else {
+                msg_standby.erase(standby);
+                recv_waiting[key] = {bytes - received_bytes, handler, arg};
+            }
+            return;
+        }
+
+        auto waiting = recv_waiting.find(key);
+        if (waiting == recv_waiting.end()) {
+            recv_waiting[key] = {bytes, handler, arg};
+        } else {
+            // the second receive replaces the handler of the first
+            waiting->second = {waiting->second.remaining_bytes + bytes,
+                               handler, arg};
+        }
+    }
+
+    void deliver(const Key& key, const uint64_t bytes) {
+        auto waiting = recv_waiting.find(key);
+        if (waiting == recv_waiting.end()) {
+            msg_standby[key] += bytes;
+            return;
+        }
+
+        auto recv = waiting->second;
+        if (bytes == recv.remaining_bytes) {
+            recv_waiting.erase(waiting);
+            recv.handler(recv.arg);
+        } else if (bytes > recv.remaining_bytes) {
+            msg_standby[key] = bytes - recv.remaining_bytes;
+            recv_waiting.erase(waiting);
+            recv.handler(recv.arg);
+        } else {
+            waiting->second.remaining_bytes -= bytes;
+        }
+    }
+
+    bool empty() const {
+        return recv_waiting.empty() && msg_standby.empty();
+    }
+
+  private:
+    struct WaitingRecv {
+        uint64_t remaining_bytes;
+        Handler handler;
+        void* arg;
+    };
+
+    std::map<Key, WaitingRecv> recv_waiting;
+    std::map<Key, uint64_t> msg_standby;
+};
+
+#endif /* __LEGACY_MATCHER_HH__ */
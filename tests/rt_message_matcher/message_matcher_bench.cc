@@ -0,0 +1,119 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+// Microbenchmark of MessageMatcher against LegacyMatcher, the std::map based
+// matching the htsim and ns-3 frontends used before.
+//
+// rendezvous: one key at a time; each message is split into two arrivals and
+//     the receive is posted before, between or after them.
+// fan_in: receives of many distinct keys are posted, then all of their bytes
+//     arrive, as in the receive side of an all-to-all.
+//
+// usage: AstraSim_MessageMatcher_Bench [messages] (default: 4000000)
+// Prints one CSV line per matcher and pattern.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+
+#include "LegacyMatcher.hh"
+#include "astra-sim/common/MessageMatcher.hh"
+
+using namespace std;
+using namespace AstraSim;
+
+namespace {
+
+uint64_t completed = 0;
+
+void on_recv(void* const) {
+    completed++;
+}
+
+// keys live at once in the fan_in pattern
+constexpr int fan_in_keys = 4096;
+
+MessageKey make_key(const MessageMatcher&, const int i) {
+    return MessageKey(i % 64, i % 1024, (i / 1024) % 4);
+}
+
+LegacyMatcher::Key make_key(const LegacyMatcher&, const int i) {
+    return LegacyMatcher::Key(i % 64, i % 1024, (i / 1024) % 4);
+}
+
+template <typename Matcher>
+void rendezvous(Matcher& matcher, const int messages) {
+    for (int i = 0; i < messages; i++) {
+        const auto key = make_key(matcher, i);
+        const uint64_t bytes = 64 + (i % 7) * 512;
+        if (i % 3 == 0) {
+            matcher.post_recv(key, bytes, on_recv, nullptr);
+            matcher.deliver(key, bytes / 2);
+            matcher.deliver(key, bytes - bytes / 2);
+        } else if (i % 3 == 1) {
+            matcher.deliver(key, bytes / 2);
+            matcher.post_recv(key, bytes, on_recv, nullptr);
+            matcher.deliver(key, bytes - bytes / 2);
+        } else {
+            matcher.deliver(key, bytes / 2);
+            matcher.deliver(key, bytes - bytes / 2);
+            matcher.post_recv(key, bytes, on_recv, nullptr);
+        }
+    }
+}
+
+template <typename Matcher>
+void fan_in(Matcher& matcher, const int messages) {
+    for (int base = 0; base < messages; base += fan_in_keys) {
+        const auto end = min(messages, base + fan_in_keys);
+        for (int i = base; i < end; i++) {
+            matcher.post_recv(make_key(matcher, i - base), 1024, on_recv,
+                              nullptr);
+        }
+        for (int i = base; i < end; i++) {
+            matcher.deliver(make_key(matcher, i - base), 1024);
+        }
+    }
+}
+
+template <typename Matcher, typename Pattern>
+void run(const char* const matcher_name,
+         const char* const pattern_name,
+         const Pattern pattern,
+         const int messages) {
+    Matcher matcher;
+    completed = 0;
+    const auto start = chrono::steady_clock::now();
+    pattern(matcher, messages);
+    const auto end = chrono::steady_clock::now();
+
+    if (completed != static_cast<uint64_t>(messages) || !matcher.empty()) {
+        cerr << "[Error] (tests/rt_message_matcher) " << matcher_name
+             << " left receives unmatched in " << pattern_name << endl;
+        exit(1);
+    }
+
+    const auto seconds = chrono::duration<double>(end - start).count();
+    cout << matcher_name << "," << pattern_name << "," << messages << ","
+         << seconds << "," << seconds * 1e9 / messages << endl;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const auto messages = argc > 1 ? atoi(argv[1]) : 4000000;
+
+    cout << "matcher,pattern,messages,seconds,ns_per_message" << endl;
+    run<LegacyMatcher>("legacy", "rendezvous", rendezvous<LegacyMatcher>,
+                       messages);
+    run<MessageMatcher>("message_matcher", "rendezvous",
+                        rendezvous<MessageMatcher>, messages);
+    run<LegacyMatcher>("legacy", "fan_in", fan_in<LegacyMatcher>, messages);
+    run<MessageMatcher>("message_matcher", "fan_in", fan_in<MessageMatcher>,
+                        messages);
+    return 0;
+}
@@ -0,0 +1,227 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+// Randomized send/recv ordering test of MessageMatcher.
+//
+// Each trial generates a few keys, each with a list of receive sizes and a
+// random split of the same total into arrivals, and interleaves post_recv()
+// and deliver() calls at random. After every call, the receives completed so
+// far must be exactly those the byte-count model predicts: the n-th receive
+// of a key completes once it is posted and the arrived bytes of the key cover
+// the first n receive sizes. Handlers of a key must run in posting order, and
+// nothing may be left in the matcher at the end.
+//
+// Trials that post at most one receive per key at a time are also replayed
+// through LegacyMatcher, the matching the htsim and ns-3 frontends used
+// before, and must call the same handlers in the same order.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "LegacyMatcher.hh"
+#include "astra-sim/common/MessageMatcher.hh"
+
+using namespace std;
+using namespace AstraSim;
+
+namespace {
+
+struct Completion {
+    vector<int> log;
+};
+
+struct Recv {
+    int id;
+    uint64_t bytes;
+    bool posted = false;
+    bool done = false;
+    // which implementation completed this receive
+    Completion* completion;
+};
+
+struct Key {
+    int tag, src, dst;
+    vector<Recv> matcher_recvs;
+    vector<Recv> legacy_recvs;
+    vector<uint64_t> arrivals;
+    size_t next_recv = 0;
+    size_t next_arrival = 0;
+    uint64_t arrived_bytes = 0;
+};
+
+void on_recv(void* const arg) {
+    auto recv = static_cast<Recv*>(arg);
+    if (recv->done) {
+        cerr << "[Error] (tests/rt_message_matcher) receive " << recv->id
+             << " completed twice" << endl;
+        exit(1);
+    }
+    recv->done = true;
+    recv->completion->log.push_back(recv->id);
+}
+
+bool fail(const uint32_t seed, const string& message) {
+    cerr << "[Error] (tests/rt_message_matcher) seed " << seed << ": "
+         << message << endl;
+    return false;
+}
+
+// The receives completed so far must match the byte-count model.
+bool check_model(const uint32_t seed, const Key& key) {
+    uint64_t required_bytes = 0;
+    for (const auto& recv : key.matcher_recvs) {
+        required_bytes += recv.bytes;
+        const auto expected =
+            recv.posted && key.arrived_bytes >= required_bytes;
+        if (recv.done != expected) {
+            return fail(seed, "receive " + to_string(recv.id) +
+                                  (expected ? " did not complete"
+                                            : " completed early"));
+        }
+    }
+    return true;
+}
+
+bool run_trial(const uint32_t seed, const bool single_outstanding) {
+    mt19937 rng(seed);
+    auto uniform = [&rng](const int low, const int high) {
+        return uniform_int_distribution<int>(low, high)(rng);
+    };
+
+    Completion matcher_completion, legacy_completion;
+    vector<Key> keys(uniform(1, 6));
+    int next_id = 0;
+    for (size_t i = 0; i < keys.size(); i++) {
+        auto& key = keys[i];
+        // distinct keys that share some of (tag, src, dst)
+        key.tag = static_cast<int>(i / 2);
+        key.src = static_cast<int>(i % 2);
+        key.dst = uniform(0, 1) == 0 ? 7 : -7 - static_cast<int>(i);
+
+        uint64_t total_bytes = 0;
+        const auto recvs_count = uniform(1, 8);
+        for (int r = 0; r < recvs_count; r++) {
+            Recv recv;
+            recv.id = next_id++;
+            recv.bytes = static_cast<uint64_t>(uniform(1, 64));
+            total_bytes += recv.bytes;
+            recv.completion = &matcher_completion;
+            key.matcher_recvs.push_back(recv);
+            recv.completion = &legacy_completion;
+            key.legacy_recvs.push_back(recv);
+        }
+        while (total_bytes > 0) {
+            const auto arrival =
+                min(total_bytes, static_cast<uint64_t>(uniform(1, 96)));
+            key.arrivals.push_back(arrival);
+            total_bytes -= arrival;
+        }
+    }
+
+    MessageMatcher matcher;
+    LegacyMatcher legacy;
+    while (true) {
+        // a key with an action left, and whether to post or deliver
+        vector<pair<size_t, bool>> actions;
+        for (size_t i = 0; i < keys.size(); i++) {
+            const auto& key = keys[i];
+            if (key.next_recv < key.matcher_recvs.size()) {
+                const auto outstanding =
+                    key.next_recv > 0 &&
+                    !key.matcher_recvs[key.next_recv - 1].done;
+                if (!single_outstanding || !outstanding) {
+                    actions.emplace_back(i, true);
+                }
+            }
+            if (key.next_arrival < key.arrivals.size()) {
+                actions.emplace_back(i, false);
+            }
+        }
+        if (actions.empty()) {
+            break;
+        }
+
+        const auto action = actions[uniform(0, actions.size() - 1)];
+        auto& key = keys[action.first];
+        const auto message_key = MessageKey(key.tag, key.src, key.dst);
+        const auto legacy_key = LegacyMatcher::Key(key.tag, key.src, key.dst);
+        if (action.second) {
+            auto& recv = key.matcher_recvs[key.next_recv];
+            auto& legacy_recv = key.legacy_recvs[key.next_recv];
+            recv.posted = true;
+            legacy_recv.posted = true;
+            matcher.post_recv(message_key, recv.bytes, on_recv, &recv);
+            if (single_outstanding) {
+                legacy.post_recv(legacy_key, legacy_recv.bytes, on_recv,
+                                 &legacy_recv);
+            }
+            key.next_recv++;
+        } else {
+            const auto bytes = key.arrivals[key.next_arrival];
+            key.arrived_bytes += bytes;
+            matcher.deliver(message_key, bytes);
+            if (single_outstanding) {
+                legacy.deliver(legacy_key, bytes);
+            }
+            key.next_arrival++;
+        }
+
+        if (!check_model(seed, key)) {
+            return false;
+        }
+        if (single_outstanding &&
+            matcher_completion.log != legacy_completion.log) {
+            return fail(seed, "handler order differs from LegacyMatcher");
+        }
+    }
+
+    // handlers of each key ran in posting order
+    vector<int> last_id(keys.size(), -1);
+    for (const auto id : matcher_completion.log) {
+        for (size_t i = 0; i < keys.size(); i++) {
+            const auto& recvs = keys[i].matcher_recvs;
+            if (id < recvs.front().id || id > recvs.back().id) {
+                continue;
+            }
+            if (id <= last_id[i]) {
+                return fail(seed, "receives of a key completed out of order");
+            }
+            last_id[i] = id;
+        }
+    }
+
+    if (matcher_completion.log.size() != static_cast<size_t>(next_id)) {
+        return fail(seed, "not every receive completed");
+    }
+    if (!matcher.empty()) {
+        return fail(seed, "matcher is not empty at the end");
+    }
+    if (single_outstanding && !legacy.empty()) {
+        return fail(seed, "LegacyMatcher is not empty at the end");
+    }
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const auto trials = argc > 1 ? atoi(argv[1]) : 20000;
+
+    for (int trial = 0; trial < trials; trial++) {
+        const auto seed = static_cast<uint32_t>(trial);
+        if (!run_trial(seed, false) || !run_trial(seed, true)) {
+            return 1;
+        }
+    }
+
+    cout << "message matcher: " << trials
+         << " randomized orderings passed" << endl;
+    return 0;
+}
@@ -0,0 +1,20 @@
+#!/bin/bash
+set -e
+
+# Path
+SCRIPT_DIR=$(dirname "$(realpath $0)")
+BIN_DIR=${SCRIPT_DIR}/../../build/astra_analytical/build/bin
+
+# Run randomized orderings
+(
+echo "[$0] Running randomized send/recv orderings..."
+${BIN_DIR}/AstraSim_MessageMatcher_Test
+)
+
+# Run microbenchmark (reported, not compared)
+(
+echo "[$0] Running microbenchmark..."
+${BIN_DIR}/AstraSim_MessageMatcher_Bench 1000000
+)
+
+echo "[$0] Ok."
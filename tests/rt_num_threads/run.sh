@@ -0,0 +1,56 @@
+#!/bin/bash
+set -e
+
+# Path
+SCRIPT_DIR=$(dirname "$(realpath $0)")
+ASTRA_SIM_BIN=${SCRIPT_DIR}/../../build/astra_analytical/build/bin/AstraSim_Analytical_Congestion_Unaware
+
+# Clear outputs
+(
+rm -rf ${SCRIPT_DIR}/outputs/*
+)
+
+# Generate inputs
+(
+echo "[$0] Generating inputs..."
+${SCRIPT_DIR}/inputs/workload/gen.sh
+)
+
+# run_astra_sim <threads count>
+run_astra_sim() {
+    ${ASTRA_SIM_BIN} \
+        --workload-configuration=${SCRIPT_DIR}/inputs/workload/chakra_trace \
+        --system-configuration=${SCRIPT_DIR}/inputs/system_cfg.json \
+        --network-configuration=${SCRIPT_DIR}/inputs/network_cfg.yml \
+        --remote-memory-configuration=${SCRIPT_DIR}/inputs/remote_memory_cfg.json \
+        --num-threads=$1 \
+        > ${SCRIPT_DIR}/outputs/stdout_$1_threads.txt
+}
+
+# Run ASTRA-sim on one and on four threads
+(
+echo "[$0] Running ASTRA-sim..."
+run_astra_sim 1
+run_astra_sim 4
+)
+
+# keeps the finish tick of each sys; ranks on different threads log in any
+# order, so the lines are sorted
+finish_ticks() {
+    sed -E 's/\[[^]]+\] //; s/\[[^]]+\] //; s/\[[^]]+\] //' \
+        | grep -E "finished, " | sort
+}
+
+# Compare outputs
+(
+echo "[$0] Comparing outputs..."
+for THREADS in 1 4; do
+    finish_ticks < ${SCRIPT_DIR}/outputs/stdout_${THREADS}_threads.txt > ${SCRIPT_DIR}/outputs/finish_ticks_${THREADS}_threads.txt
+done
+if [ $(wc -l < ${SCRIPT_DIR}/outputs/finish_ticks_1_threads.txt) -ne 8 ]; then
+    echo "Failed: not every sys finished." ; exit 1
+fi
+diff ${SCRIPT_DIR}/outputs/finish_ticks_1_threads.txt ${SCRIPT_DIR}/outputs/finish_ticks_4_threads.txt || (echo "Failed." ; exit 1)
+)
+
+echo "[$0] Ok."
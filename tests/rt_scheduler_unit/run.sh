@@ -0,0 +1,22 @@
+#!/bin/bash
+set -e
+
+# Path
+SCRIPT_DIR=$(dirname "$(realpath $0)")
+BIN_DIR=${SCRIPT_DIR}/../../build/astra_analytical/build/bin
+
+# Generate inputs
+(
+echo "[$0] Generating inputs..."
+${SCRIPT_DIR}/inputs/workload/gen.sh
+)
+
+# Run randomized schedules
+(
+echo "[$0] Running randomized stream schedules..."
+${BIN_DIR}/AstraSim_SchedulerUnit_Test \
+    ${SCRIPT_DIR}/inputs/workload/chakra_trace \
+    ${SCRIPT_DIR}/inputs/system_cfg.json
+)
+
+echo "[$0] Ok."
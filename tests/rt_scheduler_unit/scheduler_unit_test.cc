@@ -0,0 +1,227 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+// Randomized insert/advance/remove test of Sys::SchedulerUnit.
+//
+// A Sys is built from the given workload and system configurations with stub
+// network and memory APIs. Stub streams are then pushed through its first
+// active queue the way Sys does it: they are inserted with insert_stream()
+// and announced with notify_stream_added(), and running streams finish in any
+// order, are erased and announced with notify_stream_removed(). After every
+// call, exactly the first queue_threshold streams of the queue must be
+// initialized, the ones that were not before must have been initialized in
+// queue order, and the running count must match.
+//
+// usage: AstraSim_SchedulerUnit_Test <workload> <system configuration>
+//            [trials] (default: 2000)
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "astra-sim/common/AstraNetworkAPI.hh"
+#include "astra-sim/common/AstraRemoteMemoryAPI.hh"
+#include "astra-sim/system/BaseStream.hh"
+#include "astra-sim/system/Sys.hh"
+
+using namespace std;
+using namespace AstraSim;
+
+namespace {
+
+// the collectives are never run, so nothing is ever sent or scheduled
+class StubNetworkApi : public AstraNetworkAPI {
+  public:
+    StubNetworkApi() : AstraNetworkAPI(0) {}
+
+    int sim_send(void*,
+                 uint64_t,
+                 int,
+                 int,
+                 int,
+                 sim_request*,
+                 void (*)(void*),
+                 void*) override {
+        return 0;
+    }
+
+    int sim_recv(void*,
+                 uint64_t,
+                 int,
+                 int,
+                 int,
+                 sim_request*,
+                 void (*)(void*),
+                 void*) override {
+        return 0;
+    }
+
+    void sim_schedule(timespec_t, void (*)(void*), void*) override {}
+
+    timespec_t sim_get_time() override {
+        timespec_t time;
+        time.time_res = NS;
+        time.time_val = 0;
+        return time;
+    }
+};
+
+class StubRemoteMemory : public AstraRemoteMemoryAPI {
+  public:
+    void set_sys(int, Sys*) override {}
+    void issue(uint64_t, WorkloadLayerHandlerData*) override {}
+};
+
+// Records the order in which streams are initialized.
+class TestStream : public BaseStream {
+  public:
+    TestStream(const int stream_id, Sys* const owner, vector<int>& inits)
+        : BaseStream(stream_id, owner, {}), inits(inits) {}
+
+    void init() override {
+        inits.push_back(stream_id);
+    }
+    void consume(RecvPacketEventHandlerData*) override {}
+    void call(EventType, CallData*) override {}
+
+  private:
+    vector<int>& inits;
+};
+
+constexpr int vnet = 0;
+
+bool fail(const uint32_t seed, const string& message) {
+    cerr << "[Error] (tests/rt_scheduler_unit) seed " << seed << ": "
+         << message << endl;
+    return false;
+}
+
+// Checks the queue after a notification. initialized_before holds the ids
+// of the streams that were initialized before it, and inits_before the
+// length of the init log.
+bool check_queue(const uint32_t seed,
+                 Sys* const sys,
+                 const set<int>& initialized_before,
+                 const vector<int>& inits,
+                 const size_t inits_before) {
+    auto& queue = sys->active_Streams[vnet];
+    const auto threshold =
+        static_cast<size_t>(sys->scheduler_unit->queue_threshold);
+    const auto running = min(queue.size(), threshold);
+
+    vector<int> expected_inits;
+    size_t index = 0;
+    for (auto it = queue.begin(); it != queue.end(); ++it, index++) {
+        if ((*it)->initialized != (index < running)) {
+            return fail(seed, "stream at index " + to_string(index) +
+                                  ((*it)->initialized ? " is initialized"
+                                                      : " is not initialized"));
+        }
+        if ((*it)->initialized &&
+            initialized_before.count((*it)->stream_id) == 0) {
+            expected_inits.push_back((*it)->stream_id);
+        }
+    }
+    const vector<int> actual_inits(inits.begin() + inits_before, inits.end());
+    if (actual_inits != expected_inits) {
+        return fail(seed, "streams were not initialized once, in queue order");
+    }
+    if (sys->scheduler_unit->running_streams[vnet] !=
+        static_cast<int>(running)) {
+        return fail(seed, "running stream count is off");
+    }
+    // the cursor of the queue must still agree with a walk from the front
+    if (queue.at(running) != next(queue.begin(), running)) {
+        return fail(seed, "queue cursor is off");
+    }
+    return true;
+}
+
+bool run_trial(const uint32_t seed, Sys* const sys) {
+    mt19937 rng(seed);
+    auto uniform = [&rng](const int low, const int high) {
+        return uniform_int_distribution<int>(low, high)(rng);
+    };
+
+    auto& queue = sys->active_Streams[vnet];
+    sys->scheduler_unit->queue_threshold = uniform(1, 4);
+    vector<int> inits;
+    int next_id = 0;
+
+    for (int step = 0; step < 200 || !queue.empty(); step++) {
+        set<int> initialized_before;
+        for (auto* const stream : queue) {
+            if (stream->initialized) {
+                initialized_before.insert(stream->stream_id);
+            }
+        }
+        const auto inits_before = inits.size();
+
+        if (step < 200 && (queue.empty() || uniform(0, 2) != 0)) {
+            auto* const stream = new TestStream(next_id++, sys, inits);
+            // queued behind the running streams, by priority
+            stream->priority = uniform(0, 3);
+            sys->insert_stream(&queue, stream);
+            sys->scheduler_unit->notify_stream_added(vnet);
+        } else {
+            const auto running = min(
+                static_cast<int>(queue.size()),
+                sys->scheduler_unit->queue_threshold);
+            auto it = next(queue.begin(), uniform(0, running - 1));
+            auto* const stream = *it;
+            queue.erase(it);
+            sys->scheduler_unit->notify_stream_removed(vnet, 0);
+            delete stream;
+        }
+
+        if (!check_queue(seed, sys, initialized_before, inits,
+                         inits_before)) {
+            return false;
+        }
+    }
+    if (inits.size() != static_cast<size_t>(next_id)) {
+        return fail(seed, "not every stream was initialized");
+    }
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        cerr << "usage: " << argv[0]
+             << " <workload> <system configuration> [trials]" << endl;
+        return 1;
+    }
+    const auto trials = argc > 3 ? atoi(argv[3]) : 2000;
+
+    StubNetworkApi network_api;
+    StubRemoteMemory memory_api;
+    auto* const sys = new Sys(0, argv[1], "empty", argv[2], &memory_api,
+                              &network_api, {8}, {1}, 1, 1, false);
+
+    // a freshly built queue must look up its own end
+    auto& queue = sys->active_Streams[vnet];
+    if (queue.at(0) != queue.end()) {
+        cerr << "[Error] (tests/rt_scheduler_unit) the cursor of a new queue "
+             << "does not point to its end" << endl;
+        return 1;
+    }
+
+    for (int trial = 0; trial < trials; trial++) {
+        if (!run_trial(static_cast<uint32_t>(trial), sys)) {
+            return 1;
+        }
+    }
+
+    cout << "scheduler unit: " << trials << " randomized schedules passed"
+         << endl;
+    return 0;
+}
@@ -0,0 +1,50 @@
+import os
+
+from chakra.src.third_party.utils.protolib import encodeMessage as encode_message
+from chakra.schema.protobuf.et_def_pb2 import (
+    Node as ChakraNode,
+    BoolList,
+    GlobalMetadata,
+    AttributeProto as ChakraAttr,
+    COMP_NODE,
+    COMM_COLL_NODE,
+    ALL_REDUCE,
+)
+
+def main() -> None:
+    # metadata
+    npus_count = 8  # 8 NPUs
+    layers_count = 64
+
+    for npu_id in range(npus_count):
+        output_filename = f"chakra_trace.{npu_id}.et"
+        with open(output_filename, "wb") as et:
+            # Chakra Metadata
+            encode_message(et, GlobalMetadata(version="0.0.4"))
+
+            # each layer computes after the previous one, and all-reduces its
+            # gradients while the next layers compute
+            for layer in range(layers_count):
+                comp_node = ChakraNode()
+                comp_node.id = 2 * layer
+                comp_node.name = f"Layer-{layer}"
+                comp_node.type = COMP_NODE
+                if layer > 0:
+                    comp_node.data_deps.append(2 * (layer - 1))
+                comp_node.attr.append(ChakraAttr(name="is_cpu_op", bool_val=False))
+                comp_node.attr.append(ChakraAttr(name="num_ops", int64_val=(layer % 4 + 1) * 50_000_000))
+                comp_node.attr.append(ChakraAttr(name="tensor_size", uint64_val=(layer % 3 + 1) * 1_048_576))
+                encode_message(et, comp_node)
+
+                coll_node = ChakraNode()
+                coll_node.id = 2 * layer + 1
+                coll_node.name = f"All-Reduce-{layer}"
+                coll_node.type = COMM_COLL_NODE
+                coll_node.data_deps.append(2 * layer)
+                coll_node.attr.append(ChakraAttr(name="is_cpu_op", bool_val=False))
+                coll_node.attr.append(ChakraAttr(name="comm_type", int64_val=ALL_REDUCE))
+                coll_node.attr.append(ChakraAttr(name="comm_size", int64_val=(layer % 2 + 1) * 262_144))
+                encode_message(et, coll_node)
+
+if __name__ == "__main__":
+    main()
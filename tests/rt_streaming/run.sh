@@ -0,0 +1,56 @@
+#!/bin/bash
+set -e
+
+# Path
+SCRIPT_DIR=$(dirname "$(realpath $0)")
+ASTRA_SIM_BIN=${SCRIPT_DIR}/../../build/astra_analytical/build/bin/AstraSim_Analytical_Congestion_Aware
+
+# Clear outputs
+(
+rm -rf ${SCRIPT_DIR}/outputs/*
+mkdir -p ${SCRIPT_DIR}/outputs/workload_cache
+)
+
+# Generate inputs
+(
+echo "[$0] Generating inputs..."
+${SCRIPT_DIR}/inputs/workload/gen.sh
+)
+
+# run_astra_sim <system configuration> <output name> [extra arguments]
+run_astra_sim() {
+    ${ASTRA_SIM_BIN} \
+        --workload-configuration=${SCRIPT_DIR}/inputs/workload/chakra_trace \
+        --system-configuration=${SCRIPT_DIR}/inputs/$1 \
+        --network-configuration=${SCRIPT_DIR}/inputs/network_cfg.yml \
+        --remote-memory-configuration=${SCRIPT_DIR}/inputs/remote_memory_cfg.json \
+        "${@:3}" \
+        > ${SCRIPT_DIR}/outputs/$2.txt
+}
+
+# Run ASTRA-sim with and without streaming execution
+(
+echo "[$0] Running ASTRA-sim..."
+run_astra_sim system_cfg.json stdout
+run_astra_sim system_streaming_cfg.json stdout_streaming
+run_astra_sim system_streaming_cfg.json stdout_streaming_cached \
+    --workload-cache=${SCRIPT_DIR}/outputs/workload_cache
+)
+
+# keeps the simulated times and utilizations of each sys
+statistics() {
+    sed -E 's/\[[^]]+\] //; s/\[[^]]+\] //; s/\[[^]]+\] //' \
+        | grep -E "finished, | time: |overlap: |percentage: |utilization: |intensity: "
+}
+
+# Compare outputs
+(
+echo "[$0] Comparing outputs..."
+statistics < ${SCRIPT_DIR}/outputs/stdout.txt > ${SCRIPT_DIR}/outputs/statistics.txt
+for OUTPUT in stdout_streaming stdout_streaming_cached; do
+    statistics < ${SCRIPT_DIR}/outputs/${OUTPUT}.txt > ${SCRIPT_DIR}/outputs/statistics_${OUTPUT}.txt
+    diff ${SCRIPT_DIR}/outputs/statistics.txt ${SCRIPT_DIR}/outputs/statistics_${OUTPUT}.txt || (echo "Failed." ; exit 1)
+done
+)
+
+echo "[$0] Ok."
@@ -27,8 +27,11 @@ ${ASTRA_SIM_BIN} \
 	| tee ${SCRIPT_DIR}/outputs/stdout.txt
 )
 
+# end-of-run allocator and cache counters depend on the implementation, not
+# on the simulated schedule, so they are not compared
 clean_log() {
-    sed -E 's/\[[^]]+\] //; s/\[[^]]+\] //; s/\[[^]]+\] //'
+    sed -E 's/\[[^]]+\] //; s/\[[^]]+\] //; s/\[[^]]+\] //' \
+        | grep -v -E '^(object pool|callback tracker:|chunk id generator:|chunk arrivals:|latency memo:|route cache:) '
 }
 
 # Compare outputs
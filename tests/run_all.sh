@@ -9,4 +9,19 @@ echo "[$0] Running all regression tests..."
 echo "[$0] Running rt_template..."
 ${SCRIPT_DIR}/rt_template/run.sh || (echo "Failed." ; exit 1)
 
+echo "[$0] Running rt_streaming..."
+${SCRIPT_DIR}/rt_streaming/run.sh || (echo "Failed." ; exit 1)
+
+echo "[$0] Running rt_num_threads..."
+${SCRIPT_DIR}/rt_num_threads/run.sh || (echo "Failed." ; exit 1)
+
+echo "[$0] Running rt_event_store..."
+${SCRIPT_DIR}/rt_event_store/run.sh || (echo "Failed." ; exit 1)
+
+echo "[$0] Running rt_message_matcher..."
+${SCRIPT_DIR}/rt_message_matcher/run.sh || (echo "Failed." ; exit 1)
+
+echo "[$0] Running rt_scheduler_unit..."
+${SCRIPT_DIR}/rt_scheduler_unit/run.sh || (echo "Failed." ; exit 1)
+
 echo "[$0] Finished all regression tests."
\ No newline at end of file